@@ -26,6 +26,7 @@
 #include "itensor/mps/dmrg.h"
 #include "itensor/mps/idmrg.h"
 #include "itensor/mps/tevol.h"
+#include "itensor/mps/correlations.h"
 #include "itensor/mps/hambuilder.h"
 #include "itensor/mps/autompo.h"
 
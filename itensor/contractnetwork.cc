@@ -0,0 +1,271 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <map>
+#include <functional>
+#include <limits>
+#include "itensor/contractnetwork.h"
+
+namespace itensor {
+
+namespace detail {
+
+//Number of tensors up to which every
+//pairwise order is searched; larger
+//networks are ordered greedily
+const size_t ExhaustiveMax = 8;
+
+//Cache size above which old plans are discarded
+const size_t CacheMax = 1024;
+
+using QNDist = std::map<QN,Real>;
+
+//Adds the sectors of I to the distribution
+//of total flux vs. number of elements
+void
+convolve(QNDist & D, NetIndex const& I)
+    {
+    auto res = QNDist();
+    for(auto& d : D)
+    for(auto& s : I.sectors)
+        {
+        res[d.first+s.qn*I.dir] += d.second*s.m;
+        }
+    D.swap(res);
+    }
+
+Real
+distVal(QNDist const& D, QN const& q)
+    {
+    auto it = D.find(q);
+    return (it == D.end()) ? 0. : it->second;
+    }
+
+//Multiply-adds needed to contract A and B:
+//for each flux q carried by the contracted
+//indices, the free blocks of A must carry
+//divA-q and the free blocks of B divB+q
+Real
+pairCost(NetTensor const& A,
+         NetTensor const& B)
+    {
+    auto DC = QNDist{{QN(),1.}},
+         DA = QNDist{{QN(),1.}},
+         DB = QNDist{{QN(),1.}};
+    auto hasLabel = [](NetTensor const& T, long l)
+        {
+        for(auto& I : T.inds) if(I.label == l) return true;
+        return false;
+        };
+    for(auto& I : A.inds)
+        {
+        if(hasLabel(B,I.label)) convolve(DC,I);
+        else                    convolve(DA,I);
+        }
+    for(auto& I : B.inds)
+        {
+        if(!hasLabel(A,I.label)) convolve(DB,I);
+        }
+    Real cost = 0;
+    for(auto& c : DC)
+        {
+        cost += c.second*distVal(DA,A.div-c.first)*distVal(DB,B.div+c.first);
+        }
+    return cost;
+    }
+
+//Shape of the tensor obtained by contracting A and B
+NetTensor
+contractShape(NetTensor const& A,
+              NetTensor const& B)
+    {
+    auto C = NetTensor();
+    C.div = A.div+B.div;
+    auto count = std::map<long,int>();
+    for(auto& I : A.inds) count[I.label] += 1;
+    for(auto& I : B.inds) count[I.label] += 1;
+    for(auto& I : A.inds) if(count[I.label] == 1) C.inds.push_back(I);
+    for(auto& I : B.inds) if(count[I.label] == 1) C.inds.push_back(I);
+    return C;
+    }
+
+ContractionPlan
+exhaustivePlan(std::vector<NetTensor> const& net)
+    {
+    auto N = net.size();
+    auto nsub = size_t(1) << N;
+    auto inf = std::numeric_limits<Real>::max();
+
+    auto shape = std::vector<NetTensor>(nsub);
+    auto best = std::vector<Real>(nsub,inf);
+    auto split = std::vector<size_t>(nsub,0);
+
+    for(auto n : range(N))
+        {
+        shape[size_t(1) << n] = net[n];
+        best[size_t(1) << n] = 0;
+        }
+
+    for(size_t S = 1; S < nsub; ++S)
+        {
+        if((S & (S-1)) == 0) continue;
+        auto low = S & (~S+1);
+        //Enumerate splits S = S1 | S2 with S1 holding
+        //the lowest member, so each split is seen once
+        for(auto S1 = (S-1) & S; S1 > 0; S1 = (S1-1) & S)
+            {
+            if(!(S1 & low)) continue;
+            auto S2 = S ^ S1;
+            if(best[S1] == inf || best[S2] == inf) continue;
+            auto c = best[S1] + best[S2] + pairCost(shape[S1],shape[S2]);
+            if(c < best[S])
+                {
+                best[S] = c;
+                split[S] = S1;
+                }
+            }
+        auto S1 = split[S];
+        shape[S] = contractShape(shape[S1],shape[S^S1]);
+        }
+
+    auto plan = ContractionPlan();
+    plan.cost = best[nsub-1];
+    //Emit the steps depth first, returning the slot
+    //holding the contracted tensor of each subset
+    std::function<int(size_t)> emit = [&](size_t S) -> int
+        {
+        if((S & (S-1)) == 0)
+            {
+            int n = 0;
+            while(!(S & (size_t(1) << n))) ++n;
+            return n;
+            }
+        auto a = emit(split[S]);
+        auto b = emit(S ^ split[S]);
+        plan.steps.emplace_back(a,b);
+        return int(N + plan.steps.size() - 1);
+        };
+    emit(nsub-1);
+    return plan;
+    }
+
+ContractionPlan
+greedyPlan(std::vector<NetTensor> const& net)
+    {
+    auto N = net.size();
+    auto plan = ContractionPlan();
+    auto live = std::vector<std::pair<int,NetTensor>>();
+    for(auto n : range(N)) live.emplace_back(int(n),net[n]);
+
+    auto shares = [](NetTensor const& A, NetTensor const& B)
+        {
+        for(auto& I : A.inds)
+        for(auto& J : B.inds)
+            {
+            if(I.label == J.label) return true;
+            }
+        return false;
+        };
+
+    while(live.size() > 1)
+        {
+        //Prefer the cheapest pair with a common index,
+        //resorting to outer products only if none exist
+        size_t bi = 0, bj = 1;
+        auto bcost = std::numeric_limits<Real>::max();
+        auto bshared = false;
+        for(auto i : range(live.size()))
+        for(auto j : range(i+1,live.size()))
+            {
+            auto sh = shares(live[i].second,live[j].second);
+            if(bshared && !sh) continue;
+            auto c = pairCost(live[i].second,live[j].second);
+            if((sh && !bshared) || c < bcost)
+                {
+                bi = i;
+                bj = j;
+                bcost = c;
+                bshared = sh;
+                }
+            }
+        plan.cost += bcost;
+        plan.steps.emplace_back(live[bi].first,live[bj].first);
+        auto C = contractShape(live[bi].second,live[bj].second);
+        live.erase(live.begin()+bj);
+        live[bi] = std::make_pair(int(N+plan.steps.size()-1),std::move(C));
+        }
+    return plan;
+    }
+
+ContractionPlan
+optimalContractionPlan(std::vector<NetTensor> const& net)
+    {
+    if(net.size() < 2) return ContractionPlan();
+    if(net.size() <= ExhaustiveMax) return exhaustivePlan(net);
+    return greedyPlan(net);
+    }
+
+ContractionPlan
+sequentialPlan(size_t N)
+    {
+    auto plan = ContractionPlan();
+    if(N < 2) return plan;
+    plan.steps.emplace_back(0,1);
+    for(auto n : range(2ul,N)) plan.steps.emplace_back(N+n-2,n);
+    return plan;
+    }
+
+bool
+hasHyperIndex(std::vector<NetTensor> const& net)
+    {
+    auto count = std::map<long,int>();
+    for(auto& T : net)
+    for(auto& I : T.inds)
+        {
+        if(++count[I.label] > 2) return true;
+        }
+    return false;
+    }
+
+void
+appendKey(std::vector<long> & key, QN const& q)
+    {
+    for(auto n : range(QNSize())) key.push_back(q.val0(n).val());
+    }
+
+ContractionPlan
+cachedContractionPlan(std::vector<NetTensor> const& net)
+    {
+    if(hasHyperIndex(net)) return sequentialPlan(net.size());
+
+    auto key = std::vector<long>();
+    key.push_back(net.size());
+    for(auto& T : net)
+        {
+        key.push_back(T.inds.size());
+        appendKey(key,T.div);
+        for(auto& I : T.inds)
+            {
+            key.push_back(I.label);
+            key.push_back(static_cast<long>(I.dir));
+            key.push_back(I.sectors.size());
+            for(auto& s : I.sectors)
+                {
+                key.push_back(s.m);
+                appendKey(key,s.qn);
+                }
+            }
+        }
+
+    thread_local std::map<std::vector<long>,ContractionPlan> cache;
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+
+    if(cache.size() >= CacheMax) cache.clear();
+    return cache.emplace(std::move(key),optimalContractionPlan(net)).first->second;
+    }
+
+} //namespace detail
+
+} //namespace itensor
@@ -0,0 +1,217 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_CONTRACTNETWORK_H
+#define __ITENSOR_CONTRACTNETWORK_H
+
+#include "itensor/iqtensor.h"
+
+namespace itensor {
+
+//
+// Contracting a network of several tensors
+// pairwise can be done in many orders whose
+// costs differ by powers of the bond dimensions.
+// contractNetwork estimates the cost of every
+// pairwise order from the index dimensions
+// (using the quantum number block structure
+// for IQTensors) and contracts in the cheapest one.
+// The chosen order is cached per network shape,
+// so repeated calls with tensors of the same
+// dimensions only pay for the contractions.
+//
+// Usage:
+//
+//   auto R = contractNetwork(phi,L,Op1,Op2,Rt);
+//
+//   //or
+//   auto tensors = std::vector<ITensor const*>{&A,&B,&C};
+//   auto R = contractNetwork(tensors);
+//
+// Default-constructed (null) tensors are skipped.
+//
+// An index shared by three or more tensors is
+// summed over by the first pairwise contraction
+// containing two of them, so the result depends
+// on the order. Such networks are contracted in
+// the order written, ((T1*T2)*T3)*..., without
+// reordering.
+//
+
+//
+// A ContractionPlan lists pairwise contractions.
+// Slots 0,1,...,n-1 hold the n input tensors;
+// step k contracts the tensors in slots
+// steps[k].first and steps[k].second and puts
+// the result in slot n+k. The final step
+// produces the result.
+//
+struct ContractionPlan
+    {
+    std::vector<std::pair<int,int>> steps;
+    Real cost = 0; //estimated number of multiply-adds
+    };
+
+template<typename Tensor>
+ContractionPlan
+contractionPlan(std::vector<Tensor const*> const& tensors);
+
+template<typename Tensor>
+Tensor
+contractNetwork(std::vector<Tensor const*> const& tensors);
+
+template<typename Tensor, typename... Rest>
+Tensor
+contractNetwork(Tensor const& T1,
+                Tensor const& T2,
+                Rest const&... rest);
+
+
+namespace detail {
+
+struct NetSector
+    {
+    QN qn;
+    long m = 0;
+
+    NetSector() { }
+
+    NetSector(QN q, long m_) : qn(q), m(m_) { }
+    };
+
+struct NetIndex
+    {
+    long label = 0; //indices with same label are contracted
+    Arrow dir = Out;
+    std::vector<NetSector> sectors;
+    };
+
+struct NetTensor
+    {
+    std::vector<NetIndex> inds;
+    QN div;
+    };
+
+//Returns the cheapest pairwise plan for
+//contracting the network, computing it
+//only if the shape was not seen before
+ContractionPlan
+cachedContractionPlan(std::vector<NetTensor> const& net);
+
+//Finds the cheapest plan without caching
+ContractionPlan
+optimalContractionPlan(std::vector<NetTensor> const& net);
+
+//Plan multiplying the N tensors
+//in the order written
+ContractionPlan
+sequentialPlan(size_t N);
+
+//True if some index is shared
+//by more than two tensors
+bool
+hasHyperIndex(std::vector<NetTensor> const& net);
+
+void inline
+addSectors(NetIndex & NI, Index const& I)
+    {
+    NI.dir = Out;
+    NI.sectors.assign(1,NetSector{QN(),I.m()});
+    }
+
+void inline
+addSectors(NetIndex & NI, IQIndex const& I)
+    {
+    NI.dir = I.dir();
+    NI.sectors.resize(I.nblock());
+    for(auto n : range(I.nblock()))
+        {
+        NI.sectors[n] = NetSector{I.qn(1+n),I.index(1+n).m()};
+        }
+    }
+
+QN inline
+netDiv(ITensor const& T) { return QN(); }
+
+QN inline
+netDiv(IQTensor const& T) { return div(T); }
+
+template<typename Tensor>
+std::vector<NetTensor>
+makeNet(std::vector<Tensor const*> const& tensors)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto seen = std::vector<IndexT>();
+    auto net = std::vector<NetTensor>(tensors.size());
+    for(auto n : range(tensors))
+        {
+        auto& T = *tensors[n];
+        auto& NT = net[n];
+        NT.div = netDiv(T);
+        NT.inds.resize(T.r());
+        for(auto j : range(T.r()))
+            {
+            auto& I = T.inds()[j];
+            auto& NI = NT.inds[j];
+            auto it = std::find(seen.begin(),seen.end(),I);
+            NI.label = it - seen.begin();
+            if(it == seen.end()) seen.push_back(I);
+            addSectors(NI,I);
+            }
+        }
+    return net;
+    }
+
+} //namespace detail
+
+template<typename Tensor>
+ContractionPlan
+contractionPlan(std::vector<Tensor const*> const& tensors)
+    {
+    return detail::cachedContractionPlan(detail::makeNet(tensors));
+    }
+
+template<typename Tensor>
+Tensor
+contractNetwork(std::vector<Tensor const*> const& tensors)
+    {
+    auto nonnull = std::vector<Tensor const*>();
+    nonnull.reserve(tensors.size());
+    for(auto* pT : tensors) if(pT && *pT) nonnull.push_back(pT);
+    if(nonnull.empty()) Error("contractNetwork: no tensors to contract");
+    if(nonnull.size() == 1) return *nonnull.front();
+    if(nonnull.size() == 2) return (*nonnull[0]) * (*nonnull[1]);
+
+    auto plan = contractionPlan(nonnull);
+
+    auto N = nonnull.size();
+    auto res = std::vector<Tensor>(plan.steps.size());
+    auto slot = [&](int s) -> Tensor const&
+        {
+        return (size_t(s) < N) ? *nonnull[s] : res[s-N];
+        };
+    for(auto k : range(plan.steps))
+        {
+        auto& st = plan.steps[k];
+        res[k] = slot(st.first) * slot(st.second);
+        //Free intermediates as soon as they are used
+        if(size_t(st.first) >= N) res[st.first-N] = Tensor();
+        if(size_t(st.second) >= N) res[st.second-N] = Tensor();
+        }
+    return std::move(res.back());
+    }
+
+template<typename Tensor, typename... Rest>
+Tensor
+contractNetwork(Tensor const& T1,
+                Tensor const& T2,
+                Rest const&... rest)
+    {
+    auto tensors = std::vector<Tensor const*>{&T1,&T2,&rest...};
+    return contractNetwork(tensors);
+    }
+
+} //namespace itensor
+
+#endif
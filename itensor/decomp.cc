@@ -345,7 +345,7 @@ eigDecompImpl(ITensor T,
     else
         {
         //real eigenvectors
-        D = ITensor({prime(newmid),newmid},DiagReal{move(Dr.storage())},T.scale());
+        D = ITensor({prime(newmid),newmid},DiagReal(Dr.begin(),Dr.end()),T.scale());
         }
 
     if(full)
@@ -46,6 +46,30 @@ factor(Tensor const& T,
        Tensor      & B,
        Args const& args = Args::global());
 
+//
+// QR decomposition
+//
+// Factors a tensor T such that T=Q*R where Q and R
+// share a single new index q. The indices of T which
+// are present on Q on input go on Q; the rest go on R.
+// Q is an isometry: contracting Q with dag(prime(Q,q))
+// gives delta(q,prime(q)).
+//
+// No truncation is done, so qr is a cheaper
+// alternative to svd when only a change of gauge
+// (orthogonalization) is needed.
+//
+// Arguments recognized:
+//    "IndexName": name of the new index (default "qr")
+//    "IndexType": type of the new index (default Link)
+//
+template<typename Tensor>
+void
+qr(Tensor const& T,
+   Tensor      & Q,
+   Tensor      & R,
+   Args const& args = Args::global());
+
 //
 // Density Matrix Decomposition
 // 
@@ -249,6 +273,44 @@ svd(Tensor AA,
     return spec;
     } //svd
 
+template<typename IndexT>
+void
+qrRank2(ITensorT<IndexT> const& A, 
+        IndexT const& qi, 
+        IndexT const& ri,
+        ITensorT<IndexT> & Q, 
+        ITensorT<IndexT> & R,
+        Args const& args = Args::global());
+
+template<typename Tensor>
+void
+qr(Tensor const& T,
+   Tensor      & Q,
+   Tensor      & R,
+   Args const& args)
+    {
+    using IndexT = typename Tensor::index_type;
+    if(!Q) Error("qr: Q must have at least one index of T, to indicate which indices go on Q");
+
+    auto Qinds = std::vector<IndexT>(),
+         Rinds = std::vector<IndexT>();
+    for(auto& I : T.inds())
+        {
+        if(hasindex(Q,I)) Qinds.push_back(I);
+        else              Rinds.push_back(I);
+        }
+    if(Qinds.empty() || Rinds.empty()) Error("qr: Q and R must each get at least one index of T");
+
+    auto Qcomb = combiner(std::move(Qinds),{"IndexName","qc"});
+    auto Rcomb = combiner(std::move(Rinds),{"IndexName","rc"});
+    auto AA = T*Qcomb*Rcomb;
+
+    qrRank2(AA,commonIndex(AA,Qcomb),commonIndex(AA,Rcomb),Q,R,args);
+
+    Q = dag(Qcomb) * Q;
+    R = R * dag(Rcomb);
+    }
+
 template<class Tensor, class BigMatrixT>
 Spectrum 
 denmatDecomp(Tensor const& AA, 
@@ -283,7 +345,7 @@ denmatDecomp(Tensor const& AA,
         }
 
     //Apply combiner
-    START_TIMER(8)
+    PROFILE_START(denmat_rho)
     auto iname = args.getString("IndexName",mid ? mid.rawname() : "mid");
     auto cmb = combiner(std::move(cinds),iname);
     auto ci = cmb.inds().front();
@@ -302,7 +364,7 @@ denmatDecomp(Tensor const& AA,
         if(tr > 1E-16) rho *= 1./tr;
         }
 
-    STOP_TIMER(8)
+    PROFILE_STOP(denmat_rho)
 
     if(args.getBool("UseOrigM",false))
         {
@@ -148,7 +148,7 @@ diagHImpl(IQTensor    H,
           IQTensor  & D,
           Args        args)
     {
-    SCOPED_TIMER(7)
+    PROFILE_SCOPE(diag_hermitian)
     auto cutoff = args.getReal("Cutoff",0.);
     auto maxm = args.getInt("Maxm",MAX_INT);
     auto minm = args.getInt("Minm",1);
@@ -201,7 +201,8 @@ diagHImpl(IQTensor    H,
     auto ddata = vector<Real>(totaldsize);
     auto dvecs = vector<VectorRef>(Nblock);
 
-    auto alleig = stdx::reserve_vector<Real>(ai.m());
+    auto alleig = Vector::storage_type{};
+    alleig.reserve(ai.m());
     auto alleigqn = vector<EigQN>{};
     if(compute_qns) alleigqn = stdx::reserve_vector<EigQN>(ai.m());
 
@@ -301,7 +302,11 @@ diagHImpl(IQTensor    H,
         //We need to check that the number of states doesn't
         //go above m, which can happen if there are degeneracies
         total_m += this_m;
-        if(total_m > m) this_m -= (total_m-m);
+        if(total_m > m) 
+            {
+            this_m -= (total_m-m);
+            total_m = m;
+            }
 
         if(this_m == 0) 
             { 
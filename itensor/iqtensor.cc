@@ -350,6 +350,25 @@ div(IQTensor const& T)
     return doTask(CalcDiv{T.inds()},T.store());
     }
 
+IQTensor
+sparseLinks(IQTensor T, IQIndex const& l1, IQIndex const& l2)
+    {
+    int p1 = -1,
+        p2 = -1;
+    if(l1)
+        {
+        p1 = findindex(T.inds(),l1);
+        if(p1 < 0) Error("sparseLinks: l1 not an index of T");
+        }
+    if(l2)
+        {
+        p2 = findindex(T.inds(),l2);
+        if(p2 < 0) Error("sparseLinks: l2 not an index of T");
+        }
+    if(T.store()) doTask(ToMPOSparse<IQIndex>{T.inds(),p1,p2},T.store());
+    return T;
+    }
+
 IQTensor
 combiner(IQIndexSet const& inds,
          Args const& args)
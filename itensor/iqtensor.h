@@ -74,6 +74,16 @@ operator*(IndexVal const& iv, IQTensor const& T);
 QN
 div(IQTensor const& T);
 
+//
+// Store each block of T as a matrix over the
+// values of the link indices l1 and l2 (l2 may be
+// omitted) keeping only its non-zero entries, as
+// sparseLinks does for an ITensor (see itensor.h).
+// Has no effect unless T has QDense storage.
+//
+IQTensor
+sparseLinks(IQTensor T, IQIndex const& l1, IQIndex const& l2 = IQIndex());
+
 IQTensor
 combiner(IQIndexSet const& inds, Args const& args = Global::args());
 
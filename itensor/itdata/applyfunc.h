@@ -58,7 +58,10 @@ applyFunc_impl(stdx::choice<1>, FuncHolder<F>& H, Storage const& s, ManageStore&
 } //namespace detail
 
 
-template<typename FuncObj, typename Storage>
+//Lazy storage is evaluated before
+//the function object is applied
+template<typename FuncObj, typename Storage,
+         class = stdx::enable_if_t<not detail::HasEvaluate<Storage>::result()>>
 auto
 doTask(detail::FuncHolder<FuncObj> & H, Storage const& s, ManageStore & m) 
     -> decltype(detail::applyFunc_impl(stdx::select_overload{},H,s,m))
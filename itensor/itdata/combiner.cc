@@ -37,9 +37,10 @@ permuteStore(Dense<T>   const& d,
              Permutation const& P,
              ManageStore      & m)
     {
-    auto tfrom = makeTenRef(d.data(),d.size(),&dis);
-    auto to = Ten<Range,T>(permute(tfrom,P));
-    m.makeNewData<Dense<T>>(move(to.storage()));
+    auto tfrom = permute(makeTenRef(d.data(),d.size(),&dis),P);
+    //Permute directly into the new storage
+    auto nd = m.makeNewData<Dense<T>>(d.size());
+    makeTenRef(nd->data(),nd->size(),normalRange(tfrom.range())) &= tfrom;
     }
 
 template<typename Storage>
@@ -283,23 +283,23 @@ doTask(Contract<Index> & C,
     auto tL = makeTenRef(L.data(),L.size(),&C.Lis);
     auto tR = makeTenRef(R.data(),R.size(),&C.Ris);
     auto rsize = area(C.Nis);
-    START_TIMER(4)
+    PROFILE_START(dense_alloc)
     auto nd = m.makeNewData<Dense<common_type<T1,T2>>>(rsize);
-    STOP_TIMER(4)
+    PROFILE_STOP(dense_alloc)
     auto tN = makeTenRef(nd->data(),nd->size(),&(C.Nis));
 
 #ifdef COLLECT_TSTATS
     tstats(tL,Lind,tR,Rind,tN,Nind);
 #endif
 
-    START_TIMER(2)
+    PROFILE_START(dense_contract)
     contract(tL,Lind,tR,Rind,tN,Nind);
-    STOP_TIMER(2)
+    PROFILE_STOP(dense_contract)
 
 #ifdef USESCALE
-    START_TIMER(3)
+    PROFILE_START(scalefac)
     if(rsize > 1) C.scalefac = computeScalefac(*nd);
-    STOP_TIMER(3)
+    PROFILE_STOP(scalefac)
 #endif
     }
 template void doTask(Contract<Index>&,DenseReal const&,DenseReal const&,ManageStore&);
@@ -7,6 +7,7 @@
 
 #include "itensor/itdata/task_types.h"
 #include "itensor/util/readwrite.h"
+#include "itensor/util/mapalloc.h"
 #include "itensor/detail/call_rewrite.h"
 #include "itensor/itdata/itdata.h"
 
@@ -25,7 +26,7 @@ class Dense
                   "Template argument to Dense storage should not be const");
     public:
     using value_type = T;
-    using storage_type = std::vector<value_type>;
+    using storage_type = std::vector<value_type,MapAllocator<value_type>>;
     using size_type = typename storage_type::size_type;
     using iterator = typename storage_type::iterator;
     using const_iterator = typename storage_type::const_iterator;
@@ -269,6 +270,14 @@ template<typename T>
 Cplx
 doTask(SumEls<Index>, Dense<T> const& d);
 
+template<typename T>
+void
+doTask(GetData<T> & G, Dense<T> const& d)
+    {
+    G.data = d.data();
+    G.size = d.size();
+    }
+
 auto constexpr inline
 doTask(StorageType const& S, DenseReal const& d) ->StorageType::Type { return StorageType::DenseReal; }
 
@@ -113,7 +113,7 @@ contractDiagDense(Diag<T1>  const& d,
             }
         if(rank(Nis)==1)
             {
-            m.makeNewData<Dense<T3>>(std::move(nstore));
+            m.makeNewData<Dense<T3>>(nstore.begin(),nstore.end());
             }
         else
             {
@@ -485,7 +485,6 @@ applyToImpl(D& d)
         {
         if(checkHasResult(d))
             {
-            println("Lazy storage has result, swapping");
             m_.parg1() = callEvaluate(d);
             m_.parg1()->plugInto(*this);
             return;
@@ -545,7 +544,6 @@ applyToImpl(D2& d2)
         {
         if(checkHasResult(d2))
             {
-            println("Lazy storage has result, swapping");
             m_.parg2() = callEvaluate(d2);
             m_.parg2()->plugInto(*this);
             return;
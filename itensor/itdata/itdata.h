@@ -9,6 +9,7 @@
 #include "itensor/types.h"
 #include "itensor/util/error.h"
 #include "itensor/util/timers.h"
+#include "itensor/util/memstats.h"
 #include "itensor/itdata/storage_types.h"
 
 namespace itensor {
@@ -75,6 +76,24 @@ struct ITData
     plugInto(FuncBase& f) = 0;
     };
 
+namespace detail {
+
+//Bytes used by storage d, counting the
+//elements of its "store" member if any
+template<typename T>
+auto
+storeBytes(T const& d, int)
+    -> decltype(d.store.size()*sizeof(d.store[0]))
+    {
+    return sizeof(T)+d.store.size()*sizeof(d.store[0]);
+    }
+
+template<typename T>
+size_t
+storeBytes(T const& d, long) { return sizeof(T); }
+
+} //namespace detail
+
 template<typename T>
 class ITWrap : public ITData
     {
@@ -86,11 +105,29 @@ class ITWrap : public ITData
     template<typename... VArgs>
     ITWrap(VArgs&&... vargs) : d(std::forward<VArgs>(vargs)...) 
         { 
+        if(memTracking()) trackMem();
         }
 
-    virtual ~ITWrap() { }
+    virtual ~ITWrap() 
+        { 
+        if(mem_bytes_ > 0) detail::memAdd(mem_type_,mem_category_,-mem_bytes_);
+        }
 
     private:
+
+    long long mem_bytes_ = 0;
+    int mem_type_ = 0;
+    MemCategory mem_category_ = MemCategory::Other;
+
+    void
+    trackMem()
+        {
+        static const int type_id = detail::memTypeId(typeNameOf(d));
+        mem_bytes_ = detail::storeBytes(d,0);
+        mem_type_ = type_id;
+        mem_category_ = memCategory();
+        detail::memAdd(mem_type_,mem_category_,mem_bytes_);
+        }
     
     PData
     clone() const final 
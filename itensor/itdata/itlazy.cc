@@ -1,182 +1,204 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
 #include "itensor/itdata/itlazy.h"
 #include "itensor/itdata/dotask.h"
-#define REGISTER_ITDATA_HEADER_FILES
-#include "itensor/itdata/storage_types.h"
-#include "itensor/tensor/contract.h"
+#include "itensor/contractnetwork.h"
 
 namespace itensor {
 
-struct PrintStore { };
+ITLazy::
+ITLazy(const ITLazy& other)
+    {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    todo_ = other.todo_;
+    is_ = other.is_;
+    result_ = other.result_;
+    }
 
-void
-doTask(PrintStore,const ITLazy& L) { println("Storage type of P is ITLazy"); }
-void
-doTask(PrintStore,const ITReal& R) { println("Storage type of P is ITReal"); }
+ITLazy& ITLazy::
+operator=(const ITLazy& other)
+    {
+    if(this == &other) return *this;
+    auto res = PData();
+        {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        todo_ = other.todo_;
+        is_ = other.is_;
+        res = other.result_;
+        }
+    std::lock_guard<std::mutex> lock(mutex_);
+    result_ = std::move(res);
+    return *this;
+    }
 
-bool
-hasResult(const ITLazy& Z) { return Z.hasResult(); }
+bool ITLazy::
+hasResult() const
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<bool>(result_);
+    }
 
-PData
-evaluate(ITLazy& Z)
+PData ITLazy::
+evaluate() const
     {
-    if(Z.hasResult()) return Z.result();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(result_) return result_;
 
-    long maxr = 0;
-    for(auto& t : Z.todo())
+    auto N = todo_.size();
+    if(N == 0) Error("ITLazy: no factors to evaluate");
+    if(N == 1)
         {
-        maxr = std::max(maxr,t.i.r());
+        result_ = todo_.front().s;
+        return result_;
         }
 
-    //Convention for contA, contB
-    //- negative means contracted
-    //0 zero means uncontracted, not on C
-    //+ positive means uncontracted, on C
-    InfArray<int,12ul> contA(maxr,0),
-                       contB(maxr,0);
+    auto factors = std::vector<ITensor>(N);
+    auto pfactors = std::vector<ITensor const*>(N);
+    for(auto n : range(N))
+        {
+        auto s = todo_[n].s;
+        factors[n] = ITensor(todo_[n].i,std::move(s));
+        pfactors[n] = &factors[n];
+        }
 
-    auto P = Z.store(0);
-    IndexSet Ais = Z.iset(0);
-    IndexSet Cis;
-    IndexSetBuilder cis;
+    //(Factors sharing an index with more than one other
+    //factor are multiplied in the order written)
+    auto plan = contractionPlan(pfactors);
 
-    auto N = long(Z.todo().size());
-    for(decltype(N) n = 0; n < N-2; ++n)
+    auto res = std::vector<ITensor>(plan.steps.size());
+    auto slot = [&](int s) -> ITensor&
         {
-        contA.fill(0);
-        contB.fill(0);
-
-        auto& Bis = Z.iset(n+1);
-        auto& Nis = Z.iset(n+2);
-
-        long ncont = 0;
-        for(decltype(Ais.size()) na = 0; na < Ais.size(); ++na)
-        for(decltype(Bis.size()) nb = 0; nb < Bis.size(); ++nb)
-            if(Ais[na] == Bis[nb])
-                {
-                ++ncont;
-                contA[na] = -(nb+1);
-                contB[nb] = -(na+1);
-                }
-
-        auto nuncont = Ais.r() + Bis.r() - 2*ncont;
-        cis.resize(nuncont);
-
-        //Indices we want in Cis:
-        //o Uncontracted inds of A & B
-        //o *If* in Nis, in same order
-        //Possible algorithm:
-        //1. Loop over inds of Nis in order,
-        //   putting any inds shared with A
-        //   or B into Cis
-        //2. Put rest of uncontracted inds of 
-        //   A & B into Cis (loop over Cis to
-        //   see if already put in?)
-
-        size_t cn = 0;
-        for(const auto& In : Nis)
-            {
-            for(size_t na = 0; na < Ais.size(); ++na)
-                if(In == Ais[na])
-                    {
-                    cis.setExtent(cn++,In);
-                    contA[na] = cn;
-                    break;
-                    }
-            for(decltype(Bis.size()) nb = 0; nb < Bis.size(); ++nb)
-                if(In == Bis[nb])
-                    {
-                    cis.setExtent(cn++,In);
-                    contB[nb] = cn;
-                    break;
-                    }
-            }
-
-        for(decltype(Ais.size()) na = 0; na < Ais.size(); ++na)
-            if(contA[na] == 0)
-                {
-                cis.setExtent(cn++,Ais[na]);
-                }
-
-        for(decltype(Bis.size()) nb = 0; nb < Bis.size(); ++nb)
-            if(contB[nb] == 0)
-                {
-                cis.setExtent(cn++,Bis[nb]);
-                }
-
-        Cis = cis.build();
-
-        println("Ais = ",Ais);
-        println("Bis = ",Bis);
-        println("-> Cis = ",Cis);
-        println("----------------");
-        println("Nis = ",Nis);
-
-        //Global::debug3() = true;
-        doTask(Contract<Index>{Ais,Bis,Cis,true},P,Z.store(n+1));
-
-        Ais = Cis;
+        return (size_t(s) < N) ? factors[s] : res[s-N];
+        };
+    auto nstep = plan.steps.size();
+    for(auto k : range(nstep-1))
+        {
+        auto& st = plan.steps[k];
+        res[k] = slot(st.first) * slot(st.second);
+        slot(st.first) = ITensor();
+        slot(st.second) = ITensor();
         }
 
-    //println("Setting Z result");
-    //doTask(PrintStore{},P);
+    //Last contraction writes the result
+    //in the index order of the product
+    auto& A = slot(plan.steps.back().first);
+    auto& B = slot(plan.steps.back().second);
+    auto P = A.store();
+    auto C = doTask(Contract<Index>{A.inds(),B.inds(),is_},P,B.store());
+#ifdef USESCALE
+    //The result storage stands for the whole product, so
+    //it must include the scales of A and B (intermediate
+    //products carry one) and the scale factor of C
+    auto scale = A.scale()*B.scale();
+    if(!std::isnan(C.scalefac)) scale *= C.scalefac;
+    if(scale != LogNum(1.)) doTask(Mult<Real>{scale.real0()},P);
+#endif
+    result_ = std::move(P);
+    return result_;
+    }
+
+const char*
+typeNameOf(ITLazy const& d) { return "ITLazy"; }
 
-    Z.setResult(std::move(P));
-    return Z.result();
+bool
+hasResult(ITLazy const& Z) { return Z.hasResult(); }
+
+PData
+evaluate(ITLazy const& Z) { return Z.evaluate(); }
+
+bool
+isDenseStorage(PData const& p)
+    {
+    return dynamic_cast<ITWrap<DenseReal>*>(p.get())
+        || dynamic_cast<ITWrap<DenseCplx>*>(p.get());
+    }
+
+namespace detail {
+
+bool
+sameInds(IndexSet const& is1, IndexSet const& is2)
+    {
+    if(is1.r() != is2.r()) return false;
+    for(auto n : range(is1.r())) if(is1[n] != is2[n]) return false;
+    return true;
     }
 
+//Used when the index set of an ITensor no longer
+//matches its lazy storage (such as after priming it)
+template<typename IndexT>
+void
+contractNow(Contract<IndexT>& C,
+            PData L,
+            PData R,
+            ManageStore& m)
+    {
+    auto res = doTask(Contract<IndexT>{C.Lis,C.Ris},L,R);
+    C.Nis = std::move(res.Nis);
+    C.scalefac = res.scalefac;
+    m.pointTo(L);
+    }
+template void contractNow(Contract<Index>&,PData,PData,ManageStore&);
+template void contractNow(Contract<IQIndex>&,PData,PData,ManageStore&);
+
+} //namespace detail
+
+template<typename T>
 void
 doTask(Contract<Index>& C,
-       ITLazy& L,
-       const ITLazy& R)
+       ITLazy const& L,
+       Dense<T> const& R,
+       ManageStore& m)
     {
-    //Eventually handle these cases into dotask.h?
-    if(L.hasResult() && R.hasResult())
-        {
-        throw ITError("Not yet implemented 1");
-        }
-    else if(L.hasResult())
-        {
-        throw ITError("Not yet implemented 2");
-        }
-    else if(R.hasResult())
+    if(!detail::sameInds(L.inds(),C.Lis))
         {
-        throw ITError("Not yet implemented 3");
-        }
-    else
-        {
-        L.addStore(R);
+        detail::contractNow(C,L.evaluate(),m.parg2(),m);
+        return;
         }
+    contractIS(C.Lis,C.Ris,C.Nis);
+    auto* nL = m.makeNewData<ITLazy>(L);
+    nL->addStore(C.Ris,m.parg2());
+    nL->setInds(C.Nis);
     }
+template void doTask(Contract<Index>&,ITLazy const&,DenseReal const&,ManageStore&);
+template void doTask(Contract<Index>&,ITLazy const&,DenseCplx const&,ManageStore&);
 
+template<typename T>
 void
 doTask(Contract<Index>& C,
-       ITLazy& L,
-       const PData& R)
+       Dense<T> const& L,
+       ITLazy const& R,
+       ManageStore& m)
     {
-    println("In doTask(Contract,ITLazy, const CPData)");
-    if(L.hasResult())
+    if(!detail::sameInds(R.inds(),C.Ris))
         {
-        //Eventually handle this in dotask.h?
-        //--> call doTask(Contract,L.result(),R);
+        detail::contractNow(C,m.parg1(),R.evaluate(),m);
+        return;
         }
     contractIS(C.Lis,C.Ris,C.Nis);
-    L.addStore(C.Nis,R);
+    auto* nL = m.makeNewData<ITLazy>(C.Lis,m.parg1());
+    nL->addStore(R);
+    nL->setInds(C.Nis);
     }
+template void doTask(Contract<Index>&,DenseReal const&,ITLazy const&,ManageStore&);
+template void doTask(Contract<Index>&,DenseCplx const&,ITLazy const&,ManageStore&);
 
 void
 doTask(Contract<Index>& C,
-       const PData& R,
-       const ITLazy& L,
+       ITLazy const& L,
+       ITLazy const& R,
        ManageStore& m)
     {
-    if(L.hasResult())
+    if(!detail::sameInds(L.inds(),C.Lis) || !detail::sameInds(R.inds(),C.Ris))
         {
-        //Eventually handle this in dotask.h?
-        //--> call doTask(Contract,R,L.result());
+        detail::contractNow(C,L.evaluate(),R.evaluate(),m);
+        return;
         }
     contractIS(C.Lis,C.Ris,C.Nis);
     auto* nL = m.makeNewData<ITLazy>(L);
-    nL->addStore(C.Nis,R);
+    nL->addStore(R);
+    nL->setInds(C.Nis);
     }
 
 } // namespace itensor
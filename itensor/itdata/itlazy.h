@@ -5,11 +5,27 @@
 #ifndef __ITENSOR_ITLAZY_H
 #define __ITENSOR_ITLAZY_H
 
+#include <mutex>
 #include "itensor/itdata/task_types.h"
 #include "itensor/itdata/itdata.h"
+#include "itensor/itdata/dense.h"
 
 namespace itensor {
 
+//
+// ITLazy is the storage of an ITensor holding a
+// product of dense ITensors which has not been
+// computed yet (see lazy(ITensor) in itensor.h).
+// It records the index set and storage of each
+// factor, plus the index set of the product.
+//
+// Contracting with another dense ITensor only adds
+// a factor. Any other operation evaluates the
+// product, contracting the factors in the order of
+// lowest estimated cost (as in contractNetwork),
+// with the last contraction writing the result
+// directly in the index order of the product.
+//
 class ITLazy
     {
     public:
@@ -25,25 +41,23 @@ class ITLazy
     using storage_type = std::vector<IndSto>;
     private:
     storage_type todo_;
-    PData result_;
+    IndexSet is_;
+    mutable std::mutex mutex_;
+    mutable PData result_;
     public:
 
     ITLazy() { }
 
-    ITLazy(const IndexSet& i1,
-           const PData& s1,
-           const IndexSet& i2,
-           const PData& s2)
-      : todo_(2) 
-        { 
-        todo_[0].i = i1;
-        todo_[0].s = s1;
-        todo_[1].i = i2;
-        todo_[1].s = s2;
-        }
+    ITLazy(const IndexSet& is,
+           const PData& s)
+      : todo_(1,IndSto(is,s)),
+        is_(is)
+        { }
+
+    ITLazy(const ITLazy& other);
 
-    storage_type&
-    todo() { return todo_; }
+    ITLazy&
+    operator=(const ITLazy& other);
 
     const storage_type&
     todo() const { return todo_; }
@@ -51,12 +65,16 @@ class ITLazy
     const IndexSet&
     iset(size_t n) const { return todo_[n].i; }
 
-    PData&
-    store(size_t n) { return todo_[n].s; }
-
     const PData&
     store(size_t n) const { return todo_[n].s; }
 
+    //Index set of the product
+    const IndexSet&
+    inds() const { return is_; }
+
+    void
+    setInds(const IndexSet& is) { is_ = is; }
+
     void
     addStore(const IndexSet& is,
              const PData& pstore)
@@ -71,36 +89,58 @@ class ITLazy
         }
 
     bool
-    hasResult() const { return static_cast<bool>(result_); }
-
-    const PData&
-    result() const { return result_; }
-
-    void
-    setResult(PData&& p) { result_ = std::move(p); }
+    hasResult() const;
 
+    //Contracts the factors the first time
+    //it is called, then returns the result
+    PData
+    evaluate() const;
     };
 
+const char*
+typeNameOf(ITLazy const& d);
+
 bool
-hasResult(const ITLazy& Z);
+hasResult(ITLazy const& Z);
 
 PData
-evaluate(ITLazy& Z);
+evaluate(ITLazy const& Z);
+
+//Whether p holds Dense<Real> or Dense<Cplx> storage
+bool
+isDenseStorage(PData const& p);
+
+namespace detail {
 
+//Contracts storages L and R right away,
+//making the result the storage of m
+template<typename IndexT>
+void
+contractNow(Contract<IndexT>& C,
+            PData L,
+            PData R,
+            ManageStore& m);
+
+} //namespace detail
+
+template<typename T>
 void
 doTask(Contract<Index>& C,
-       ITLazy& L,
-       const ITLazy& R);
+       ITLazy const& L,
+       Dense<T> const& R,
+       ManageStore& m);
 
+template<typename T>
 void
 doTask(Contract<Index>& C,
-       ITLazy& L,
-       const PData& R);
+       Dense<T> const& L,
+       ITLazy const& R,
+       ManageStore& m);
 
 void
 doTask(Contract<Index>& C,
-       const PData& R,
-       const ITLazy& L,
+       ITLazy const& L,
+       ITLazy const& R,
        ManageStore& m);
 
 } //namespace itensor
@@ -0,0 +1,367 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include "itensor/itdata/mposparse.h"
+#include "itensor/itdata/dotask.h"
+#include "itensor/tensor/sliceten.h"
+#include "itensor/tensor/contract.h"
+#include "itensor/util/range.h"
+
+namespace itensor {
+
+const char*
+typeNameOf(MPOSparseReal const& d) { return "MPOSparseReal"; }
+const char*
+typeNameOf(MPOSparseCplx const& d) { return "MPOSparseCplx"; }
+
+namespace detail {
+
+//Range of a contiguous tensor with dimensions dims
+Range
+contigRange(std::vector<long> const& dims)
+    {
+    auto rb = RangeBuilder(dims.size());
+    for(auto d : dims) rb.nextIndex(d);
+    return rb.build();
+    }
+
+std::vector<long>
+dimsOf(IndexSet const& is)
+    {
+    auto dims = std::vector<long>(is.r());
+    for(auto n : range(is.r())) dims[n] = is[n].m();
+    return dims;
+    }
+
+template<typename T>
+std::vector<long>
+blockDims(MPOSparse<T> const& W)
+    {
+    auto bdims = W.dims;
+    if(W.inpos >= 0) bdims[W.inpos] = 1;
+    if(W.outpos >= 0) bdims[W.outpos] = 1;
+    return bdims;
+    }
+
+} //namespace detail
+
+template<typename T>
+MPOSparse<T>::
+MPOSparse(Dense<T> const& d,
+          IndexSet const& is,
+          int inpos_,
+          int outpos_)
+  : MPOSparse(d.data(),detail::dimsOf(is),inpos_,outpos_)
+    { }
+
+template<typename T>
+MPOSparse<T>::
+MPOSparse(T const* d,
+          std::vector<long> const& dims_,
+          int inpos_,
+          int outpos_)
+  : dims(dims_),
+    inpos(inpos_),
+    outpos(outpos_)
+    {
+    auto bdims = detail::blockDims(*this);
+    blocksize = 1;
+    for(auto bd : bdims) blocksize *= bd;
+
+    auto drange = detail::contigRange(dims);
+    auto brange = detail::contigRange(bdims);
+    auto td = makeTenRef(d,area(drange),&drange);
+    auto nin = (inpos >= 0) ? dims[inpos] : 1l,
+         nout = (outpos >= 0) ? dims[outpos] : 1l;
+    for(auto a : range(nin))
+    for(auto b : range(nout))
+        {
+        auto blk = td;
+        if(inpos >= 0) blk = subIndex(blk,inpos,a,a+1);
+        if(outpos >= 0) blk = subIndex(blk,outpos,b,b+1);
+        auto nonzero = false;
+        for(auto& el : blk)
+            {
+            if(el != T(0))
+                {
+                nonzero = true;
+                break;
+                }
+            }
+        if(!nonzero) continue;
+        auto offset = store.size();
+        store.resize(offset+blocksize);
+        makeTenRef(store.data()+offset,blocksize,&brange) &= blk;
+        entries.push_back(Entry{a,b,offset});
+        }
+    }
+
+template<typename T>
+size_t MPOSparse<T>::
+denseSize() const
+    {
+    size_t size = 1;
+    for(auto d : dims) size *= d;
+    return size;
+    }
+
+template<typename T>
+void MPOSparse<T>::
+copyTo(T* d) const
+    {
+    auto drange = detail::contigRange(dims);
+    auto brange = detail::contigRange(detail::blockDims(*this));
+    auto tr = makeTenRef(d,denseSize(),&drange);
+    for(auto& e : entries)
+        {
+        auto blk = tr;
+        if(inpos >= 0) blk = subIndex(blk,inpos,e.in,e.in+1);
+        if(outpos >= 0) blk = subIndex(blk,outpos,e.out,e.out+1);
+        blk &= makeTenRef(store.data()+e.offset,blocksize,&brange);
+        }
+    }
+
+template<typename T>
+Dense<T> MPOSparse<T>::
+toDense() const
+    {
+    auto res = Dense<T>(denseSize());
+    copyTo(res.data());
+    return res;
+    }
+
+template<typename T>
+PData
+evaluate(MPOSparse<T> const& d)
+    {
+    return newITData<Dense<T>>(d.toDense());
+    }
+template PData evaluate(MPOSparseReal const&);
+template PData evaluate(MPOSparseCplx const&);
+
+template<typename T>
+Real
+doTask(NormNoScale, MPOSparse<T> const& d)
+    {
+    Real nrm2 = 0;
+    for(auto& el : d.store) nrm2 += std::norm(el);
+    return std::sqrt(nrm2);
+    }
+template Real doTask(NormNoScale, MPOSparseReal const&);
+template Real doTask(NormNoScale, MPOSparseCplx const&);
+
+void
+doTask(Conj, MPOSparseCplx & d)
+    {
+    for(auto& el : d.store) el = std::conj(el);
+    }
+
+template<typename T>
+void
+doTask(PrintIT<Index>& P, MPOSparse<T> const& d)
+    {
+    auto type = std::is_same<T,Real>::value ? "Real" : "Cplx";
+    P.printInfo(d,format("MPOSparse %s, %d entries",type,d.entries.size()),
+                doTask(NormNoScale{},d));
+    }
+template void doTask(PrintIT<Index>&, MPOSparseReal const&);
+template void doTask(PrintIT<Index>&, MPOSparseCplx const&);
+
+template<typename T>
+void
+doTask(ToMPOSparse<Index> const& S, Dense<T> const& d, ManageStore & m)
+    {
+    m.makeNewData<MPOSparse<T>>(d,S.is,S.inpos,S.outpos);
+    }
+template void doTask(ToMPOSparse<Index> const&, DenseReal const&, ManageStore &);
+template void doTask(ToMPOSparse<Index> const&, DenseCplx const&, ManageStore &);
+
+namespace detail {
+
+//Labels of the indices of the product, in the
+//order of C.Nis if already set (as in Dense contraction)
+void
+productLabels(Contract<Index> & C,
+              Labels const& Lind,
+              Labels const& Rind,
+              Labels & Nind)
+    {
+    if(not C.Nis)
+        {
+        contractIS(C.Lis,Lind,C.Ris,Rind,C.Nis,Nind,false);
+        return;
+        }
+    Nind.resize(C.Nis.r());
+    for(auto i : range(C.Nis.r()))
+        {
+        auto j = findindex(C.Lis,C.Nis[i]);
+        if(j >= 0) Nind[i] = Lind[j];
+        else       Nind[i] = Rind[findindex(C.Ris,C.Nis[i])];
+        }
+    }
+
+long
+position(Labels const& ind, long label)
+    {
+    for(auto n : range(ind.size())) if(ind[n] == label) return n;
+    return -1;
+    }
+
+template<typename TD, typename TW>
+void
+contractMPOSparse(TD const* D,
+                  std::vector<long> const& Ddims,
+                  Labels const& Dind,
+                  MPOSparse<TW> const& W,
+                  Labels const& Wind,
+                  common_type<TD,TW>* N,
+                  std::vector<long> const& Ndims,
+                  Labels const& Nind)
+    {
+    using VC = common_type<TD,TW>;
+
+    //Position of each link of W in D if it is
+    //contracted, otherwise in the product
+    int Wpos[2] = {W.inpos,W.outpos};
+    long Dpos[2] = {-1,-1},
+         Npos[2] = {-1,-1};
+    for(auto n : range(2))
+        {
+        if(Wpos[n] < 0) continue;
+        auto label = Wind[Wpos[n]];
+        if(label < 0) Dpos[n] = position(Dind,label);
+        else          Npos[n] = position(Nind,label);
+        }
+
+    auto Drange = contigRange(Ddims),
+         Nrange = contigRange(Ndims),
+         Brange = contigRange(blockDims(W));
+    auto Sdims = Ddims,
+         Tdims = Ndims;
+    for(auto n : range(2))
+        {
+        if(Dpos[n] >= 0) Sdims[Dpos[n]] = 1;
+        if(Npos[n] >= 0) Tdims[Npos[n]] = 1;
+        }
+    auto Srange = contigRange(Sdims),
+         Trange = contigRange(Tdims);
+
+    auto tD = makeTenRef(D,area(Drange),&Drange);
+    auto tN = makeTenRef(N,area(Nrange),&Nrange);
+
+    //Slices of D, copied to contiguous storage when
+    //first needed by an entry and reused after
+    auto nslice = 1l;
+    long Dext[2] = {1,1};
+    for(auto n : range(2))
+        {
+        if(Dpos[n] >= 0) Dext[n] = Ddims[Dpos[n]];
+        nslice *= Dext[n];
+        }
+    auto slices = std::vector<std::vector<TD>>(nslice);
+
+    auto T = std::vector<VC>(area(Trange));
+    auto tT = makeTenRef(T.data(),T.size(),&Trange);
+
+    for(auto& e : W.entries)
+        {
+        long val[2] = {e.in,e.out};
+        auto key = (Dpos[0] >= 0 ? val[0] : 0)*Dext[1]
+                 + (Dpos[1] >= 0 ? val[1] : 0);
+        auto& S = slices[key];
+        if(S.empty())
+            {
+            S.resize(area(Srange));
+            auto sD = tD;
+            for(auto n : range(2))
+                {
+                if(Dpos[n] >= 0) sD = subIndex(sD,Dpos[n],val[n],val[n]+1);
+                }
+            makeTenRef(S.data(),S.size(),&Srange) &= sD;
+            }
+        auto tS = makeTenRef(static_cast<TD const*>(S.data()),S.size(),&Srange);
+        auto tB = makeTenRef(W.store.data()+e.offset,W.blocksize,&Brange);
+        contract(tS,Dind,tB,Wind,tT,Nind);
+
+        auto sN = tN;
+        for(auto n : range(2))
+            {
+            if(Npos[n] >= 0) sN = subIndex(sN,Npos[n],val[n],val[n]+1);
+            }
+        sN += makeTenRef(static_cast<VC const*>(T.data()),T.size(),&Trange);
+        }
+    }
+template void contractMPOSparse(Real const*,std::vector<long> const&,Labels const&,MPOSparseReal const&,Labels const&,
+                                Real*,std::vector<long> const&,Labels const&);
+template void contractMPOSparse(Real const*,std::vector<long> const&,Labels const&,MPOSparseCplx const&,Labels const&,
+                                Cplx*,std::vector<long> const&,Labels const&);
+template void contractMPOSparse(Cplx const*,std::vector<long> const&,Labels const&,MPOSparseReal const&,Labels const&,
+                                Cplx*,std::vector<long> const&,Labels const&);
+template void contractMPOSparse(Cplx const*,std::vector<long> const&,Labels const&,MPOSparseCplx const&,Labels const&,
+                                Cplx*,std::vector<long> const&,Labels const&);
+
+//Product of dense storage D with MPOSparse storage W
+template<typename TD, typename TW>
+void
+contractDenseMPOSparse(Contract<Index> & C,
+                       Dense<TD> const& D,
+                       IndexSet const& Dis,
+                       Labels const& Dind,
+                       MPOSparse<TW> const& W,
+                       Labels const& Wind,
+                       Labels const& Nind,
+                       ManageStore & m)
+    {
+    using VC = common_type<TD,TW>;
+    auto nd = m.makeNewData<Dense<VC>>(area(C.Nis));
+    contractMPOSparse(D.data(),dimsOf(Dis),Dind,W,Wind,nd->data(),dimsOf(C.Nis),Nind);
+#ifdef USESCALE
+    if(area(C.Nis) > 1) C.scalefac = computeScalefac(*nd);
+#endif
+    }
+
+} //namespace detail
+
+template<typename TW, typename TD>
+void
+doTask(Contract<Index>& C,
+       MPOSparse<TW> const& W,
+       Dense<TD> const& D,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Nind;
+    computeLabels(C.Lis,C.Lis.r(),C.Ris,C.Ris.r(),Lind,Rind);
+    detail::productLabels(C,Lind,Rind,Nind);
+    detail::contractDenseMPOSparse(C,D,C.Ris,Rind,W,Lind,Nind,m);
+    }
+template void doTask(Contract<Index>&,MPOSparseReal const&,DenseReal const&,ManageStore&);
+template void doTask(Contract<Index>&,MPOSparseReal const&,DenseCplx const&,ManageStore&);
+template void doTask(Contract<Index>&,MPOSparseCplx const&,DenseReal const&,ManageStore&);
+template void doTask(Contract<Index>&,MPOSparseCplx const&,DenseCplx const&,ManageStore&);
+
+template<typename TD, typename TW>
+void
+doTask(Contract<Index>& C,
+       Dense<TD> const& D,
+       MPOSparse<TW> const& W,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Nind;
+    computeLabels(C.Lis,C.Lis.r(),C.Ris,C.Ris.r(),Lind,Rind);
+    detail::productLabels(C,Lind,Rind,Nind);
+    detail::contractDenseMPOSparse(C,D,C.Lis,Lind,W,Rind,Nind,m);
+    }
+template void doTask(Contract<Index>&,DenseReal const&,MPOSparseReal const&,ManageStore&);
+template void doTask(Contract<Index>&,DenseReal const&,MPOSparseCplx const&,ManageStore&);
+template void doTask(Contract<Index>&,DenseCplx const&,MPOSparseReal const&,ManageStore&);
+template void doTask(Contract<Index>&,DenseCplx const&,MPOSparseCplx const&,ManageStore&);
+
+template class MPOSparse<Real>;
+template class MPOSparse<Cplx>;
+
+} //namespace itensor
@@ -0,0 +1,257 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_MPOSPARSE_H
+#define __ITENSOR_MPOSPARSE_H
+
+#include "itensor/itdata/dense.h"
+#include "itensor/itdata/itlazy.h"
+
+namespace itensor {
+
+template<typename T>
+class MPOSparse;
+
+using MPOSparseReal = MPOSparse<Real>;
+using MPOSparseCplx = MPOSparse<Cplx>;
+
+//
+// MPOSparse is the storage of a tensor such as an
+// MPO tensor W, viewed as a matrix over the values
+// of its link indices whose entries are operators
+// on its other (site) indices. Only the non-zero
+// operator entries are stored, as dense blocks.
+//
+// Contracting with a dense ITensor costs one small
+// contraction per stored entry, instead of one over
+// all k^2 pairs of link values. Any other operation
+// converts the storage to Dense first.
+//
+// Create with sparseLinks(T,l1,l2), see itensor.h.
+//
+template<typename T>
+class MPOSparse
+    {
+    public:
+    using value_type = T;
+
+    struct Entry
+        {
+        long in;
+        long out;
+            //^ values of the link indices (0 if absent)
+        size_t offset;
+            //^ start of the block in store
+        };
+
+    //////////////
+    std::vector<long> dims;
+        //^ dimensions of the indices
+
+    int inpos = -1,
+        outpos = -1;
+        //^ positions of the link indices in
+        //  the IndexSet (-1 if absent)
+
+    size_t blocksize = 0;
+        //^ number of elements of each block
+
+    std::vector<Entry> entries;
+        //^ entries sorted by (in,out)
+
+    std::vector<T> store;
+        //^ blocks stored contiguously, each in the
+        //  index order of the tensor, skipping the links
+    //////////////
+
+    MPOSparse() { }
+
+    //Keeps the non-zero blocks of dense storage d
+    MPOSparse(Dense<T> const& d,
+              IndexSet const& is,
+              int inpos_,
+              int outpos_);
+
+    //Keeps the non-zero blocks of the contiguous
+    //tensor at d with dimensions dims_
+    MPOSparse(T const* d,
+              std::vector<long> const& dims_,
+              int inpos_,
+              int outpos_);
+
+    size_t
+    size() const { return store.size(); }
+
+    //Number of elements of the dense tensor
+    size_t
+    denseSize() const;
+
+    //Writes the stored blocks into the contiguous,
+    //zero-initialized tensor at d
+    void
+    copyTo(T* d) const;
+
+    Dense<T>
+    toDense() const;
+    };
+
+namespace detail {
+
+//Adds the product of the contiguous tensor D, with
+//dimensions Ddims, and W to the contiguous tensor N.
+//Labels are as in contract (see tensor/contract.h).
+template<typename TD, typename TW>
+void
+contractMPOSparse(TD const* D,
+                  std::vector<long> const& Ddims,
+                  Labels const& Dind,
+                  MPOSparse<TW> const& W,
+                  Labels const& Wind,
+                  common_type<TD,TW>* N,
+                  std::vector<long> const& Ndims,
+                  Labels const& Nind);
+
+} //namespace detail
+
+template<typename T>
+bool constexpr
+isCplx(MPOSparse<T> const& d) { return std::is_same<T,Cplx>::value; }
+
+const char*
+typeNameOf(MPOSparseReal const& d);
+const char*
+typeNameOf(MPOSparseCplx const& d);
+
+template<typename T>
+void
+write(std::ostream& s, MPOSparse<T> const& dat)
+    {
+    itensor::write(s,dat.dims);
+    itensor::write(s,dat.inpos);
+    itensor::write(s,dat.outpos);
+    itensor::write(s,dat.blocksize);
+    itensor::write(s,dat.entries);
+    itensor::write(s,dat.store);
+    }
+
+template<typename T>
+void
+read(std::istream& s, MPOSparse<T> & dat)
+    {
+    itensor::read(s,dat.dims);
+    itensor::read(s,dat.inpos);
+    itensor::read(s,dat.outpos);
+    itensor::read(s,dat.blocksize);
+    itensor::read(s,dat.entries);
+    itensor::read(s,dat.store);
+    }
+
+//Tasks without an overload below convert MPOSparse
+//storage to Dense, which then replaces it
+template<typename T>
+bool
+hasResult(MPOSparse<T> const& d) { return false; }
+
+template<typename T>
+PData
+evaluate(MPOSparse<T> const& d);
+
+template<typename T>
+bool constexpr
+doTask(CheckComplex, MPOSparse<T> const& d) { return isCplx(d); }
+
+template<typename T>
+Real
+doTask(NormNoScale, MPOSparse<T> const& d);
+
+void inline
+doTask(Conj, MPOSparseReal const& d) { }
+
+void
+doTask(Conj, MPOSparseCplx & d);
+
+template<typename T>
+void
+doTask(PrintIT<Index>& P, MPOSparse<T> const& d);
+
+auto inline constexpr
+doTask(StorageType const& S, MPOSparseReal const& d) ->StorageType::Type { return StorageType::MPOSparseReal; }
+
+auto inline constexpr
+doTask(StorageType const& S, MPOSparseCplx const& d) ->StorageType::Type { return StorageType::MPOSparseCplx; }
+
+template<typename D,
+         class=stdx::require<containsType<StorageTypes,D>> >
+void
+doTask(ToMPOSparse<Index> const& S, D const& d) { }
+
+template<typename T>
+void
+doTask(ToMPOSparse<Index> const& S, Dense<T> const& d, ManageStore & m);
+
+template<typename TW, typename TD>
+void
+doTask(Contract<Index>& C,
+       MPOSparse<TW> const& W,
+       Dense<TD> const& D,
+       ManageStore& m);
+
+template<typename TD, typename TW>
+void
+doTask(Contract<Index>& C,
+       Dense<TD> const& D,
+       MPOSparse<TW> const& W,
+       ManageStore& m);
+
+//Contracting with other storage types uses a dense
+//copy of W, leaving the storage of W unchanged
+
+namespace detail {
+template<typename D>
+struct OtherThanDense : std::true_type { };
+template<typename T>
+struct OtherThanDense<Dense<T>> : std::false_type { };
+template<typename T>
+struct OtherThanDense<MPOSparse<T>> : std::false_type { };
+template<typename T>
+struct OtherThanDense<QDense<T>> : std::false_type { };
+template<typename T>
+struct OtherThanDense<QMPOSparse<T>> : std::false_type { };
+} //namespace detail
+
+template<typename TW, typename D,
+         class=stdx::require<containsType<StorageTypes,D>,detail::OtherThanDense<D>> >
+void
+doTask(Contract<Index>& C,
+       MPOSparse<TW> const& W,
+       D const& d,
+       ManageStore& m)
+    {
+    detail::contractNow(C,evaluate(W),m.parg2(),m);
+    }
+
+template<typename D, typename TW,
+         class=stdx::require<containsType<StorageTypes,D>,detail::OtherThanDense<D>> >
+void
+doTask(Contract<Index>& C,
+       D const& d,
+       MPOSparse<TW> const& W,
+       ManageStore& m)
+    {
+    detail::contractNow(C,m.parg1(),evaluate(W),m);
+    }
+
+template<typename T1, typename T2>
+void
+doTask(Contract<Index>& C,
+       MPOSparse<T1> const& W1,
+       MPOSparse<T2> const& W2,
+       ManageStore& m)
+    {
+    detail::contractNow(C,evaluate(W1),evaluate(W2),m);
+    }
+
+} //namespace itensor
+
+#endif
@@ -100,6 +100,23 @@ replaceInd(IQIndexSet const& is,
     return newind.build();
     }
 
+//True if each block of the combined IQIndex cind
+//holds exactly one block of the indices it combines,
+//in the same order, so that combining or uncombining
+//changes only the IQIndexSet and not the storage
+bool
+isBlockRelabeling(QCombiner const& C,
+                  IQIndex const& cind)
+    {
+    if(size_t(cind.nindex()) != C.store_.size()) return false;
+    for(auto o : range(C.store_))
+        {
+        auto& br = C.store_[o];
+        if(br.block != o || br.start != 0) return false;
+        }
+    return true;
+    }
+
 template<typename T>
 void
 combine(QDense<T>   const& d,
@@ -144,6 +161,13 @@ combine(QDense<T>   const& d,
     for(auto i : range(dr)) if(!combined(i)) newind.nextIndex(dis[i]);
     Nis = newind.build();
 
+    //If the combined indices come first and in order,
+    //and C maps their blocks one-to-one, the storage
+    //of d is already that of the result
+    auto inorder = true;
+    for(auto i : range(dr)) if(dperm[i] != long(i)) inorder = false;
+    if(inorder && isBlockRelabeling(C,Cis[0])) return;
+
     //Allocate new data
     auto& nd = *m.makeNewData<QDense<T>>(Nis,doTask(CalcDiv{dis},d));
 
@@ -151,7 +175,8 @@ combine(QDense<T>   const& d,
          nrange = Range(nr); //block range of new storage
     auto dblock = Labels(dr), //block index of current storage
          nblock = Labels(nr), //block index of new storage
-         cblock = Labels(ncomb); //corresponding subblock of combiner
+         cblock = Labels(ncomb), //corresponding subblock of combiner
+         cext = Labels(ncomb); //extents of combined indices in this block
     size_t start = 0, //offsets within sector of combined
            end   = 0; //IQIndex where block will go
     for(auto io : d.offsets) //loop over non-zero blocks
@@ -163,19 +188,21 @@ combine(QDense<T>   const& d,
         drange.init(make_indexdim(dis,dblock));
         auto dref = makeTenRef(d.data(),io.offset,d.size(),&drange);
 
-        //Permute combined indices to front, then
-        //group the first ncomb indices into one
-        auto Pdref = Ten<Range,T>{permute(dref,dperm)};
-        auto gPdref = groupInds(Pdref,0,ncomb);
-
         //Figure out "block index" where this block will
         //go in new storage (nblock) and which sector of
         //combined indices maps to new combined index (cblock)
         size_t nu = 1;
         for(auto i : range(dr)) 
             {
-            if(combined(i)) cblock[dperm[i]] = dblock[i];
-            else            nblock[nu++] = dblock[i];
+            if(combined(i))
+                {
+                cblock[dperm[i]] = dblock[i];
+                cext[dperm[i]] = drange.extent(i);
+                }
+            else
+                {
+                nblock[nu++] = dblock[i];
+                }
             }
 
         //Use cblock to recover info about structure of combined IQIndex,
@@ -190,7 +217,19 @@ combine(QDense<T>   const& d,
 
         //Slice this new-storage block to get subblock where data will go
         auto nsub = subIndex(nref,0,start,end);
-        nsub &= gPdref;
+
+        //View the subblock with the combined index split back
+        //into the combined indices, then permute the block of d
+        //(combined indices to front) directly into it
+        auto srb = RangeBuilder(dr);
+        auto str = nsub.stride(0);
+        for(auto c : range(ncomb))
+            {
+            srb.nextIndStr(cext[c],str);
+            str *= cext[c];
+            }
+        for(auto i : range(1,nr)) srb.nextIndStr(nsub.extent(i),nsub.stride(i));
+        makeRef(nsub.store(),srb.build()) &= permute(dref,dperm);
         }
     }
 
@@ -228,6 +267,11 @@ uncombine(QDense<T>   const& d,
         }
     Nis = newind.build();
 
+    //Restoring the combined indices in place of cind
+    //leaves the storage unchanged if C maps their
+    //blocks one-to-one
+    if(isBlockRelabeling(C,cind)) return;
+
     //Allocate new data
     auto& nd = *m.makeNewData<QDense<T>>(Nis,doTask(CalcDiv{dis},d));
 
@@ -320,6 +364,7 @@ doTask(Contract<IQIndex> & C,
         {
         combine(d,cmb,C.Ris,C.Lis,C.Nis,m);
         }
+    if(!m.newData()) m.assignPointerRtoL();
     }
 template void doTask(Contract<IQIndex> &,QCombiner const&,QDense<Real> const&,ManageStore &);
 template void doTask(Contract<IQIndex> &,QCombiner const&,QDense<Cplx> const&,ManageStore &);
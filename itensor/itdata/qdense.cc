@@ -454,9 +454,9 @@ doTask(Contract<IQIndex>& Con,
     auto Cdiv = doTask(CalcDiv{Con.Lis},A)+doTask(CalcDiv{Con.Ris},B);
 
     //Allocate storage for C
-    START_TIMER(33)
+    PROFILE_START(qdense_alloc)
     auto nd = m.makeNewData<QDense<VC>>(Con.Nis,Cdiv);
-    STOP_TIMER(33)
+    PROFILE_STOP(qdense_alloc)
     auto& C = *nd;
 
     //Function to execute for each pair of
@@ -483,22 +483,22 @@ doTask(Contract<IQIndex>& Con,
         auto cref = makeRef(cblock,&Crange);
 
         //Compute cref += aref*bref
-        START_TIMER(2)
+        PROFILE_START(block_contract)
         contract(aref,Lind,bref,Rind,cref,Cind,1.,1.);
-        STOP_TIMER(2)
+        PROFILE_STOP(block_contract)
         };
 
-    START_TIMER(20)
+    PROFILE_START(qdense_contract)
     loopContractedBlocks(A,Con.Lis,
                          B,Con.Ris,
                          C,Con.Nis,
                          do_contract);
-    STOP_TIMER(20)
+    PROFILE_STOP(qdense_contract)
 
 #ifdef USESCALE
-    START_TIMER(21)
+    PROFILE_START(scalefac)
     Con.scalefac = computeScalefac(C);
-    STOP_TIMER(21)
+    PROFILE_STOP(scalefac)
 #endif
     }
 template void doTask(Contract<IQIndex>& Con,QDense<Real> const&,QDense<Real> const&,ManageStore&);
@@ -9,6 +9,7 @@
 #include "itensor/itdata/task_types.h"
 #include "itensor/iqindex.h"
 #include "itensor/itdata/itdata.h"
+#include "itensor/util/mapalloc.h"
 #include "itensor/tensor/types.h"
 #include "itensor/detail/gcounter.h"
 #include "itensor/detail/call_rewrite.h"
@@ -34,7 +35,7 @@ class QDense
                   "Template argument of QDense must be non-const");
     public:
     using value_type = T;
-    using storage_type = std::vector<value_type>;
+    using storage_type = std::vector<value_type,MapAllocator<value_type>>;
     using iterator = typename storage_type::iterator;
     using const_iterator = typename storage_type::const_iterator;
 
@@ -294,6 +295,14 @@ template<typename T>
 void
 doTask(PrintIT<IQIndex>& P, QDense<T> const& d);
 
+template<typename T>
+void
+doTask(GetData<T> & G, QDense<T> const& d)
+    {
+    G.data = d.data();
+    G.size = d.size();
+    }
+
 auto inline constexpr
 doTask(StorageType const& S, QDenseReal const& d) ->StorageType::Type { return StorageType::QDenseReal; }
 
@@ -0,0 +1,255 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include "itensor/itdata/qmposparse.h"
+#include "itensor/itdata/qutil.h"
+#include "itensor/itdata/dotask.h"
+#include "itensor/tensor/contract.h"
+#include "itensor/util/range.h"
+
+namespace itensor {
+
+const char*
+typeNameOf(QMPOSparseReal const& d) { return "QMPOSparseReal"; }
+const char*
+typeNameOf(QMPOSparseCplx const& d) { return "QMPOSparseCplx"; }
+
+template<typename T>
+QMPOSparse<T>::
+QMPOSparse(QDense<T> const& d,
+           IQIndexSet const& is,
+           int inpos,
+           int outpos)
+  : offsets(d.offsets),
+    dsize(d.size()),
+    div(doTask(CalcDiv{is},d))
+    {
+    auto r = is.r();
+    auto block_ind = Labels(r);
+    auto dims = std::vector<long>(r);
+    blocks.reserve(offsets.size());
+    for(auto& bo : offsets)
+        {
+        computeBlockInd(bo.block,is,block_ind);
+        for(auto n : range(r)) dims[n] = is[n][block_ind[n]].m();
+        blocks.emplace_back(d.data()+bo.offset,dims,inpos,outpos);
+        }
+    }
+
+template<typename T>
+size_t QMPOSparse<T>::
+size() const
+    {
+    size_t s = 0;
+    for(auto& b : blocks) s += b.size();
+    return s;
+    }
+
+template<typename T>
+QDense<T> QMPOSparse<T>::
+toQDense() const
+    {
+    auto res = QDense<T>(offsets,dsize);
+    for(auto n : range(blocks.size()))
+        {
+        blocks[n].copyTo(res.data()+offsets[n].offset);
+        }
+    return res;
+    }
+
+template<typename T>
+PData
+evaluate(QMPOSparse<T> const& d)
+    {
+    return newITData<QDense<T>>(d.toQDense());
+    }
+template PData evaluate(QMPOSparseReal const&);
+template PData evaluate(QMPOSparseCplx const&);
+
+template<typename T>
+Real
+doTask(NormNoScale, QMPOSparse<T> const& d)
+    {
+    Real nrm2 = 0;
+    for(auto& b : d.blocks)
+    for(auto& el : b.store)
+        {
+        nrm2 += std::norm(el);
+        }
+    return std::sqrt(nrm2);
+    }
+template Real doTask(NormNoScale, QMPOSparseReal const&);
+template Real doTask(NormNoScale, QMPOSparseCplx const&);
+
+void
+doTask(Conj, QMPOSparseCplx & d)
+    {
+    for(auto& b : d.blocks)
+    for(auto& el : b.store)
+        {
+        el = std::conj(el);
+        }
+    }
+
+template<typename T>
+void
+doTask(PrintIT<IQIndex>& P, QMPOSparse<T> const& d)
+    {
+    auto type = std::is_same<T,Real>::value ? "Real" : "Cplx";
+    size_t nentries = 0;
+    for(auto& b : d.blocks) nentries += b.entries.size();
+    P.printInfo(d,format("QMPOSparse %s, %d blocks, %d entries",type,d.blocks.size(),nentries),
+                doTask(NormNoScale{},d));
+    }
+template void doTask(PrintIT<IQIndex>&, QMPOSparseReal const&);
+template void doTask(PrintIT<IQIndex>&, QMPOSparseCplx const&);
+
+template<typename T>
+void
+doTask(ToMPOSparse<IQIndex> const& S, QDense<T> const& d, ManageStore & m)
+    {
+    m.makeNewData<QMPOSparse<T>>(d,S.is,S.inpos,S.outpos);
+    }
+template void doTask(ToMPOSparse<IQIndex> const&, QDenseReal const&, ManageStore &);
+template void doTask(ToMPOSparse<IQIndex> const&, QDenseCplx const&, ManageStore &);
+
+namespace detail {
+
+//Product of QDense storage D with QMPOSparse storage W:
+//each stored block of W is contracted, entry by entry,
+//with every block of D whose contracted sectors match
+template<typename TD, typename TW>
+void
+contractQMPOSparse(Contract<IQIndex> & C,
+                   QDense<TD> const& D,
+                   IQIndexSet const& Dis,
+                   Labels const& Dind,
+                   QMPOSparse<TW> const& W,
+                   IQIndexSet const& Wis,
+                   Labels const& Wind,
+                   Labels const& Nind,
+                   ManageStore & m)
+    {
+    using VC = common_type<TD,TW>;
+    auto& Nis = C.Nis;
+    auto rD = Dis.r(),
+         rW = Wis.r(),
+         rN = Nis.r();
+
+    auto nd = m.makeNewData<QDense<VC>>(Nis,doTask(CalcDiv{Dis},D)+W.div);
+
+    auto position = [](Labels const& ind, long label)
+        {
+        for(auto n : range(ind.size())) if(ind[n] == label) return long(n);
+        return -1l;
+        };
+    //Position of each index of W in D if it is
+    //contracted, otherwise in the product
+    auto WtoD = Labels(rW,-1),
+         WtoN = Labels(rW,-1),
+         DtoN = Labels(rD,-1);
+    for(auto i : range(rW))
+        {
+        if(Wind[i] < 0) WtoD[i] = position(Dind,Wind[i]);
+        else            WtoN[i] = position(Nind,Wind[i]);
+        }
+    for(auto i : range(rD))
+        {
+        if(Dind[i] > 0) DtoN[i] = position(Nind,Dind[i]);
+        }
+
+    auto Dblockinds = std::vector<Labels>(D.offsets.size(),Labels(rD));
+    for(auto n : range(D.offsets.size()))
+        {
+        computeBlockInd(D.offsets[n].block,Dis,Dblockinds[n]);
+        }
+
+    auto Wblockind = Labels(rW),
+         Nblockind = Labels(rN);
+    auto Ddims = std::vector<long>(rD),
+         Ndims = std::vector<long>(rN);
+    for(auto k : range(W.blocks.size()))
+        {
+        if(W.blocks[k].entries.empty()) continue;
+        computeBlockInd(W.offsets[k].block,Wis,Wblockind);
+        for(auto i : range(rW))
+            {
+            if(WtoN[i] >= 0) Nblockind[WtoN[i]] = Wblockind[i];
+            }
+        for(auto n : range(D.offsets.size()))
+            {
+            auto& Dblockind = Dblockinds[n];
+            auto matches = true;
+            for(auto i : range(rW))
+                {
+                if(WtoD[i] >= 0 && Dblockind[WtoD[i]] != Wblockind[i])
+                    {
+                    matches = false;
+                    break;
+                    }
+                }
+            if(!matches) continue;
+            for(auto i : range(rD))
+                {
+                Ddims[i] = Dis[i][Dblockind[i]].m();
+                if(DtoN[i] >= 0) Nblockind[DtoN[i]] = Dblockind[i];
+                }
+            auto nblock = getBlock(*nd,Nis,Nblockind);
+            if(!nblock) continue;
+            for(auto i : range(rN)) Ndims[i] = Nis[i][Nblockind[i]].m();
+            contractMPOSparse(D.data()+D.offsets[n].offset,Ddims,Dind,
+                              W.blocks[k],Wind,
+                              nblock.data(),Ndims,Nind);
+            }
+        }
+
+#ifdef USESCALE
+    C.scalefac = computeScalefac(*nd);
+#endif
+    }
+
+} //namespace detail
+
+template<typename TW, typename TD>
+void
+doTask(Contract<IQIndex>& C,
+       QMPOSparse<TW> const& W,
+       QDense<TD> const& D,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Nind;
+    computeLabels(C.Lis,C.Lis.r(),C.Ris,C.Ris.r(),Lind,Rind);
+    contractIS(C.Lis,Lind,C.Ris,Rind,C.Nis,Nind,false);
+    detail::contractQMPOSparse(C,D,C.Ris,Rind,W,C.Lis,Lind,Nind,m);
+    }
+template void doTask(Contract<IQIndex>&,QMPOSparseReal const&,QDenseReal const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QMPOSparseReal const&,QDenseCplx const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QMPOSparseCplx const&,QDenseReal const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QMPOSparseCplx const&,QDenseCplx const&,ManageStore&);
+
+template<typename TD, typename TW>
+void
+doTask(Contract<IQIndex>& C,
+       QDense<TD> const& D,
+       QMPOSparse<TW> const& W,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Nind;
+    computeLabels(C.Lis,C.Lis.r(),C.Ris,C.Ris.r(),Lind,Rind);
+    contractIS(C.Lis,Lind,C.Ris,Rind,C.Nis,Nind,false);
+    detail::contractQMPOSparse(C,D,C.Lis,Lind,W,C.Ris,Rind,Nind,m);
+    }
+template void doTask(Contract<IQIndex>&,QDenseReal const&,QMPOSparseReal const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QDenseReal const&,QMPOSparseCplx const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QDenseCplx const&,QMPOSparseReal const&,ManageStore&);
+template void doTask(Contract<IQIndex>&,QDenseCplx const&,QMPOSparseCplx const&,ManageStore&);
+
+template class QMPOSparse<Real>;
+template class QMPOSparse<Cplx>;
+
+} //namespace itensor
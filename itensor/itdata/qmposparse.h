@@ -0,0 +1,200 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_QMPOSPARSE_H
+#define __ITENSOR_QMPOSPARSE_H
+
+#include "itensor/itdata/qdense.h"
+#include "itensor/itdata/mposparse.h"
+
+namespace itensor {
+
+template<typename T>
+class QMPOSparse;
+
+using QMPOSparseReal = QMPOSparse<Real>;
+using QMPOSparseCplx = QMPOSparse<Cplx>;
+
+//
+// QMPOSparse is the MPOSparse storage of an IQTensor
+// such as an IQMPO tensor W. Each block of its QDense
+// storage is kept as MPOSparse storage over the link
+// values of the block, so only the non-zero operator
+// entries are stored. (Quantum number conservation
+// removes whole blocks, but the allowed blocks of an
+// MPO still hold mostly zero entries around the
+// identity and single-site operators.)
+//
+// Contracting with a QDense IQTensor costs one small
+// contraction per stored entry of each pair of
+// matching blocks. Any other operation converts the
+// storage to QDense first.
+//
+// Create with sparseLinks(T,l1,l2), see iqtensor.h.
+//
+template<typename T>
+class QMPOSparse
+    {
+    public:
+    using value_type = T;
+
+    //////////////
+    std::vector<BlOf> offsets;
+        //^ block index / data offset pairs
+        //  of the QDense storage
+
+    size_t dsize = 0;
+        //^ data size of the QDense storage
+
+    std::vector<MPOSparse<T>> blocks;
+        //^ blocks[n] holds the block offsets[n]
+
+    QN div;
+        //^ divergence of the tensor
+    //////////////
+
+    QMPOSparse() { }
+
+    //Keeps the non-zero entries of each block of d
+    QMPOSparse(QDense<T> const& d,
+               IQIndexSet const& is,
+               int inpos,
+               int outpos);
+
+    size_t
+    size() const;
+
+    QDense<T>
+    toQDense() const;
+    };
+
+template<typename T>
+bool constexpr
+isCplx(QMPOSparse<T> const& d) { return std::is_same<T,Cplx>::value; }
+
+const char*
+typeNameOf(QMPOSparseReal const& d);
+const char*
+typeNameOf(QMPOSparseCplx const& d);
+
+template<typename T>
+void
+write(std::ostream& s, QMPOSparse<T> const& dat)
+    {
+    itensor::write(s,dat.offsets);
+    itensor::write(s,dat.dsize);
+    for(auto& b : dat.blocks) itensor::write(s,b);
+    itensor::write(s,dat.div);
+    }
+
+template<typename T>
+void
+read(std::istream& s, QMPOSparse<T> & dat)
+    {
+    itensor::read(s,dat.offsets);
+    itensor::read(s,dat.dsize);
+    dat.blocks.resize(dat.offsets.size());
+    for(auto& b : dat.blocks) itensor::read(s,b);
+    itensor::read(s,dat.div);
+    }
+
+//Tasks without an overload below convert QMPOSparse
+//storage to QDense, which then replaces it
+template<typename T>
+bool
+hasResult(QMPOSparse<T> const& d) { return false; }
+
+template<typename T>
+PData
+evaluate(QMPOSparse<T> const& d);
+
+template<typename T>
+bool constexpr
+doTask(CheckComplex, QMPOSparse<T> const& d) { return isCplx(d); }
+
+template<typename T>
+QN
+doTask(CalcDiv const& C, QMPOSparse<T> const& d) { return d.div; }
+
+template<typename T>
+Real
+doTask(NormNoScale, QMPOSparse<T> const& d);
+
+void inline
+doTask(Conj, QMPOSparseReal const& d) { }
+
+void
+doTask(Conj, QMPOSparseCplx & d);
+
+template<typename T>
+void
+doTask(PrintIT<IQIndex>& P, QMPOSparse<T> const& d);
+
+auto inline constexpr
+doTask(StorageType const& S, QMPOSparseReal const& d) ->StorageType::Type { return StorageType::QMPOSparseReal; }
+
+auto inline constexpr
+doTask(StorageType const& S, QMPOSparseCplx const& d) ->StorageType::Type { return StorageType::QMPOSparseCplx; }
+
+template<typename D,
+         class=stdx::require<containsType<StorageTypes,D>> >
+void
+doTask(ToMPOSparse<IQIndex> const& S, D const& d) { }
+
+template<typename T>
+void
+doTask(ToMPOSparse<IQIndex> const& S, QDense<T> const& d, ManageStore & m);
+
+template<typename TW, typename TD>
+void
+doTask(Contract<IQIndex>& C,
+       QMPOSparse<TW> const& W,
+       QDense<TD> const& D,
+       ManageStore& m);
+
+template<typename TD, typename TW>
+void
+doTask(Contract<IQIndex>& C,
+       QDense<TD> const& D,
+       QMPOSparse<TW> const& W,
+       ManageStore& m);
+
+//Contracting with other storage types uses a QDense
+//copy of W, leaving the storage of W unchanged
+
+template<typename TW, typename D,
+         class=stdx::require<containsType<StorageTypes,D>,detail::OtherThanDense<D>> >
+void
+doTask(Contract<IQIndex>& C,
+       QMPOSparse<TW> const& W,
+       D const& d,
+       ManageStore& m)
+    {
+    detail::contractNow(C,evaluate(W),m.parg2(),m);
+    }
+
+template<typename D, typename TW,
+         class=stdx::require<containsType<StorageTypes,D>,detail::OtherThanDense<D>> >
+void
+doTask(Contract<IQIndex>& C,
+       D const& d,
+       QMPOSparse<TW> const& W,
+       ManageStore& m)
+    {
+    detail::contractNow(C,m.parg1(),evaluate(W),m);
+    }
+
+template<typename T1, typename T2>
+void
+doTask(Contract<IQIndex>& C,
+       QMPOSparse<T1> const& W1,
+       QMPOSparse<T2> const& W2,
+       ManageStore& m)
+    {
+    detail::contractNow(C,evaluate(W1),evaluate(W2),m);
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,118 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <cmath>
+#include "itensor/itdata/singleprec.h"
+#include "itensor/itdata/dotask.h"
+
+namespace itensor {
+
+namespace detail {
+
+template<typename T>
+void
+copyOffsets(Dense<T> const& d, std::vector<BlOf> & offsets) { }
+
+template<typename T>
+void
+copyOffsets(QDense<T> const& d, std::vector<BlOf> & offsets) { offsets = d.offsets; }
+
+template<typename T>
+Dense<T>
+makeStore(std::vector<BlOf> const& offsets, size_t size, Dense<T> const*)
+    {
+    return Dense<T>(size);
+    }
+
+template<typename T>
+QDense<T>
+makeStore(std::vector<BlOf> const& offsets, size_t size, QDense<T> const*)
+    {
+    return QDense<T>(offsets,size);
+    }
+
+} //namespace detail
+
+template<typename StoreT>
+SinglePrec<StoreT>::
+SinglePrec(StoreT const& d)
+    {
+    detail::copyOffsets(d,offsets);
+    auto rd = realData(d);
+    store.resize(rd.size());
+    for(auto n : range(rd.size())) store[n] = static_cast<float>(rd[n]);
+    }
+
+template<typename StoreT>
+StoreT SinglePrec<StoreT>::
+toDouble() const
+    {
+    auto res = detail::makeStore(offsets,size(),static_cast<StoreT const*>(nullptr));
+    auto rd = realData(res);
+    for(auto n : range(store.size())) rd[n] = store[n];
+    return res;
+    }
+
+template<typename StoreT>
+PData
+evaluate(SinglePrec<StoreT> const& d)
+    {
+    return newITData<StoreT>(d.toDouble());
+    }
+
+template<typename StoreT>
+Real
+doTask(NormNoScale, SinglePrec<StoreT> const& d)
+    {
+    Real nrm2 = 0;
+    for(auto el : d.store) nrm2 += Real(el)*Real(el);
+    return std::sqrt(nrm2);
+    }
+
+template<typename T>
+void
+doTask(ToSingle, Dense<T> const& d, ManageStore & m)
+    {
+    m.makeNewData<SinglePrec<Dense<T>>>(d);
+    }
+template void doTask(ToSingle, DenseReal const&, ManageStore &);
+template void doTask(ToSingle, DenseCplx const&, ManageStore &);
+
+template<typename T>
+void
+doTask(ToSingle, QDense<T> const& d, ManageStore & m)
+    {
+    m.makeNewData<SinglePrec<QDense<T>>>(d);
+    }
+template void doTask(ToSingle, QDenseReal const&, ManageStore &);
+template void doTask(ToSingle, QDenseCplx const&, ManageStore &);
+
+template<typename StoreT>
+void
+doTask(ToDouble, SinglePrec<StoreT> const& d, ManageStore & m)
+    {
+    m.makeNewData<StoreT>(d.toDouble());
+    }
+
+template class SinglePrec<DenseReal>;
+template class SinglePrec<DenseCplx>;
+template class SinglePrec<QDenseReal>;
+template class SinglePrec<QDenseCplx>;
+
+template PData evaluate(SinglePrec<DenseReal> const&);
+template PData evaluate(SinglePrec<DenseCplx> const&);
+template PData evaluate(SinglePrec<QDenseReal> const&);
+template PData evaluate(SinglePrec<QDenseCplx> const&);
+
+template Real doTask(NormNoScale, SinglePrec<DenseReal> const&);
+template Real doTask(NormNoScale, SinglePrec<DenseCplx> const&);
+template Real doTask(NormNoScale, SinglePrec<QDenseReal> const&);
+template Real doTask(NormNoScale, SinglePrec<QDenseCplx> const&);
+
+template void doTask(ToDouble, SinglePrec<DenseReal> const&, ManageStore &);
+template void doTask(ToDouble, SinglePrec<DenseCplx> const&, ManageStore &);
+template void doTask(ToDouble, SinglePrec<QDenseReal> const&, ManageStore &);
+template void doTask(ToDouble, SinglePrec<QDenseCplx> const&, ManageStore &);
+
+} //namespace itensor
@@ -0,0 +1,153 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SINGLEPREC_H
+#define __ITENSOR_SINGLEPREC_H
+
+#include "itensor/itdata/task_types.h"
+#include "itensor/itdata/itdata.h"
+#include "itensor/itdata/dense.h"
+#include "itensor/itdata/qdense.h"
+
+namespace itensor {
+
+//
+// SinglePrec<StoreT> holds the elements of Dense or
+// QDense storage StoreT rounded to single precision,
+// using half the memory and disk space.
+//
+// Only conversion, reading, writing and a few queries
+// (such as the norm) work on single precision storage
+// directly. Any other operation first converts the
+// tensor back to its double precision storage StoreT,
+// which then replaces the single precision storage.
+//
+// Create with toSingle(T), see itensor_interface.h.
+//
+template<typename StoreT>
+class SinglePrec
+    {
+    public:
+    using double_type = StoreT;
+    using value_type = typename StoreT::value_type;
+
+    //////////////
+    std::vector<BlOf> offsets;
+        //^ block offsets of QDense storage
+        //  (empty for Dense storage)
+
+    std::vector<float> store;
+        //^ elements, with complex elements
+        //  stored as (real,imag) pairs
+    //////////////
+
+    SinglePrec() { }
+
+    explicit
+    SinglePrec(StoreT const& d);
+
+    size_t
+    size() const { return isCplx(*this) ? store.size()/2 : store.size(); }
+
+    //Convert back to double precision
+    StoreT
+    toDouble() const;
+    };
+
+using SingleDenseReal = SinglePrec<DenseReal>;
+using SingleDenseCplx = SinglePrec<DenseCplx>;
+using SingleQDenseReal = SinglePrec<QDenseReal>;
+using SingleQDenseCplx = SinglePrec<QDenseCplx>;
+
+template<typename StoreT>
+bool constexpr
+isCplx(SinglePrec<StoreT> const& d) { return std::is_same<typename StoreT::value_type,Cplx>::value; }
+
+template<typename StoreT>
+const char*
+typeNameOf(SinglePrec<StoreT> const& d) { return "SinglePrec"; }
+
+template<typename StoreT>
+void
+write(std::ostream& s, SinglePrec<StoreT> const& dat)
+    {
+    itensor::write(s,dat.offsets);
+    itensor::write(s,dat.store);
+    }
+
+template<typename StoreT>
+void
+read(std::istream& s, SinglePrec<StoreT> & dat)
+    {
+    itensor::read(s,dat.offsets);
+    itensor::read(s,dat.store);
+    }
+
+//Single precision storage is never swapped for
+//double precision except by the tasks it lacks
+template<typename StoreT>
+bool
+hasResult(SinglePrec<StoreT> const& d) { return false; }
+
+template<typename StoreT>
+PData
+evaluate(SinglePrec<StoreT> const& d);
+
+template<typename StoreT>
+bool constexpr
+doTask(CheckComplex, SinglePrec<StoreT> const& d) { return isCplx(d); }
+
+template<typename StoreT>
+Real
+doTask(NormNoScale, SinglePrec<StoreT> const& d);
+
+template<typename StoreT>
+auto constexpr
+doTask(StorageType const& S, SinglePrec<StoreT> const& d) ->StorageType::Type
+    {
+    return std::is_same<StoreT,DenseReal>::value  ? StorageType::SingleDenseReal
+         : std::is_same<StoreT,DenseCplx>::value  ? StorageType::SingleDenseCplx
+         : std::is_same<StoreT,QDenseReal>::value ? StorageType::SingleQDenseReal
+                                                   : StorageType::SingleQDenseCplx;
+    }
+
+//
+// Conversion tasks: storage types other than
+// Dense, QDense and SinglePrec are left unchanged
+//
+
+template<typename D,
+         class=stdx::require<containsType<StorageTypes,D>> >
+void
+doTask(ToSingle, D const& d) { }
+
+template<typename T>
+void
+doTask(ToSingle, Dense<T> const& d, ManageStore & m);
+
+template<typename T>
+void
+doTask(ToSingle, QDense<T> const& d, ManageStore & m);
+
+template<typename D,
+         class=stdx::require<containsType<StorageTypes,D>> >
+void
+doTask(ToDouble, D const& d) { }
+
+template<typename StoreT>
+void
+doTask(ToDouble, SinglePrec<StoreT> const& d, ManageStore & m);
+
+template<typename D,
+         class=stdx::require<containsType<StorageTypes,D>> >
+bool constexpr
+doTask(IsSingle, D const& d) { return false; }
+
+template<typename StoreT>
+bool constexpr
+doTask(IsSingle, SinglePrec<StoreT> const& d) { return true; }
+
+} //namespace itensor
+
+#endif
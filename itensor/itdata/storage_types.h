@@ -44,7 +44,16 @@ class QMixed;
 template<typename T>
 class Scalar;
 
-//class ITLazy;
+class ITLazy;
+
+template<typename StoreT>
+class SinglePrec;
+
+template<typename T>
+class MPOSparse;
+
+template<typename T>
+class QMPOSparse;
 
 
 using 
@@ -64,8 +73,16 @@ QDiag<Cplx>,
 QMixed<Real>,
 QMixed<Cplx>,
 Scalar<Real>,
-Scalar<Cplx>
-//ITLazy
+Scalar<Cplx>,
+ITLazy,
+SinglePrec<Dense<Real>>,
+SinglePrec<Dense<Cplx>>,
+SinglePrec<QDense<Real>>,
+SinglePrec<QDense<Cplx>>,
+MPOSparse<Real>,
+MPOSparse<Cplx>,
+QMPOSparse<Real>,
+QMPOSparse<Cplx>
 //-----------
 >;
 
@@ -81,5 +98,8 @@ Scalar<Cplx>
 #include "itensor/itdata/qdiag.h"
 #include "itensor/itdata/qmixed.h"
 #include "itensor/itdata/scalar.h"
-////#include "itensor/itdata/itlazy.h"
+#include "itensor/itdata/itlazy.h"
+#include "itensor/itdata/singleprec.h"
+#include "itensor/itdata/mposparse.h"
+#include "itensor/itdata/qmposparse.h"
 #endif
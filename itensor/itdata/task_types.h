@@ -272,6 +272,31 @@ typeNameOf(TakeReal const&) { return "TakeReal"; }
 inline const char*
 typeNameOf(TakeImag const&) { return "TakeImag"; }
 
+struct ToSingle { };
+struct ToDouble { };
+struct IsSingle { };
+
+inline const char*
+typeNameOf(ToSingle const&) { return "ToSingle"; }
+inline const char*
+typeNameOf(ToDouble const&) { return "ToDouble"; }
+inline const char*
+typeNameOf(IsSingle const&) { return "IsSingle"; }
+
+template<typename IndexT>
+struct ToMPOSparse
+    {
+    IndexSetT<IndexT> const& is;
+    int inpos = -1,
+        outpos = -1;
+    ToMPOSparse(IndexSetT<IndexT> const& is_, int inpos_, int outpos_)
+        : is(is_), inpos(inpos_), outpos(outpos_) { }
+    };
+
+template<typename IndexT>
+const char*
+typeNameOf(ToMPOSparse<IndexT> const&) { return "ToMPOSparse"; }
+
 template<typename IndexT>
 struct PlusEQ
     {
@@ -449,6 +474,20 @@ template<typename I>
 const char*
 typeNameOf(NCProd<I> const&) { return "NCProd"; }
 
+//Read-only access to the contiguous 
+//element data of Dense or QDense storage
+//whose elements are of type T
+template<typename T>
+struct GetData
+    {
+    T const* data = nullptr;
+    size_t size = 0;
+    };
+
+template<typename T>
+const char*
+typeNameOf(GetData<T> const&) { return "GetData"; }
+
 struct StorageType
     {
     enum Type
@@ -465,7 +504,15 @@ struct StorageType
         QDiagReal=9,
         QDiagCplx=10,
         ScalarReal=11,
-        ScalarCplx=12
+        ScalarCplx=12,
+        SingleDenseReal=13,
+        SingleDenseCplx=14,
+        SingleQDenseReal=15,
+        SingleQDenseCplx=16,
+        MPOSparseReal=17,
+        MPOSparseCplx=18,
+        QMPOSparseReal=19,
+        QMPOSparseCplx=20
         }; 
     };
 
@@ -119,9 +119,9 @@ matrixTensor(CMatrix&& M, Index const& i1, Index const& i2)
     ITensor res;
     if(isReal)
         {
-        auto store = vector<Real>(M.size());
+        auto store = DenseReal(M.size());
         for(auto n : range(M.size())) store[n] = M.store()[n].real();
-        res = ITensor({i1,i2},DenseReal{std::move(store)});
+        res = ITensor({i1,i2},std::move(store));
         }
     else
         {
@@ -137,6 +137,24 @@ matrixTensor(CMatrix const& M, const Index& i1, const Index& i2)
     return matrixTensor(CMatrix(M),i1,i2);
     }
 
+ITensor
+sparseLinks(ITensor T, Index const& l1, Index const& l2)
+    {
+    int p1 = -1,
+        p2 = -1;
+    if(l1)
+        {
+        p1 = findindex(T.inds(),l1);
+        if(p1 < 0) Error("sparseLinks: l1 not an index of T");
+        }
+    if(l2)
+        {
+        p2 = findindex(T.inds(),l2);
+        if(p2 < 0) Error("sparseLinks: l2 not an index of T");
+        }
+    if(T.store()) doTask(ToMPOSparse<Index>{T.inds(),p1,p2},T.store());
+    return T;
+    }
 
 ITensor
 combiner(IndexSet const& inds, Args const& args)
@@ -192,4 +210,12 @@ combinedIndex(ITensor const& C)
     return C.inds().front();
     }
 
+ITensor
+lazy(ITensor T)
+    {
+    if(!T || !isDenseStorage(T.store())) return T;
+    auto is = T.inds();
+    return ITensor(std::move(is),ITLazy(T.inds(),T.store()),T.scale());
+    }
+
 } //namespace itensor
@@ -56,6 +56,24 @@ combiner(Index const& i1,
 Index
 combinedIndex(ITensor const& C);
 
+//
+// Defers products with T: in
+//
+//   auto R = lazy(A)*B*C*D;
+//
+// R only records its factors (sharing their
+// storage) and its indices. The factors are
+// contracted when R is first used, pairwise in
+// the order of lowest estimated cost (see
+// contractNetwork), with the last contraction
+// writing directly into R. Factors must have
+// dense storage; a product with any other
+// ITensor (such as a combiner or delta tensor)
+// evaluates the factors collected so far first.
+//
+ITensor
+lazy(ITensor T);
+
 
 //Construct diagonal ITensor with diagonal 
 //elements set to 1.0
@@ -158,6 +176,16 @@ matrixTensor(CMatrix && M, Index const& i1, Index const& i2);
 ITensor
 matrixTensor(CMatrix const& M, Index const& i1, Index const& i2);
 
+//
+// Store T as a matrix over the values of the
+// link indices l1 and l2 (l2 may be omitted)
+// keeping only its non-zero entries, which makes
+// contracting T with dense ITensors cheaper when
+// most entries are zero, as for MPO tensors.
+// Has no effect unless T has Dense storage.
+//
+ITensor
+sparseLinks(ITensor T, Index const& l1, Index const& l2 = Index());
 
 //template<typename... Indxs>
 //TensorRef1
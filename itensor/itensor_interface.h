@@ -500,6 +500,25 @@ template<typename I>
 bool
 isReal(ITensorT<I> const& T);
 
+//Convert dense storage of T (ITensor or IQTensor)
+//to single precision, halving its memory use.
+//Operations other than reading, writing and the
+//norm convert T back to double precision first.
+//Other storage types are left unchanged.
+template<typename I>
+ITensorT<I>
+toSingle(ITensorT<I> T);
+
+//Convert single precision storage of T
+//back to double precision
+template<typename I>
+ITensorT<I>
+toDouble(ITensorT<I> T);
+
+template<typename I>
+bool
+isSingle(ITensorT<I> const& T);
+
 //return number of indices of T
 //(same as order)
 template<typename I>
@@ -520,6 +539,36 @@ template<typename I>
 Real
 norm(ITensorT<I> const& T);
 
+//Set out = sum_k coefs[k]*tensors[k] for
+//k = 0,1,...,coefs.size()-1 (tensors may hold
+//more elements; only the first coefs.size() are used).
+//Index compatibility is checked once; when all tensors
+//have the same dense storage type and index order the
+//result is written in a single pass into freshly
+//allocated storage, without forming scaled temporaries.
+//It is safe for out to also appear in tensors.
+template<typename I>
+void
+linearCombination(std::vector<Real> const& coefs,
+                  std::vector<ITensorT<I>> const& tensors,
+                  ITensorT<I> & out);
+
+template<typename I>
+void
+linearCombination(std::vector<Cplx> const& coefs,
+                  std::vector<ITensorT<I>> const& tensors,
+                  ITensorT<I> & out);
+
+//Convenience form, e.g. linearCombination({1.,dt},{A,B},C)
+template<typename I>
+void
+linearCombination(std::initializer_list<Real> coefs,
+                  std::initializer_list<ITensorT<I>> tensors,
+                  ITensorT<I> & out)
+    {
+    linearCombination(std::vector<Real>(coefs),std::vector<ITensorT<I>>(tensors),out);
+    }
+
 template<typename I>
 void
 randomize(ITensorT<I> & T, Args const& args = Args::global());
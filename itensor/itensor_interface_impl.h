@@ -933,6 +933,29 @@ isReal(ITensorT<I> const& T)
     return not isComplex(T);
     }
 
+template<typename I>
+ITensorT<I>
+toSingle(ITensorT<I> T)
+    {
+    if(T.store()) doTask(ToSingle{},T.store());
+    return T;
+    }
+
+template<typename I>
+ITensorT<I>
+toDouble(ITensorT<I> T)
+    {
+    if(T.store()) doTask(ToDouble{},T.store());
+    return T;
+    }
+
+template<typename I>
+bool
+isSingle(ITensorT<I> const& T)
+    {
+    return T.store() && doTask(IsSingle{},T.store());
+    }
+
 template<typename I>
 long
 rank(ITensorT<I> const& T) { return rank(T.inds()); }
@@ -1237,6 +1260,14 @@ read(std::istream& s)
     else if(type==StorageType::QCombiner) { store_ = readType<QCombiner>(s); }
     else if(type==StorageType::ScalarReal) { store_ = readType<ScalarReal>(s); }
     else if(type==StorageType::ScalarCplx) { store_ = readType<ScalarCplx>(s); }
+    else if(type==StorageType::SingleDenseReal) { store_ = readType<SingleDenseReal>(s); }
+    else if(type==StorageType::SingleDenseCplx) { store_ = readType<SingleDenseCplx>(s); }
+    else if(type==StorageType::SingleQDenseReal) { store_ = readType<SingleQDenseReal>(s); }
+    else if(type==StorageType::SingleQDenseCplx) { store_ = readType<SingleQDenseCplx>(s); }
+    else if(type==StorageType::MPOSparseReal) { store_ = readType<MPOSparseReal>(s); }
+    else if(type==StorageType::MPOSparseCplx) { store_ = readType<MPOSparseCplx>(s); }
+    else if(type==StorageType::QMPOSparseReal) { store_ = readType<QMPOSparseReal>(s); }
+    else if(type==StorageType::QMPOSparseCplx) { store_ = readType<QMPOSparseCplx>(s); }
     else
         {
         Error("Unrecognized type when reading tensor from istream");
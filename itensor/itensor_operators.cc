@@ -334,6 +334,214 @@ operator-=(ITensorT const& R)
 template ITensorT<Index>& ITensorT<Index>::operator-=(const ITensorT& R);
 template ITensorT<IQIndex>& ITensorT<IQIndex>::operator-=(const ITensorT& R);
 
+//Block structure of QDense storage
+struct GetBlocks
+    {
+    std::vector<BlOf> const* offsets = nullptr;
+    };
+
+const char*
+typeNameOf(GetBlocks const&) { return "GetBlocks"; }
+
+template<typename T>
+void
+doTask(GetBlocks & G, QDense<T> const& d) { G.offsets = &d.offsets; }
+
+namespace detail {
+
+//Computes r[i] = sum_k c[k]*d[k][i], working through
+//r in blocks small enough to stay in cache so that
+//each element of r is written to memory only once
+template<typename C, typename T, typename R>
+void
+linCombKernel(std::vector<C> const& c,
+              std::vector<T const*> const& d,
+              R * r,
+              size_t size)
+    {
+    const size_t block = 512;
+    for(size_t b = 0; b < size; b += block)
+        {
+        auto e = std::min(size,b+block);
+        auto c0 = c.front();
+        auto d0 = d.front();
+        for(auto i = b; i < e; ++i) r[i] = c0*d0[i];
+        for(size_t k = 1; k < d.size(); ++k)
+            {
+            auto ck = c[k];
+            auto dk = d[k];
+            for(auto i = b; i < e; ++i) r[i] += ck*dk[i];
+            }
+        }
+    }
+
+template<typename T>
+std::shared_ptr<ITWrap<Dense<T>>>
+allocLike(ITensorT<Index> const& A, size_t size)
+    {
+    return std::make_shared<ITWrap<Dense<T>>>(size);
+    }
+
+template<typename T>
+std::shared_ptr<ITWrap<QDense<T>>>
+allocLike(ITensorT<IQIndex> const& A, size_t size)
+    {
+    auto G = GetBlocks{};
+    doTask(G,A.store());
+    return std::make_shared<ITWrap<QDense<T>>>(*G.offsets,size);
+    }
+
+//True if the data of B can be combined element
+//by element with the data of A, assuming both
+//have the same storage type and index order
+bool
+sameLayout(ITensorT<Index> const& A, ITensorT<Index> const& B) { return true; }
+
+bool
+sameLayout(ITensorT<IQIndex> const& A, ITensorT<IQIndex> const& B)
+    {
+    checkSameDiv(A,B);
+    auto GA = GetBlocks{},
+         GB = GetBlocks{};
+    doTask(GA,A.store());
+    doTask(GB,B.store());
+    auto& oA = *GA.offsets;
+    auto& oB = *GB.offsets;
+    if(oA.size() != oB.size()) return false;
+    for(auto n : range(oA.size()))
+        {
+        if(oA[n].block != oB[n].block || oA[n].offset != oB[n].offset) return false;
+        }
+    return true;
+    }
+
+template<typename T, typename C, typename IndexT>
+void
+fusedLinComb(std::vector<C> const& coefs,
+             std::vector<ITensorT<IndexT>> const& tensors,
+             ITensorT<IndexT> & out)
+    {
+    using R = common_type<C,T>;
+    auto N = coefs.size();
+    auto c = coefs;
+    auto d = std::vector<T const*>(N);
+    size_t size = 0;
+    for(auto k : range(N))
+        {
+        auto G = GetData<T>{};
+        doTask(G,tensors[k].store());
+        if(k > 0 && G.size != size) Error("linearCombination: mismatched storage sizes");
+        d[k] = G.data;
+        size = G.size;
+#ifdef USESCALE
+        c[k] *= tensors[k].scale().real();
+#endif
+        }
+
+    auto nd = allocLike<R>(tensors.front(),size);
+    linCombKernel(c,d,nd->d.data(),size);
+
+    auto is = tensors.front().inds();
+    out = ITensorT<IndexT>(std::move(is),PData(std::move(nd)));
+    }
+
+template<typename C, typename IndexT>
+void
+linCombImpl(std::vector<C> const& coefs,
+            std::vector<ITensorT<IndexT>> const& tensors,
+            ITensorT<IndexT> & out)
+    {
+    auto N = coefs.size();
+    if(N == 0) Error("linearCombination: no coefficients given");
+    if(tensors.size() < N) Error("linearCombination: fewer tensors than coefficients");
+
+    auto& T0 = tensors.front();
+    if(!T0) Error("linearCombination: default constructed tensor");
+    auto type = doTask(StorageType{},T0.store());
+    auto fused = (type == StorageType::DenseReal || type == StorageType::DenseCplx
+                  || type == StorageType::QDenseReal || type == StorageType::QDenseCplx);
+
+    using permutation = typename PlusEQ<IndexT>::permutation;
+    auto P = permutation(T0.r());
+    for(auto k : range(1,N))
+        {
+        auto& Tk = tensors[k];
+        if(!Tk) Error("linearCombination: default constructed tensor");
+        if(Tk.r() != T0.r()) Error("linearCombination: different number of indices");
+        try {
+            calcPerm(Tk.inds(),T0.inds(),P);
+            }
+        catch(std::exception const& e)
+            {
+            println("T0 = ",T0);
+            println("T",k," = ",Tk);
+            Error("linearCombination: different index structure");
+            }
+        if(Global::checkArrows()) detail::checkArrows(T0.inds(),Tk.inds(),true);
+        if(!isTrivial(P) || doTask(StorageType{},Tk.store()) != type) fused = false;
+        else if(fused && !sameLayout(T0,Tk)) fused = false;
+        }
+
+    if(fused)
+        {
+        if(type == StorageType::DenseReal || type == StorageType::QDenseReal)
+            {
+            fusedLinComb<Real>(coefs,tensors,out);
+            }
+        else
+            {
+            fusedLinComb<Cplx>(coefs,tensors,out);
+            }
+        return;
+        }
+
+    //General case: tensors have different index
+    //orders or non-dense storage
+    auto res = coefs.front()*T0;
+    for(auto k : range(1,N))
+        {
+        res += coefs[k]*tensors[k];
+        }
+    out = std::move(res);
+    }
+
+} //namespace detail
+
+template<typename IndexT>
+void
+linearCombination(std::vector<Real> const& coefs,
+                  std::vector<ITensorT<IndexT>> const& tensors,
+                  ITensorT<IndexT> & out)
+    {
+    detail::linCombImpl(coefs,tensors,out);
+    }
+template void linearCombination(std::vector<Real> const&, std::vector<ITensorT<Index>> const&, ITensorT<Index> &);
+template void linearCombination(std::vector<Real> const&, std::vector<ITensorT<IQIndex>> const&, ITensorT<IQIndex> &);
+
+template<typename IndexT>
+void
+linearCombination(std::vector<Cplx> const& coefs,
+                  std::vector<ITensorT<IndexT>> const& tensors,
+                  ITensorT<IndexT> & out)
+    {
+    //Keep real storage real when all 
+    //coefficients happen to be real
+    auto allreal = true;
+    for(auto& z : coefs) if(z.imag() != 0) allreal = false;
+    if(allreal)
+        {
+        auto rcoefs = std::vector<Real>(coefs.size());
+        for(auto k : range(coefs)) rcoefs[k] = coefs[k].real();
+        detail::linCombImpl(rcoefs,tensors,out);
+        }
+    else
+        {
+        detail::linCombImpl(coefs,tensors,out);
+        }
+    }
+template void linearCombination(std::vector<Cplx> const&, std::vector<ITensorT<Index>> const&, ITensorT<Index> &);
+template void linearCombination(std::vector<Cplx> const&, std::vector<ITensorT<IQIndex>> const&, ITensorT<IQIndex> &);
+
 
 
 } //namespace itensor
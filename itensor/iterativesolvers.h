@@ -136,7 +136,9 @@ davidson(BigMatrixT const& A,
     auto eigs = std::vector<Real>(nget,NAN);
 
     V[0] = phi.front();
+    PROFILE_START(davidson_product)
     A.product(V[0],AV[0]);
+    PROFILE_STOP(davidson_product)
 
     auto initEn = ((dag(V[0])*AV[0]).cplx()).real();
 
@@ -176,13 +178,10 @@ davidson(BigMatrixT const& A,
             Mref *= -1;
             D *= -1;
             lambda = D(t);
-            phi_t = U(0,t)*V[0];
-            q     = U(0,t)*AV[0];
-            for(auto k : range1(ii))
-                {
-                phi_t += U(k,t)*V[k];
-                q     += U(k,t)*AV[k];
-                }
+            auto coefs = std::vector<Cplx>(ni);
+            for(auto k : range(ni)) coefs[k] = U(k,t);
+            linearCombination(coefs,V,phi_t);
+            linearCombination(coefs,AV,q);
 
             //Step B of Davidson (1975)
             //Calculate residual q
@@ -351,7 +350,9 @@ davidson(BigMatrixT const& A,
         //Step G of Davidson (1975)
         //Expand AV and M
         //for next step
+        PROFILE_START(davidson_product)
         A.product(V[ni],AV[ni]);
+        PROFILE_STOP(davidson_product)
 
         //Step H of Davidson (1975)
         //Add new row and column to M
@@ -383,11 +384,9 @@ davidson(BigMatrixT const& A,
         eigs.at(j) = D(j);
         auto& phi_j = phi.at(j);
         auto Nr = size_t(nrows(U));
-        phi_j = U(0,j)*V[0];
-        for(auto k : range1(std::min(V.size(),Nr)-1))
-            {
-            phi_j += U(k,j)*V[k];
-            }
+        auto coefs = std::vector<Cplx>(std::min(V.size(),Nr));
+        for(auto k : range(coefs)) coefs[k] = U(k,j);
+        linearCombination(coefs,V,phi_j);
         }
 
     if(debug_level_ >= 4)
@@ -434,8 +433,16 @@ update(Tensor &x, int const k, Matrix const& h, std::vector<T>& s, std::vector<T
             y[j] -= h(j,i) * y[i];
         }
 
+    auto coefs = std::vector<T>(k+2);
+    auto terms = std::vector<Tensor>(k+2);
+    coefs[0] = 1.;
+    terms[0] = x;
     for (int j = 0; j <= k; j++)
-        x += v[j] * y[j];
+        {
+        coefs[j+1] = y[j];
+        terms[j+1] = v[j];
+        }
+    linearCombination(coefs,terms,x);
     }
 
 template<typename T>
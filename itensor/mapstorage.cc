@@ -0,0 +1,148 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <cstdio>
+#include <fstream>
+#include "itensor/mapstorage.h"
+#include "itensor/itdata/dense.h"
+#include "itensor/itdata/qdense.h"
+#include "itensor/util/mapalloc.h"
+
+namespace itensor {
+
+namespace detail {
+
+//Data of Dense or QDense storage
+struct MapData
+    {
+    void const* data = nullptr;
+    size_t size = 0;
+    size_t bytes = 0;
+    std::vector<BlOf> const* offsets = nullptr;
+    };
+
+inline const char*
+typeNameOf(MapData const&) { return "MapData"; }
+
+template<typename T>
+void
+doTask(MapData & M, Dense<T> const& d)
+    {
+    M.data = d.data();
+    M.size = d.size();
+    M.bytes = d.size()*sizeof(T);
+    }
+
+template<typename T>
+void
+doTask(MapData & M, QDense<T> const& d)
+    {
+    M.data = d.data();
+    M.size = d.size();
+    M.bytes = d.size()*sizeof(T);
+    M.offsets = &d.offsets;
+    }
+
+bool
+isMappable(StorageType::Type type)
+    {
+    return type == StorageType::DenseReal || type == StorageType::DenseCplx
+        || type == StorageType::QDenseReal || type == StorageType::QDenseCplx;
+    }
+
+//Storage of size elements holding the data
+//of the file fname+".dat"
+template<typename T>
+std::vector<T,MapAllocator<T>>
+loadData(std::string const& fname,
+         size_t size)
+    {
+    auto store = std::vector<T,MapAllocator<T>>(size);
+    mapLoad(fname+".dat",store.data(),size*sizeof(T));
+    return store;
+    }
+
+} //namespace detail
+
+template<typename I>
+void
+writeMapped(std::string const& fname,
+            ITensorT<I> const& T)
+    {
+    auto type = T.store() ? doTask(StorageType{},T.store()) : StorageType::Null;
+    auto M = detail::MapData{};
+    if(detail::isMappable(type)) doTask(M,T.store());
+
+    std::ofstream s(fname.c_str(),std::ios::binary);
+    if(!s.good()) throw ITError("Couldn't open file \"" + fname + "\" for writing");
+    auto mapped = (M.size > 0);
+    itensor::write(s,mapped);
+    if(!mapped)
+        {
+        T.write(s);
+        std::remove((fname+".dat").c_str());
+        return;
+        }
+    itensor::write(s,T.inds());
+    itensor::write(s,T.scale());
+    itensor::write(s,type);
+    if(M.offsets) itensor::write(s,*M.offsets);
+    itensor::write(s,M.size);
+    s.close();
+    detail::mapSave(M.data,M.bytes,fname+".dat");
+    }
+template void writeMapped(std::string const& fname, ITensorT<Index> const& T);
+template void writeMapped(std::string const& fname, ITensorT<IQIndex> const& T);
+
+template<typename I>
+void
+readMapped(std::string const& fname,
+           ITensorT<I> & T)
+    {
+    std::ifstream s(fname.c_str(),std::ios::binary);
+    if(!s.good()) throw ITError("Couldn't open file \"" + fname + "\" for reading");
+    auto mapped = false;
+    itensor::read(s,mapped);
+    if(!mapped)
+        {
+        T.read(s);
+        return;
+        }
+    auto is = IndexSetT<I>{};
+    itensor::read(s,is);
+    LogNum scale;
+    itensor::read(s,scale);
+    auto type = StorageType::Null;
+    itensor::read(s,type);
+    auto offsets = std::vector<BlOf>{};
+    if(type == StorageType::QDenseReal || type == StorageType::QDenseCplx)
+        {
+        itensor::read(s,offsets);
+        }
+    size_t size = 0;
+    itensor::read(s,size);
+    if(!s.good() || !detail::isMappable(type)) Error(format("readMapped: could not read file %s",fname));
+    s.close();
+
+    if(type == StorageType::DenseReal)
+        {
+        T = ITensorT<I>(std::move(is),DenseReal(detail::loadData<Real>(fname,size)),scale);
+        }
+    else if(type == StorageType::DenseCplx)
+        {
+        T = ITensorT<I>(std::move(is),DenseCplx(detail::loadData<Cplx>(fname,size)),scale);
+        }
+    else if(type == StorageType::QDenseReal)
+        {
+        T = ITensorT<I>(std::move(is),QDenseReal(offsets,detail::loadData<Real>(fname,size)),scale);
+        }
+    else
+        {
+        T = ITensorT<I>(std::move(is),QDenseCplx(offsets,detail::loadData<Cplx>(fname,size)),scale);
+        }
+    }
+template void readMapped(std::string const& fname, ITensorT<Index> & T);
+template void readMapped(std::string const& fname, ITensorT<IQIndex> & T);
+
+} //namespace itensor
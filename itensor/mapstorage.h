@@ -0,0 +1,41 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_MAPSTORAGE_H
+#define __ITENSOR_MAPSTORAGE_H
+
+#include "itensor/iqtensor.h"
+
+namespace itensor {
+
+//
+// Saving tensors as raw data files
+//
+// writeMapped(fname,T) writes the indices and block
+// layout of T to fname, and the data of its Dense or
+// QDense storage, unformatted, to fname+".dat".
+//
+// readMapped(fname,T) reads fname+".dat" straight
+// into new storage for T, so while storage is mapped
+// (see util/mapalloc.h) a large tensor is read into
+// its mapped file without a copy on the heap. The
+// saved files are left in place.
+//
+// Tensors with other storage are written in full to
+// fname, as by writeToFile.
+//
+
+template<typename I>
+void
+writeMapped(std::string const& fname,
+            ITensorT<I> const& T);
+
+template<typename I>
+void
+readMapped(std::string const& fname,
+           ITensorT<I> & T);
+
+} //namespace itensor
+
+#endif
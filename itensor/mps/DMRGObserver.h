@@ -4,18 +4,83 @@
 //
 #ifndef __ITENSOR_DMRGOBSERVER_H
 #define __ITENSOR_DMRGOBSERVER_H
+#include <memory>
+#include <sstream>
 #include "itensor/mps/mps.h"
 #include "itensor/mps/observer.h"
 #include "itensor/spectrum.h"
+#include "itensor/util/threading.h"
+#include "itensor/util/memstats.h"
 
 namespace itensor {
 
+//
+// Expectation value of the operator op on site j,
+// measured using the two-site wavefunction at a bond
+//
+struct SiteMeasurement
+    {
+    std::string op;
+    int site = 0;
+    Cplx value = 0;
+
+    SiteMeasurement() { }
+
+    SiteMeasurement(std::string const& op_, int site_, Cplx value_)
+      : op(op_), site(site_), value(value_)
+        { }
+    };
+
+//
+// Measurements made by a DMRGObserver after
+// the wavefunction at bond b was updated
+//
+struct DMRGMeasurement
+    {
+    int sweep = 0;
+    int halfsweep = 0;
+    int b = 0;
+    Real entropy = 0; //von Neumann entanglement entropy of bond b
+    std::vector<SiteMeasurement> local; //"Ops" on sites b and b+1
+
+    DMRGMeasurement() { }
+    };
+
 //
 // Class for monitoring DMRG calculations.
 // The measure and checkDone methods are virtual
 // so that behavior can be customized in a
 // derived class.
 //
+// After each bond update, measure records the
+// entanglement entropy of the bond and the
+// expectation values of the operators named by
+// the "Ops" argument (e.g. "Ops","Sz,Sx") on the
+// two sites of the bond.
+//
+// If the "Async" argument is true, measure only
+// copies the two site tensors (which shares their
+// storage) and the bond spectrum, and the
+// measurements are evaluated on a background thread
+// while DMRG continues. Results are delivered in
+// order through a queue read by nextMeasurement;
+// the latest values are also available from
+// expect and entropy, which first wait for any
+// pending measurements to finish.
+//
+// Measurements are only kept in the queue if
+// "Async" is true or "Ops" is given, since
+// otherwise nothing reads them; the
+// "QueueMeasurements" argument overrides this.
+// A caller that turns queueing on should drain
+// the queue with nextMeasurement, as it is not
+// bounded.
+//
+// If memory tracking is on (see util/memstats.h,
+// or the "MemStats" argument of dmrg), the live and
+// peak memory of tensor storage are printed after
+// each sweep.
+//
 
 template<class Tensor>
 class DMRGObserver : public Observer
@@ -42,11 +107,48 @@ class DMRGObserver : public Observer
     Spectrum const&
     spectrum() const { return last_spec_; }
 
+    //Removes the oldest measurement from the queue
+    //and stores it in m; returns false if no
+    //measurement has finished yet
+    bool
+    nextMeasurement(DMRGMeasurement & m);
+
+    //Blocks until all pending measurements are done
+    void
+    waitMeasurements();
+
+    //Latest expectation value of op (which must be
+    //one of the "Ops") on site j
+    Cplx
+    expect(std::string const& op, int j);
+
+    //Latest entanglement entropy of bond b
+    Real
+    entropy(int b);
+
     private:
 
+    struct MeasureState
+        {
+        std::mutex mutex;
+        std::deque<DMRGMeasurement> queue;
+        std::vector<std::vector<Cplx>> latest; //latest[j][n] = <ops_[n]> on site j
+        std::vector<Real> entropy;
+        //Declared last so it is destroyed (and
+        //its pending jobs run) before the data above
+        BackgroundWorker worker;
+        };
+
+    static void
+    record(MeasureState & ms, DMRGMeasurement m, bool queue);
+
     /////////////
 
     MPSt<Tensor> const& psi_;
+    std::vector<std::string> ops_;
+    bool async_;
+    bool queue_;
+    std::shared_ptr<MeasureState> mstate_;
     Real energy_errgoal; //Stop DMRG once energy has converged to this precision
     bool printeigs;      //Print slowest decaying eigenvalues after every sweep
     int max_eigs;
@@ -64,16 +166,69 @@ inline DMRGObserver<Tensor>::
 DMRGObserver(MPSt<Tensor> const& psi, Args const& args) 
     : 
     psi_(psi),
+    async_(args.getBool("Async",false)),
+    queue_(false),
+    mstate_(std::make_shared<MeasureState>()),
     energy_errgoal(args.getReal("EnergyErrgoal",-1)), 
     printeigs(args.getBool("PrintEigs",true)),
     max_eigs(-1),
     max_te(-1),
     done_(false),
     last_energy_(1000)
-    //default_ops_(psi.sites().defaultOps())
     { 
+    auto opstr = args.getString("Ops","");
+    for(auto& c : opstr) if(c == ',') c = ' ';
+    std::istringstream ss(opstr);
+    std::string op;
+    while(ss >> op) ops_.push_back(op);
+    queue_ = args.getBool("QueueMeasurements",async_ || !ops_.empty());
+    mstate_->entropy.assign(psi.N(),0.);
+    mstate_->latest.assign(psi.N()+1,std::vector<Cplx>(ops_.size(),0.));
+    }
+
+namespace detail {
+
+bool inline
+zeroFlux(ITensor const& op) { return true; }
+
+bool inline
+zeroFlux(IQTensor const& op) { return div(op) == QN(); }
+
+template<typename Tensor>
+void
+measureBond(DMRGMeasurement & m,
+            Tensor const& A1,
+            Tensor const& A2,
+            std::vector<std::string> const& opnames,
+            std::vector<Tensor> const& ops,
+            Spectrum const& spec)
+    {
+    using IndexT = typename Tensor::index_type;
+    for(auto p : spec.eigsKept())
+        {
+        if(p > 1E-13) m.entropy -= p*log(p);
+        }
+    if(ops.empty()) return;
+
+    auto wfb = A1*A2;
+    auto nrm2 = sqr(norm(wfb));
+    auto nop = opnames.size();
+    for(auto n : range(ops))
+        {
+        auto j = m.b+int(n/nop);
+        auto& op = ops[n];
+        auto z = Cplx(0.);
+        if(zeroFlux(op))
+            {
+            auto s = noprime(findtype(op,Site));
+            z = (dag(prime(wfb,IndexT(s)))*op*wfb).cplx()/nrm2;
+            }
+        m.local.emplace_back(opnames[n%nop],j,z);
+        }
     }
 
+} //namespace detail
+
 template<class Tensor>
 void inline DMRGObserver<Tensor>::
 measure(Args const& args)
@@ -85,21 +240,40 @@ measure(Args const& args)
     auto ha = args.getInt("HalfSweep",0);
     auto energy = args.getReal("Energy",0);
 
-    if(!args.getBool("Quiet",false) && !args.getBool("NoMeasure",false))
+    if(!args.getBool("NoMeasure",false) && b < N && b > 0)
         {
-        if(b < N && b > 0)
+        auto m = DMRGMeasurement();
+        m.sweep = sw;
+        m.halfsweep = ha;
+        m.b = b;
+        auto A1 = psi_.A(b),
+             A2 = psi_.A(b+1);
+        auto ops = std::vector<Tensor>();
+        ops.reserve(2*ops_.size());
+        for(auto j : {b,b+1})
+        for(auto& name : ops_)
+            {
+            ops.push_back(Tensor(psi_.sites().op(name,j)));
+            }
+        if(async_)
+            {
+            auto* ms = mstate_.get();
+            auto opnames = ops_;
+            auto spec = last_spec_;
+            auto queue = queue_;
+            //Capture copies: psi's tensors may be
+            //replaced while the job is running
+            ms->worker.push([ms,m,A1,A2,opnames,ops,spec,queue]()
+                {
+                auto res = m;
+                detail::measureBond(res,A1,A2,opnames,ops,spec);
+                record(*ms,std::move(res),queue);
+                });
+            }
+        else
             {
-            auto wfb = psi_.A(b)*psi_.A(b+1);
-            //for(const std::string& opname : default_ops_)
-            //    {
-            //    auto sb = IndexT(psi_.sites()(b));
-            //    auto z = (dag(prime(wfb,sb))*psi_.sites().op(opname,b)*wfb).cplx();
-            //    //auto z = (prime(wfb,psi_.sites()(b))*psi_.sites().op(opname,b)*wfb).cplx();
-            //    if(std::fabs(z.imag()) < 1E-14)
-            //        printfln("<%s>(%d) = %.10E",opname,b,z.real());
-            //    else
-            //        printfln("<%s>(%d) = (%.10E,%.10E)",opname,b,z.real(),z.imag());
-            //    }
+            detail::measureBond(m,A1,A2,ops_,ops,last_spec_);
+            record(*mstate_,std::move(m),queue_);
             }
         }
 
@@ -140,10 +314,78 @@ measure(Args const& args)
         println("    Largest truncation error: ",(max_te > 0 ? max_te : 0.));
         max_te = -1;
         printfln("    Energy after sweep %s is %.12f",swstr,energy);
+        if(memTracking())
+            {
+            auto MB = [](long long bytes) { return bytes/(1024.*1024.); };
+            auto M = memStats();
+            printfln("    Tensor memory: live = %.3f MB, peak during sweep = %.3f MB",
+                     MB(M.total.live),MB(M.total.peak));
+            printfln("      peak environments = %.3f MB, wavefunction = %.3f MB, temporaries = %.3f MB",
+                     MB(M.category(MemCategory::Environment).peak),
+                     MB(M.category(MemCategory::Wavefunction).peak),
+                     MB(M.category(MemCategory::Temporary).peak));
+            }
+        }
+
+    }
+
+template<class Tensor>
+void DMRGObserver<Tensor>::
+record(MeasureState & ms, DMRGMeasurement m, bool queue)
+    {
+    std::lock_guard<std::mutex> lock(ms.mutex);
+    ms.entropy.at(m.b) = m.entropy;
+    for(auto n : range(m.local))
+        {
+        auto& sm = m.local[n];
+        auto& row = ms.latest.at(sm.site);
+        row.at(n%row.size()) = sm.value;
         }
+    if(queue) ms.queue.push_back(std::move(m));
+    }
+
+template<class Tensor>
+bool DMRGObserver<Tensor>::
+nextMeasurement(DMRGMeasurement & m)
+    {
+    auto& ms = *mstate_;
+    std::lock_guard<std::mutex> lock(ms.mutex);
+    if(ms.queue.empty()) return false;
+    m = std::move(ms.queue.front());
+    ms.queue.pop_front();
+    return true;
+    }
+
+template<class Tensor>
+void DMRGObserver<Tensor>::
+waitMeasurements()
+    {
+    mstate_->worker.wait();
+    }
 
+template<class Tensor>
+Cplx DMRGObserver<Tensor>::
+expect(std::string const& op, int j)
+    {
+    waitMeasurements();
+    auto it = std::find(ops_.begin(),ops_.end(),op);
+    if(it == ops_.end()) Error(format("DMRGObserver: operator %s is not one of the \"Ops\"",op));
+    auto& ms = *mstate_;
+    std::lock_guard<std::mutex> lock(ms.mutex);
+    if(j < 1 || size_t(j) >= ms.latest.size()) Error("DMRGObserver: site not measured");
+    return ms.latest[j][it-ops_.begin()];
     }
 
+template<class Tensor>
+Real DMRGObserver<Tensor>::
+entropy(int b)
+    {
+    waitMeasurements();
+    auto& ms = *mstate_;
+    std::lock_guard<std::mutex> lock(ms.mutex);
+    if(b < 1 || size_t(b) >= ms.entropy.size()) Error("DMRGObserver: bond not measured");
+    return ms.entropy[b];
+    }
 
 template<class Tensor>
 bool inline DMRGObserver<Tensor>::
@@ -7,6 +7,7 @@
 #include "itensor/util/print_macro.h"
 #include "itensor/mps/autompo.h"
 #include "itensor/tensor/algs.h"
+#include "itensor/util/threading.h"
 
 using std::find;
 using std::cout;
@@ -108,7 +109,7 @@ isFermionic(SiteTermProd const& sprod)
     }
 
 string
-fermionicTerm(const string& op)
+fermionicTerm(string const& op)
     {
     static array<pair<string,string>,6>
            rewrites =
@@ -360,23 +361,51 @@ operator,(const string& op_)
     return *this;
     }
 
+size_t
+hashOps(SiteTermProd const& ops)
+    {
+    size_t h = ops.size();
+    for(auto& st : ops)
+        {
+        //Combine as in boost::hash_combine
+        h ^= std::hash<size_t>()(st.op.id()) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int>()(st.i) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+    return h;
+    }
+
 void AutoMPO::
 add(HTerm const& t)
     {
     if(abs(t.coef) == 0.0) return;
 
-    auto it = terms_.find(t);
-    if(it == terms_.end())
-        {
-        terms_.insert(move(t));
-        }
-    else //found duplicate
+    auto h = hashOps(t.ops);
+    auto range = index_.equal_range(h);
+    for(auto it = range.first; it != range.second; ++it)
         {
-        auto nt = t;
-        nt.coef += it->coef;
-        terms_.erase(it);
-        terms_.insert(move(nt));
+        auto& et = terms_[it->second];
+        if(et.ops == t.ops) //found duplicate
+            {
+            et.coef += t.coef;
+            return;
+            }
         }
+    index_.emplace(h,terms_.size());
+    terms_.push_back(t);
+    }
+
+void AutoMPO::
+add(std::vector<HTerm> const& terms)
+    {
+    reserve(terms_.size()+terms.size());
+    for(auto& t : terms) add(t);
+    }
+
+void AutoMPO::
+reserve(size_t n)
+    {
+    terms_.reserve(n);
+    index_.reserve(n);
     }
 
 /*
@@ -987,44 +1016,32 @@ partitionHTerms(SiteSet const& sites,
     {
     auto N = sites.N();
 
-    // TODO: This version of calcQN uses a "qnmap" to improve
-    //       the speed.
-    //       The qnmap keys are just strings, which assumes
-    //       all operators with the same name have the same
-    //       QN divergence. This wouldn't be true e.g. for
-    //       a spin model with different spin sizes at 
-    //       different sites.
-    //
-    //auto qnmap = map<string,QN>();
-    //auto calcQN = [&qnmap,&sites](SiteTermProd const& prod)
-    //    {
-    //    QN qn;
-    //    for(auto& st : prod)
-    //        {
-    //        auto it = qnmap.find(st.op);
-    //        if(it != qnmap.end())
-    //            {
-    //            qn += it->second;
-    //            }
-    //        else
-    //            {
-    //            auto Op = sites.op(st.op,st.i);
-    //            auto OpQN = -div(Op);
-    //            qnmap[st.op] = OpQN;
-    //            qn += OpQN;
-    //            }
-    //        }
-    //    return qn;
-    //    };
-
-    auto calcQN = [&sites](SiteTermProd const& prod)
+    //The QN divergence of each (site,operator) pair
+    //is computed once using sites.op and cached.
+    //The key includes the site since operators
+    //with the same name can differ from site to site
+    //(e.g. for a mixture of spin sizes)
+    struct SiteTermHash
+        {
+        size_t
+        operator()(SiteTerm const& st) const 
+            { 
+            return std::hash<size_t>()(st.op.id()) ^ (std::hash<int>()(st.i) << 1);
+            }
+        };
+    auto qnmap = std::unordered_map<SiteTerm,QN,SiteTermHash>();
+    auto calcQN = [&qnmap,&sites](SiteTermProd const& prod)
         {
         QN qn;
         for(auto& st : prod)
             {
-            auto Op = sites.op(st.op,st.i);
-            auto OpQN = -div(Op);
-            qn += OpQN;
+            auto it = qnmap.find(st);
+            if(it == qnmap.end())
+                {
+                auto Op = sites.op(st.op,st.i);
+                it = qnmap.emplace(st,-div(Op)).first;
+                }
+            qn += it->second;
             }
         return qn;
         };
@@ -1038,16 +1055,16 @@ partitionHTerms(SiteSet const& sites,
         SiteTermProd left, onsite, right;
         decomposeTerm(n, ht.ops, left, onsite, right);
         
-        TIMER_START(10)
+        PROFILE_START(autompo_qns)
         QN lqn,sqn;
         if(checkqns)
             {
             lqn = calcQN(left);
             sqn = calcQN(onsite);
             }
-        TIMER_STOP(10)
+        PROFILE_STOP(autompo_qns)
         
-        TIMER_START(11)
+        PROFILE_START(autompo_blocks)
         int j=-1,k=-1;
 
         // qbs.at(i) are the blocks at the link between sites i+1 and i+2
@@ -1090,13 +1107,13 @@ partitionHTerms(SiteSet const& sites,
             {
             rewriteFermionic(onsite, leftF);
             }
-        TIMER_STOP(11)
+        PROFILE_STOP(autompo_blocks)
         
         //
         // Add only unique IQMPOMatElems to tempMPO
         // TODO: assumes terms are unique I think!
         // 
-        TIMER_START(12)
+        PROFILE_START(autompo_unique)
         auto& tn = tempMPO.at(n-1);
         auto el = IQMPOMatElem(lqn, lqn+sqn, j, k, HTerm(c, onsite));
 
@@ -1116,7 +1133,7 @@ partitionHTerms(SiteSet const& sites,
         auto it = tn.find(el);
         if(it == tn.end()) tn.insert(move(el));
 
-        TIMER_STOP(12)
+        PROFILE_STOP(autompo_unique)
         }
     }
 
@@ -1137,6 +1154,135 @@ operator<(QNProd const& p1, QNProd const& p2)
 template<typename T>
 using MPOPiece = map<QNProd,Mat<T>>;
 
+//
+// Computes the truncated right singular vectors V of
+// the sparse matrix with elements els, equivalent to
+// calling SVD(toMatrix(els),U,D,V) then truncating. 
+//
+// Rows and columns are first grouped into independent
+// sets (connected components of the graph linking row r 
+// and column c when element (r,c) is non-zero), which 
+// makes the matrix block diagonal up to a permutation.
+// Only these blocks, usually very small, are decomposed, 
+// and the truncation is done on the singular values of
+// all blocks together.
+//
+template<typename T>
+Mat<T>
+sparseTruncatedV(vector<MatElem<T>> const& els,
+                 long maxm,
+                 long minm,
+                 Real cutoff)
+    {
+    long nr = 0, nc = 0;
+    for(auto& el : els)
+        {
+        nr = max(nr,1l+el.ind.row);
+        nc = max(nc,1l+el.ind.col);
+        }
+
+    //Union-find over nodes 0..nr-1 (rows) and nr..nr+nc-1 (columns)
+    auto parent = vector<long>(nr+nc);
+    for(auto n : range(parent)) parent[n] = n;
+    auto root = [&parent](long n)
+        {
+        while(parent[n] != n) 
+            {
+            parent[n] = parent[parent[n]];
+            n = parent[n];
+            }
+        return n;
+        };
+    for(auto& el : els)
+        {
+        if(el.val == T(0)) continue;
+        auto a = root(el.ind.row),
+             b = root(nr+el.ind.col);
+        if(a != b) parent[b] = a;
+        }
+
+    //Assign local row and column numbers within each component
+    auto comp = vector<long>(nr+nc,-1);
+    auto local = vector<long>(nr+nc,-1);
+    auto crows = vector<vector<long>>();
+    auto ccols = vector<vector<long>>();
+    for(auto& el : els)
+        {
+        if(el.val == T(0)) continue;
+        auto c = root(el.ind.row);
+        if(comp[c] == -1)
+            {
+            comp[c] = crows.size();
+            crows.emplace_back();
+            ccols.emplace_back();
+            }
+        auto nb = comp[c];
+        auto r = el.ind.row,
+             k = nr+el.ind.col;
+        if(local[r] == -1) { local[r] = crows[nb].size(); crows[nb].push_back(r); }
+        if(local[k] == -1) { local[k] = ccols[nb].size(); ccols[nb].push_back(el.ind.col); }
+        }
+
+    auto ncomp = crows.size();
+    auto blocks = vector<Mat<T>>(ncomp);
+    for(auto nb : range(ncomp)) blocks[nb] = Mat<T>(crows[nb].size(),ccols[nb].size());
+    for(auto& el : els)
+        {
+        if(el.val == T(0)) continue;
+        auto nb = comp[root(el.ind.row)];
+        blocks[nb](local[el.ind.row],local[nr+el.ind.col]) += el.val;
+        }
+
+    struct SingVal
+        {
+        Real p = 0;
+        long block = 0,
+             n = 0;
+        };
+    auto svals = vector<SingVal>();
+    auto Vs = vector<Mat<T>>(ncomp);
+    for(auto nb : range(ncomp))
+        {
+        Mat<T> U;
+        Vector D;
+        SVD(blocks[nb],U,D,Vs[nb]);
+        for(auto n : range(D.size())) 
+            {
+            auto sv = SingVal();
+            sv.p = sqr(D(n));
+            sv.block = nb;
+            sv.n = n;
+            svals.push_back(sv);
+            }
+        }
+    std::stable_sort(svals.begin(),svals.end(),
+                     [](SingVal const& a, SingVal const& b) { return a.p > b.p; });
+
+    auto V = Mat<T>(nc,1);
+    if(svals.empty()) 
+        {
+        //Same as dense SVD of a zero matrix
+        //truncated to a single vector
+        if(nc > 0) V(0,0) = 1.;
+        return V;
+        }
+
+    auto P = Vector(svals.size());
+    for(auto n : range(svals)) P(n) = svals[n].p;
+    truncate(P,maxm,minm,cutoff);
+    long m = P.size();
+
+    V = Mat<T>(nc,m);
+    for(auto i : range(m))
+        {
+        auto& sv = svals[i];
+        auto& Vb = Vs[sv.block];
+        auto& cols = ccols[sv.block];
+        for(auto lc : range(cols)) V(cols[lc],i) = Vb(lc,sv.n);
+        }
+    return V;
+    }
+
 // SVD the coefficients matrix on each link and construct the compressed MPO matrix
 template<typename T>
 void
@@ -1155,6 +1301,7 @@ compressMPO(SiteSet const& sites,
     int minm = args.getInt("Minm",1);
     int maxm = args.getInt("Maxm",5000);
     Real cutoff = args.getReal("Cutoff",1E-13);
+    auto nthread = getNThread(args);
     //printfln("Using cutoff = %.2E",cutoff);
     //printfln("Using minm = %d",minm);
     //printfln("Using maxm = %d",maxm);
@@ -1181,29 +1328,21 @@ compressMPO(SiteSet const& sites,
 
         int nsector = 1; //always have ZeroQN sector
 
+        //Create entries of V_npp up front so the
+        //QN blocks can be decomposed concurrently
+        auto todo = vector<pair<Block<T> const*,Mat<T>*>>();
         for(auto& qb : qbs.at(n-1) )
             {
             auto& qn = qb.first;
             if(qn != ZeroQN) ++nsector;
-
-            // Convert the block matrix elements to a dense matrix
-            auto M = toMatrix(qb.second.mat);
-
-            auto& V = V_npp[qn];
-
-            Mat<T> U;
-            Vector D;
-            SVD(M,U,D,V);
-
-            //square singular vals for call to truncate
-            for(auto& d : D) d = sqr(d);
-            truncate(D,maxm,minm,cutoff);
-            int m = D.size();
-
-            int nc = ncols(M);
-            resize(V,nc,m);
+            todo.emplace_back(&qb.second,&V_npp[qn]);
             }
 
+        parallelFor(todo.size(),nthread,[&todo,maxm,minm,cutoff](size_t b)
+            {
+            *todo[b].second = sparseTruncatedV(todo[b].first->mat,maxm,minm,cutoff);
+            });
+
         int count = 0;
         auto inqn = stdx::reserve_vector<IndexQN>(nsector);
         // Make sure zero QN is first in the list of indices
@@ -1469,17 +1608,19 @@ toMPO(AutoMPO const& am,
 //    }
 
 
-template<typename Tensor>
-MPOt<Tensor>
-toExpH_ZW1(const AutoMPO& am,
-           Complex tau,
-           const Args& args)
+//Bond "basis" states and link indices shared by the
+//toExpH approximations: on each bond, the state "IL"
+//(no operator string open, or the completed terms to
+//the left) and one state per first operator of the
+//operator strings crossing the bond
+template<typename IndexT>
+void
+expHLinks(AutoMPO const& am,
+          bool checkqn,
+          vector<vector<SiteQN>> & basis,
+          vector<IndexT> & links)
     {
-    using IndexT = typename Tensor::index_type;
-    auto checkqn = args.getBool("CheckQN",true);
-
     auto const& sites = am.sites();
-    auto H = MPOt<Tensor>(sites);
     const int N = sites.N();
 
     const QN Zero;
@@ -1496,7 +1637,7 @@ toExpH_ZW1(const AutoMPO& am,
     //for the left-hand side of the system
     SiteTerm IL("IL",0);
 
-    vector<vector<SiteQN>> basis(N+1);
+    basis.assign(N+1,vector<SiteQN>());
     for(int n = 0; n <= N; ++n)
         basis.at(n).emplace_back(IL,QN());
 
@@ -1537,7 +1678,7 @@ toExpH_ZW1(const AutoMPO& am,
         for(auto& bn : basis) std::sort(bn.begin(),bn.end(),qn_comp);
         }
 
-    auto links = vector<IndexT>(N+1);
+    links.resize(N+1);
     vector<IndexQN> inqn;
     for(int n = 0; n <= N; n++)
         {
@@ -1571,6 +1712,26 @@ toExpH_ZW1(const AutoMPO& am,
         //    printfln("IQIndex for site %d:\n%s",n,links.at(n));
         //    }
         }
+    }
+
+template<typename Tensor>
+MPOt<Tensor>
+toExpH_ZW1(const AutoMPO& am,
+           Complex tau,
+           const Args& args)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto checkqn = args.getBool("CheckQN",true);
+
+    auto const& sites = am.sites();
+    auto H = MPOt<Tensor>(sites);
+    const int N = sites.N();
+
+    SiteTerm IL("IL",0);
+
+    auto basis = vector<vector<SiteQN>>();
+    auto links = vector<IndexT>();
+    expHLinks(am,checkqn,basis,links);
 
     //Create arrays indexed by lattice sites.
     //For lattice site "j", ht_by_n[j] contains
@@ -1658,23 +1819,260 @@ toExpH_ZW1(const AutoMPO& am,
     return H;
     }
 
-template<>
-IQMPO
-toExpH<IQTensor>(const AutoMPO& a,
-         Complex tau,
-         const Args& args)
+//Exponential of a general square matrix
+//by scaling and squaring of its Taylor series
+CMatrix
+expMatrix(CMatrix M)
+    {
+    auto n = nrows(M);
+    int nsquare = 0;
+    for(auto nrm = norm(M); nrm > 0.5; nrm /= 2.) ++nsquare;
+    makeRef(M) *= std::pow(2.,-nsquare);
+
+    auto E = CMatrix(n,n);
+    for(auto j : range(n)) E(j,j) = 1.;
+    auto T = E;
+    for(int k = 1; k <= 30; ++k)
+        {
+        T = T*M;
+        makeRef(T) *= 1./k;
+        makeRef(E) += makeRefc(T);
+        if(norm(T) < 1E-17*norm(E)) break;
+        }
+    for(int k = 0; k < nsquare; ++k) E = E*E;
+    return E;
+    }
+
+//Matrix elements M(j,i) = fac*<j|op|i> of a site operator
+CMatrix
+opMatrix(IQTensor const& op,
+         Index const& s,
+         Cplx fac = 1.)
+    {
+    auto d = s.m();
+    auto M = CMatrix(d,d);
+    auto T = toITensor(op);
+    for(auto i : range1(d))
+    for(auto j : range1(d))
+        {
+        M(j-1,i-1) = fac*T.cplx(s(i),prime(s)(j));
+        }
+    return M;
+    }
+
+//Site operator with elements <j|op|i> = M(j,i),
+//or a null tensor if all elements are zero
+template<typename Tensor>
+Tensor
+matrixOp(CMatrixRefc const& M,
+         IQIndex const& s)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto sd = IndexT(dag(s)),
+         sp = IndexT(prime(s));
+    auto op = Tensor(sd,sp);
+    auto zero = true;
+    for(auto i : range1(s.m()))
+    for(auto j : range1(s.m()))
+        {
+        auto z = M(j-1,i-1);
+        if(z == Cplx(0.)) continue;
+        if(z.imag() != 0) op.set(sd(i),sp(j),z);
+        else              op.set(sd(i),sp(j),z.real());
+        zero = false;
+        }
+    return zero ? Tensor() : op;
+    }
+
+//
+// The W^II approximation of Zaletel et al., PRB 91, 165112 (2015).
+//
+// Writing the MPO of -tau*H on site n in terms of its blocks
+//   D   : on-site terms (from IL to IL)
+//   C_b : starting an operator string (IL to channel b)
+//   B_a : ending an operator string (channel a to IL)
+//   A_ab: continuing an operator string (channel a to b)
+// each element W_ab is the matrix element of
+//   exp(D + C_b y_b^+ + B_a x_a^- + A_ab x_a^- y_b^+)
+// between the state with channel a occupied and the state
+// with channel b occupied, where x_a and y_b are auxiliary
+// two-level systems. Compared to W^I (toExpH_ZW1), W^II is
+// exact for all products of terms overlapping on a single
+// site, and has the same bond dimension.
+//
+template<typename Tensor>
+MPOt<Tensor>
+toExpH_ZW2(AutoMPO const& am,
+           Complex tau,
+           Args const& args)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto checkqn = args.getBool("CheckQN",true);
+
+    auto const& sites = am.sites();
+    auto H = MPOt<Tensor>(sites);
+    const int N = sites.N();
+
+    SiteTerm IL("IL",0);
+
+    auto basis = vector<vector<SiteQN>>();
+    auto links = vector<IndexT>();
+    expHLinks(am,checkqn,basis,links);
+
+    vector<vector<HTerm>> ht_by_n(N+1);
+    for(const HTerm& ht : am.terms()) 
+    for(const auto& st : ht.ops)
+        {
+        ht_by_n.at(st.i).push_back(ht);
+        }
+
+    for(int n = 1; n <= N; n++)
+        {
+        auto& bn1 = basis.at(n-1);
+        auto& bn  = basis.at(n);
+        auto s = sites(n);
+        auto d = s.m();
+
+        auto& W = H.Aref(n);
+        auto &row = links.at(n-1),
+             &col = links.at(n);
+
+        W = Tensor(dag(s),prime(s),dag(row),col);
+
+        auto D = CMatrix(d,d);
+        for(const auto& ht : ht_by_n.at(n))
+        if(ht.first().i == ht.last().i)
+            {
+            makeRef(D) += opMatrix(sites.op(ht.first().op,n),s,-tau*ht.coef);
+            }
+
+        //C_c: starting strings, B_r: ending strings,
+        //A_r: strings passing through site n
+        auto C = vector<CMatrix>(col.m()),
+             B = vector<CMatrix>(row.m()),
+             A = vector<CMatrix>(row.m());
+        for(auto c : range(col.m()))
+            {
+            auto& cst = bn.at(c).st;
+            if(cst.i == n) C.at(c) = opMatrix(sites.op(startTerm(cst.op),n),s,-tau);
+            }
+        for(auto r : range(row.m()))
+            {
+            auto& rst = bn1.at(r).st;
+            if(rst == IL) continue;
+            auto Br = CMatrix(d,d);
+            auto ends = false;
+            for(const auto& ht : ht_by_n.at(n))
+            if(rst == ht.first() && ht.last().i == n)
+                {
+                makeRef(Br) += opMatrix(sites.op(endTerm(ht.last().op),n),s,ht.coef);
+                ends = true;
+                }
+            if(ends) B.at(r) = std::move(Br);
+            auto crosses = std::find_if(bn.begin(),bn.end(),[&rst](SiteQN const& sq) { return sq.st == rst; });
+            if(crosses != bn.end())
+                {
+                A.at(r) = opMatrix(sites.op(isFermionic(rst) ? "F" : "Id",n),s);
+                }
+            }
+
+        //Exponential of the operator h on site n times the
+        //auxiliary states, returning the block connecting
+        //the first (input) and last (output) auxiliary states
+        auto expBlock = [d](std::vector<std::pair<int,int>> const& blocks,
+                            std::vector<CMatrix const*> const& ops,
+                            CMatrix const& D,
+                            int naux)
+            {
+            auto h = CMatrix(naux*d,naux*d);
+            for(auto a : range(naux)) subMatrix(h,a*d,(a+1)*d,a*d,(a+1)*d) &= D;
+            for(auto k : range(blocks))
+                {
+                auto to = blocks[k].first,
+                     from = blocks[k].second;
+                subMatrix(h,to*d,(to+1)*d,from*d,(from+1)*d) &= *ops[k];
+                }
+            auto e = expMatrix(std::move(h));
+            return CMatrix(subMatrix(e,(naux-1)*d,naux*d,0,d));
+            };
+
+        const CMatrix none;
+        for(auto r : range(row.m()))
+        for(auto c : range(col.m()))
+            {
+            auto& rst = bn1.at(r).st;
+            auto& cst = bn.at(c).st;
+            auto& Cc = C.at(c);
+            auto& Br = B.at(r);
+            auto& Ar = (rst == cst) ? A.at(r) : none;
+            CMatrix w;
+            if(rst == IL && cst == IL)
+                {
+                w = expMatrix(D);
+                }
+            else if(rst == IL)
+                {
+                //Auxiliary states: 0 -> y_c
+                if(!Cc) continue;
+                w = expBlock({{1,0}},{&Cc},D,2);
+                }
+            else if(cst == IL)
+                {
+                //Auxiliary states: x_r -> 0
+                if(!Br) continue;
+                w = expBlock({{1,0}},{&Br},D,2);
+                }
+            else
+                {
+                //Auxiliary states: x_r, 0, x_r y_c, y_c
+                if(!Ar && !(Br && Cc)) continue;
+                auto blocks = std::vector<std::pair<int,int>>();
+                auto ops = std::vector<CMatrix const*>();
+                if(Br) { blocks.push_back({1,0}); ops.push_back(&Br); 
+                         blocks.push_back({3,2}); ops.push_back(&Br); }
+                if(Cc) { blocks.push_back({2,0}); ops.push_back(&Cc); 
+                         blocks.push_back({3,1}); ops.push_back(&Cc); }
+                if(Ar) { blocks.push_back({3,0}); ops.push_back(&Ar); }
+                w = expBlock(blocks,ops,D,4);
+                }
+            auto op = matrixOp<Tensor>(w,s);
+            if(!op) continue;
+            W += op * setElt(dag(row)(r+1)) * setElt(col(c+1));
+            }
+        }
+
+    H.Aref(1) *= setElt(links.at(0)(1));
+    H.Aref(N) *= setElt(dag(links.at(N))(1));
+
+    return H;
+    }
+
+template<typename Tensor>
+MPOt<Tensor>
+toExpHApprox(AutoMPO const& a,
+             Complex tau,
+             Args const& args)
     {
     auto approx = args.getString("Approx","ZW1");
-    IQMPO res;
     if(approx == "ZW1")
         {
-        res = toExpH_ZW1<IQTensor>(a,tau,args);
+        return toExpH_ZW1<Tensor>(a,tau,args);
         }
-    else
+    else if(approx == "ZW2")
         {
-        Error(format("Unknown approximation Approx=\"%s\"",approx));
+        return toExpH_ZW2<Tensor>(a,tau,args);
         }
-    return res;
+    Error(format("Unknown approximation Approx=\"%s\"",approx));
+    return MPOt<Tensor>();
+    }
+
+template<>
+IQMPO
+toExpH<IQTensor>(const AutoMPO& a,
+         Complex tau,
+         const Args& args)
+    {
+    return toExpHApprox<IQTensor>(a,tau,args);
     }
 
 template<>
@@ -1683,18 +2081,38 @@ toExpH<ITensor>(const AutoMPO& a,
                 Complex tau,
                 const Args& args)
     {
-    auto approx = args.getString("Approx","ZW1");
-    MPO res;
-    if(approx == "ZW1")
+    return toExpHApprox<ITensor>(a,tau,{args,"CheckQN",false});
+    }
+
+template<typename Tensor>
+vector<MPOt<Tensor>>
+toExpHSteps(AutoMPO const& a,
+            Complex tau,
+            Args const& args)
+    {
+    auto order = args.getInt("Order",1);
+    auto res = vector<MPOt<Tensor>>();
+    if(order == 1)
+        {
+        res.push_back(toExpH<Tensor>(a,tau,args));
+        }
+    else if(order == 2)
         {
-        res = toExpH_ZW1<ITensor>(a,tau,{args,"CheckQN",false});
+        //tau1+tau2 = tau and tau1^2+tau2^2 = 0, cancelling
+        //the leading error of the first-order approximations
+        auto tau1 = 0.5*Cplx(1.,1.)*tau,
+             tau2 = 0.5*Cplx(1.,-1.)*tau;
+        res.push_back(toExpH<Tensor>(a,tau1,args));
+        res.push_back(toExpH<Tensor>(a,tau2,args));
         }
     else
         {
-        Error(format("Unknown approximation Approx=\"%s\"",approx));
+        Error(format("toExpHSteps: Order=%d not supported",order));
         }
     return res;
     }
+template vector<MPO> toExpHSteps(AutoMPO const& a, Complex tau, Args const& args);
+template vector<IQMPO> toExpHSteps(AutoMPO const& a, Complex tau, Args const& args);
 
 std::ostream& 
 operator<<(std::ostream& s, SiteTerm const& t)
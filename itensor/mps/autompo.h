@@ -8,6 +8,7 @@
 #include "itensor/global.h"
 #include "itensor/mps/mpo.h"
 #include <set>
+#include <unordered_map>
 
 namespace itensor {
 
@@ -34,6 +35,9 @@ toMPO(AutoMPO const& a,
 // Arguments recognized:
 // o "Approx":
 //   - (Default) "ZW1" - Zaletel et al. "W1" approximation
+//   - "ZW2" - Zaletel et al. "W2" approximation, exact for
+//     products of terms overlapping on one site; same bond
+//     dimension as ZW1 but a smaller error per time step
 //
 template <typename Tensor>
 MPOt<Tensor>
@@ -41,6 +45,21 @@ toExpH(AutoMPO const& a,
        Cplx tau,
        Args const& args = Args::global());
 
+//
+// Returns MPOs whose product approximates exp(-tau*H),
+// to be applied in sequence: for "Order"=1 (default)
+// just toExpH(a,tau,args); for "Order"=2 the pair of
+// complex time steps tau1,2 = (1 +/- i)*tau/2, which
+// cancel the leading error of each approximation
+// (best used with "Approx"="ZW2"). Other args are
+// passed to toExpH.
+//
+template <typename Tensor>
+std::vector<MPOt<Tensor>>
+toExpHSteps(AutoMPO const& a,
+            Cplx tau,
+            Args const& args = Args::global());
+
 
 
 //Instantiations of templates to allow us to define them
@@ -53,7 +72,7 @@ template<> IQMPO toExpH<IQTensor>(AutoMPO const& a, Cplx tau, Args const& args);
 
 struct SiteTerm
     {
-    std::string op;
+    OpName op;
     int i;
 
     SiteTerm();
@@ -87,6 +106,12 @@ using SiteTermProd = std::vector<SiteTerm>;
 bool
 isFermionic(SiteTerm const& st);
 
+//Name of the operator which, multiplied by
+//Jordan-Wigner strings, represents the fermionic
+//operator op (e.g. "Cdagup" -> "Adagup")
+std::string
+fermionicTerm(std::string const& op);
+
 struct HTerm
     {
     Cplx coef = 0.;
@@ -137,13 +162,25 @@ struct LessNoCoef
     operator()(HTerm const& t1, HTerm const& t2) const;
     };
 
+//
+// Hash of the operators of a term
+// (ignoring the coefficient)
+//
+size_t
+hashOps(SiteTermProd const& ops);
+
 class AutoMPO
     {
     public:
-    using storage = std::set<HTerm,LessNoCoef>;
+    //Terms are kept in the order first added; 
+    //adding a term whose operators match an existing 
+    //term adds to the existing coefficient
+    using storage = std::vector<HTerm>;
     private:
     SiteSet sites_;
     storage terms_;
+    //Maps hashOps of each term to its position in terms_
+    std::unordered_multimap<size_t,size_t> index_;
 
     enum State { New, Op };
 
@@ -216,8 +253,21 @@ class AutoMPO
     void
     add(HTerm const& t);
 
+    //Add many terms at once; more efficient
+    //than adding them one at a time
+    void
+    add(std::vector<HTerm> const& terms);
+
+    //Reserve space for n terms in total
     void
-    reset() { terms_.clear(); }
+    reserve(size_t n);
+
+    void
+    reset() 
+        { 
+        terms_.clear(); 
+        index_.clear();
+        }
     };
 
 std::ostream& 
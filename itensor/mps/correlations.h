@@ -0,0 +1,253 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_CORRELATIONS_H
+#define __ITENSOR_CORRELATIONS_H
+
+#include "itensor/mps/mps.h"
+#include "itensor/mps/autompo.h"
+#include "itensor/util/threading.h"
+
+namespace itensor {
+
+//
+// Computes the matrix of two-point correlation functions
+//
+//   C(i-1,j-1) = <psi|A_i B_j|psi> / <psi|psi>
+//
+// for all sites i,j = 1,2,...,N, where A and B are
+// names of operators recognized by psi.sites().op(..).
+// (Note that C is zero-indexed, like other Mat types.)
+//
+// The left and right environments of psi are computed
+// once; each row of C is then obtained by a single sweep
+// to the right, so the whole matrix costs O(N^2) tensor
+// contractions instead of O(N^3) when calling
+// psi.position(i) for each pair. psi need not be
+// normalized or have a definite orthogonality center.
+//
+// Fermionic operators (names beginning with 'C', such
+// as "Cdag" and "Cup", following the AutoMPO convention)
+// automatically include their Jordan-Wigner string.
+//
+// Arguments recognized:
+//    "String": name of an operator to place on each site
+//              strictly between i and j, for computing
+//              string correlators such as
+//              <Sz_i exp(i pi Sz_{i+1}) ... Sz_j>.
+//              Not allowed for fermionic operators.
+//    "NThread": number of threads over which rows
+//               of C are distributed (default 1)
+//
+// Example, computing the structure factor S(k):
+//
+//   auto C = correlationMatrix(psi,"Sz","Sz");
+//   Real Sk = 0;
+//   for(auto i : range(N))
+//   for(auto j : range(N))
+//       {
+//       Sk += std::cos(k*(i-j))*C(i,j)/N;
+//       }
+//
+template<typename Tensor>
+CMatrix
+correlationMatrixC(MPSt<Tensor> const& psi,
+                   std::string const& opA,
+                   std::string const& opB,
+                   Args const& args = Args::global());
+
+//Same as correlationMatrixC, but returning
+//the real part of the correlation functions
+template<typename Tensor>
+Matrix
+correlationMatrix(MPSt<Tensor> const& psi,
+                  std::string const& opA,
+                  std::string const& opB,
+                  Args const& args = Args::global());
+
+
+namespace detail {
+
+//Contract an environment E with the
+//ket and bra tensors of the next site
+template<typename Tensor>
+Tensor
+extendEnv(Tensor const& E,
+          Tensor const& ket,
+          Tensor const& bra)
+    {
+    if(!E) return ket*bra;
+    return (E*ket)*bra;
+    }
+
+template<typename Tensor>
+Cplx
+closeEnv(Tensor const& E,
+         Tensor const& R)
+    {
+    if(!R) return E.cplx();
+    return (E*R).cplx();
+    }
+
+//Whether <A_i B_j> can be non-zero
+//given the QN flux of the operators
+bool inline
+fluxCancels(ITensor const& A, ITensor const& B) { return true; }
+
+bool inline
+fluxCancels(IQTensor const& A, IQTensor const& B) { return div(A)+div(B) == QN(); }
+
+} //namespace detail
+
+template<typename Tensor>
+CMatrix
+correlationMatrixC(MPSt<Tensor> const& psi,
+                   std::string const& opA,
+                   std::string const& opB,
+                   Args const& args)
+    {
+    auto N = psi.N();
+    auto& sites = psi.sites();
+    auto nthread = getNThread(args);
+    auto strop = args.getString("String","");
+
+    //Same convention as isFermionic(SiteTerm)
+    auto isFermi = [](std::string const& op) { return !op.empty() && op.front() == 'C'; };
+    auto fermiA = isFermi(opA),
+         fermiB = isFermi(opB);
+    if(fermiA != fermiB)
+        {
+        Error("correlationMatrix: cannot correlate a fermionic with a bosonic operator");
+        }
+    auto fermionic = fermiA;
+    if(fermionic)
+        {
+        if(!strop.empty()) Error("correlationMatrix: String arg not allowed for fermionic operators");
+        strop = "F";
+        }
+    auto nameA = fermionic ? fermionicTerm(opA) : opA,
+         nameB = fermionic ? fermionicTerm(opB) : opB;
+
+    //Bosonic operators on different sites commute and
+    //fermionic ones anticommute, so for A == B only the
+    //upper triangle of C needs computing
+    auto symmetric = (opA == opB);
+    //Sign from reordering A_i B_j with i > j as B_j A_i
+    Real swapsign = fermionic ? -1. : 1.;
+
+    auto ket = [&psi](int k, Tensor const& op)
+        {
+        return noprime(psi.A(k)*op,Site);
+        };
+
+    //Site tensors of <psi|, and of |psi> with the operators
+    //needed on each site either to the left (start of a
+    //Jordan-Wigner string), right, or in between
+    auto bra = std::vector<Tensor>(N+1),
+         leftA = std::vector<Tensor>(N+1),
+         leftB = std::vector<Tensor>(N+1),
+         rightA = std::vector<Tensor>(N+1),
+         rightB = std::vector<Tensor>(N+1),
+         string = std::vector<Tensor>(N+1),
+         onsite = std::vector<Tensor>(N+1);
+    auto cancels = true;
+    for(auto k : range1(N))
+        {
+        bra[k] = dag(prime(psi.A(k),Link));
+        auto A = Tensor(sites.op(nameA,k)),
+             B = Tensor(sites.op(nameB,k));
+        if(k == 1) cancels = detail::fluxCancels(A,B);
+        rightA[k] = ket(k,A);
+        rightB[k] = ket(k,B);
+        if(fermionic)
+            {
+            auto F = Tensor(sites.op("F",k));
+            leftA[k] = ket(k,multSiteOps(A,F));
+            leftB[k] = ket(k,multSiteOps(B,F));
+            }
+        else
+            {
+            leftA[k] = rightA[k];
+            leftB[k] = rightB[k];
+            }
+        string[k] = strop.empty() ? psi.A(k) : ket(k,Tensor(sites.op(strop,k)));
+        onsite[k] = ket(k,multSiteOps(A,B));
+        }
+
+    auto L = std::vector<Tensor>(N+2),
+         R = std::vector<Tensor>(N+2);
+    for(auto k : range1(N))
+        {
+        L[k] = detail::extendEnv(L[k-1],psi.A(k),bra[k]);
+        }
+    for(auto k = N; k >= 1; --k)
+        {
+        R[k] = detail::extendEnv(R[k+1],psi.A(k),bra[k]);
+        }
+    auto nrm2 = L[N].cplx().real();
+    if(nrm2 == 0) Error("correlationMatrix: psi has zero norm");
+
+    auto C = CMatrix(N,N);
+    if(!cancels) return C;
+
+    parallelFor(N,nthread,[&](size_t r)
+        {
+        auto i = int(r)+1;
+        auto Ci = [&C](int i, int j) -> Cplx& { return C(i-1,j-1); };
+
+        Ci(i,i) = detail::closeEnv(detail::extendEnv(L[i-1],onsite[i],bra[i]),R[i+1]);
+
+        //A on site i, B to the right: C(i,j) for j > i
+        auto E = detail::extendEnv(L[i-1],leftA[i],bra[i]);
+        for(auto j : range1(i+1,N))
+            {
+            Ci(i,j) = detail::closeEnv(detail::extendEnv(E,rightB[j],bra[j]),R[j+1]);
+            if(j < N) E = detail::extendEnv(E,string[j],bra[j]);
+            }
+        if(symmetric)
+            {
+            for(auto j : range1(i+1,N)) Ci(j,i) = swapsign*Ci(i,j);
+            return;
+            }
+
+        //B on site i, A to the right: C(j,i) for j > i
+        E = detail::extendEnv(L[i-1],leftB[i],bra[i]);
+        for(auto j : range1(i+1,N))
+            {
+            Ci(j,i) = swapsign*detail::closeEnv(detail::extendEnv(E,rightA[j],bra[j]),R[j+1]);
+            if(j < N) E = detail::extendEnv(E,string[j],bra[j]);
+            }
+        });
+
+    makeRef(C) /= nrm2;
+    return C;
+    }
+
+template<typename Tensor>
+Matrix
+correlationMatrix(MPSt<Tensor> const& psi,
+                  std::string const& opA,
+                  std::string const& opB,
+                  Args const& args)
+    {
+    auto C = correlationMatrixC(psi,opA,opB,args);
+    auto N = nrows(C);
+    auto res = Matrix(N,N);
+    Real maxim = 0;
+    for(auto i : range(N))
+    for(auto j : range(N))
+        {
+        res(i,j) = C(i,j).real();
+        maxim = std::max(maxim,std::fabs(C(i,j).imag()));
+        }
+    if(maxim > 1E-12*std::max(1.,norm(res)))
+        {
+        printfln("correlationMatrix: WARNING, dropping non-zero imaginary part (max=%.5E) of correlation functions.",maxim);
+        }
+    return res;
+    }
+
+} //namespace itensor
+
+#endif
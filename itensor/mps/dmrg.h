@@ -5,12 +5,17 @@
 #ifndef __ITENSOR_DMRG_H
 #define __ITENSOR_DMRG_H
 
+#include <fstream>
+#include <sstream>
 #include "itensor/iterativesolvers.h"
 #include "itensor/mps/localmposet.h"
 #include "itensor/mps/localmpo_mps.h"
 #include "itensor/mps/sweeps.h"
 #include "itensor/mps/DMRGObserver.h"
 #include "itensor/util/cputime.h"
+#include "itensor/util/profiling.h"
+#include "itensor/util/memstats.h"
+#include "itensor/util/mapalloc.h"
 
 
 namespace itensor {
@@ -172,6 +177,49 @@ dmrg(MPSt<Tensor>& psi,
 //
 // DMRGWorker
 //
+// Named Args recognized for profiling:
+// Profile - if true, collect the time spent in each 
+//           phase of every sweep (environment updates,
+//           Davidson and its products, SVD/truncation,
+//           disk I/O and observer measurements) together
+//           with flop and byte counts, and print
+//           a summary after each sweep.
+// ProfileFile - name of a file to which the per-sweep 
+//               profiling data is written as JSON 
+//               (implies Profile=true). The file is 
+//               rewritten after every sweep.
+// MemStats - if true, track the memory used by tensor
+//            storage (see util/memstats.h), counting
+//            environments, wavefunction tensors and
+//            Davidson temporaries separately. The
+//            DMRGObserver prints live and peak memory
+//            after each sweep.
+// MapStorage - name of a directory; if given, Dense and
+//              QDense storage of at least MapMinBytes 
+//              (default 1 MB) created during the run is
+//              placed in memory mapped files there 
+//              (see util/mapalloc.h), so the tensors can
+//              exceed the available RAM.
+//
+
+namespace detail {
+
+void inline
+writeDMRGProfile(std::string const& fname,
+                 std::vector<std::string> const& sweep_records)
+    {
+    std::ofstream f(fname.c_str());
+    if(!f.good()) Error("Couldn't open file \"" + fname + "\" for writing DMRG profile");
+    f << "{\"sweeps\": [";
+    for(auto n : range(sweep_records))
+        {
+        if(n > 0) f << ",";
+        f << "\n  " << sweep_records[n];
+        }
+    f << "\n]}\n";
+    }
+
+} //namespace detail
 
 template <class Tensor, class LocalOpT>
 Real inline
@@ -196,19 +244,32 @@ DMRGWorker(MPSt<Tensor>& psi,
     const bool quiet = args.getBool("Quiet",false);
     const int debug_level = args.getInt("DebugLevel",(quiet ? 0 : 1));
     const bool ignore_degeneracy = args.getBool("IgnoreDegeneracy",false);
+    const auto profile_file = args.getString("ProfileFile","");
+    const bool do_profile = args.getBool("Profile",false) || !profile_file.empty();
+
+    const auto map_dir = args.getString("MapStorage","");
 
     const int N = psi.N();
     Real energy = NAN;
 
+    auto do_map = !map_dir.empty() && !storageMapped();
+    if(do_map) mapStorage(map_dir,args.getInt("MapMinBytes",1024*1024));
+
     psi.position(1);
 
     args.add("DebugLevel",debug_level);
     args.add("IgnoreDegeneracy",ignore_degeneracy);
     args.add("DoNormalize",true);
+
+    ProfilingScope profiling_scope(do_profile || profiling());
+    MemTrackingScope tracking_scope(args.getBool("MemStats",false) || memTracking());
+    auto sweep_records = std::vector<std::string>();
     
     for(int sw = 1; sw <= sweeps.nsweep(); ++sw)
         {
         cpu_time sw_time;
+        auto sw_profile = (do_profile ? profileData() : ProfileData());
+        if(memTracking()) resetMemPeak();
         args.add("Sweep",sw);
         args.add("NSweep",sweeps.nsweep());
         args.add("Cutoff",sweeps.cutoff(sw));
@@ -231,6 +292,15 @@ DMRGWorker(MPSt<Tensor>& psi,
             PH.doWrite(true,args);
             }
 
+        if(PH.precision() != sweeps.precision(sw))
+            {
+            if(!quiet)
+                {
+                printfln("\nStoring environments in %d bit precision",sweeps.precision(sw));
+                }
+            PH.precision(sweeps.precision(sw));
+            }
+
         for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N))
             {
             if(!quiet)
@@ -238,13 +308,33 @@ DMRGWorker(MPSt<Tensor>& psi,
                 printfln("Sweep=%d, HS=%d, Bond=%d/%d",sw,ha,b,(N-1));
                 }
 
-            PH.position(b,psi);
+            PROFILE_START(dmrg_environment)
+                {
+                MemScope scope(MemCategory::Environment);
+                PH.position(b,psi);
+                }
+            PROFILE_STOP(dmrg_environment)
 
-            auto phi = psi.A(b)*psi.A(b+1);
+            Tensor phi;
+                {
+                MemScope scope(MemCategory::Wavefunction);
+                phi = psi.A(b)*psi.A(b+1);
+                }
 
-            energy = davidson(PH,phi,args);
+            PROFILE_START(dmrg_davidson)
+                {
+                MemScope scope(MemCategory::Temporary);
+                energy = davidson(PH,phi,args);
+                }
+            PROFILE_STOP(dmrg_davidson)
             
-            auto spec = psi.svdBond(b,phi,(ha==1?Fromleft:Fromright),PH,args);
+            Spectrum spec;
+            PROFILE_START(dmrg_svd)
+                {
+                MemScope scope(MemCategory::Wavefunction);
+                spec = psi.svdBond(b,phi,(ha==1?Fromleft:Fromright),PH,args);
+                }
+            PROFILE_STOP(dmrg_svd)
 
 
             if(!quiet)
@@ -265,7 +355,9 @@ DMRGWorker(MPSt<Tensor>& psi,
             args.add("Energy",energy); 
             args.add("Truncerr",spec.truncerr()); 
 
+            PROFILE_START(dmrg_measure)
             obs.measure(args);
+            PROFILE_STOP(dmrg_measure)
 
             } //for loop over b
 
@@ -273,12 +365,46 @@ DMRGWorker(MPSt<Tensor>& psi,
         printfln("    Sweep %d/%d CPU time = %s (Wall time = %s)",
                   sw,sweeps.nsweep(),showtime(sm.time),showtime(sm.wall));
 
+        if(do_profile)
+            {
+            auto P = profileData()-sw_profile;
+            if(!quiet)
+                {
+                printfln("    Sweep %d/%d times: environment = %.3f, davidson = %.3f (products = %.3f),",
+                         sw,sweeps.nsweep(),P.time("dmrg_environment"),P.time("dmrg_davidson"),
+                         P.time("davidson_product"));
+                printfln("      svd = %.3f, disk I/O = %.3f, measure = %.3f; GFlops = %.3f",
+                         P.time("dmrg_svd"),P.time("disk_io"),P.time("dmrg_measure"),
+                         1E-9*P.total("flops"));
+                }
+            if(!profile_file.empty())
+                {
+                std::ostringstream rec;
+                rec << format("{\"sweep\": %d, \"maxm\": %d, \"cpu_time\": %.6f, \"wall_time\": %.6f, \"energy\": %.14g, ",
+                              sw,sweeps.maxm(sw),sm.time,sm.wall,energy);
+                rec << format("\"environment\": %.6f, \"davidson\": %.6f, \"davidson_product\": %.6f, ",
+                              P.time("dmrg_environment"),P.time("dmrg_davidson"),P.time("davidson_product"));
+                rec << format("\"svd\": %.6f, \"disk_io\": %.6f, \"measure\": %.6f, ",
+                              P.time("dmrg_svd"),P.time("disk_io"),P.time("dmrg_measure"));
+                rec << format("\"flops\": %.6e, \"gemm_bytes\": %.6e, \"disk_bytes\": %.6e, ",
+                              P.total("flops"),P.total("gemm_bytes"),P.total("disk_bytes"));
+                if(memTracking()) rec << format("\"mem_peak_bytes\": %d, ",memStats().total.peak);
+                rec << "\"sections\": ";
+                writeJSON(rec,P);
+                rec << "}";
+                sweep_records.push_back(rec.str());
+                detail::writeDMRGProfile(profile_file,sweep_records);
+                }
+            }
+
         if(obs.checkDone(args)) break;
     
         } //for loop over sw
-    
+
     psi.normalize();
 
+    if(do_map) unmapStorage();
+
     return energy;
     }
 
@@ -32,30 +32,30 @@ rungeKutta4(const Deriv& D, Real tstep, std::vector<Tensor>& v,
     std::vector<Tensor> d(v);
     for(int j = 1; j <= N; ++j)
         {
-        d.at(j) += (tstep/2.)*k1.at(j);
+        linearCombination({1.,tstep/2.},{v.at(j),k1.at(j)},d.at(j));
         }
     k2 = D(d);
 
     //d = v + (tstep/2)*k2
-    d = v;
     for(int j = 1; j <= N; ++j)
         {
-        d.at(j) += (tstep/2.)*k2.at(j);
+        linearCombination({1.,tstep/2.},{v.at(j),k2.at(j)},d.at(j));
         }
     k3 = D(d);
 
     //d = v + (tstep)*k3
-    d = v;
     for(int j = 1; j <= N; ++j)
         {
-        d.at(j) += (tstep)*k3.at(j);
+        linearCombination({1.,tstep},{v.at(j),k3.at(j)},d.at(j));
         }
     k4 = D(d);
 
 
     for(int j = 1; j <= N; ++j)
         {
-        v.at(j) += (tstep/6.)*(k1.at(j) + 2*k2.at(j) + 2*k3.at(j) + k4.at(j));
+        linearCombination({1.,tstep/6.,tstep/3.,tstep/3.,tstep/6.},
+                          {v.at(j),k1.at(j),k2.at(j),k3.at(j),k4.at(j)},
+                          v.at(j));
         }
     }
 
@@ -76,13 +76,13 @@ midpointMethod(const Deriv& D, Real tstep, std::vector<Tensor>& v,
     std::vector<Tensor> d(v);
     for(int j = 1; j <= N; ++j)
         {
-        d.at(j) += (tstep/2.)*k1.at(j);
+        linearCombination({1.,tstep/2.},{v.at(j),k1.at(j)},d.at(j));
         }
     k2 = D(d);
 
     for(int j = 1; j <= N; ++j)
         {
-        v.at(j) += tstep*k2.at(j);
+        linearCombination({1.,tstep},{v.at(j),k2.at(j)},v.at(j));
         }
     }
 
@@ -104,8 +104,15 @@ class LocalMPO
              const Tensor& comb, Direction dir) const
         { return lop_.deltaRho(AA,comb,dir); }
 
+    //
+    // The diagonal is computed from the
+    // diagonal parts of the edge and MPO
+    // tensors (see diagEdge, diagSite),
+    // which are cached and kept until the
+    // corresponding edge tensor changes
+    //
     Tensor
-    diag() const { return lop_.diag(); }
+    diag() const;
 
     //
     // position(b,psi) uses the MPS psi
@@ -138,7 +145,7 @@ class LocalMPO
     L() const { return PH_[LHlim_]; }
     // Replace left edge tensor at current bond
     void
-    L(Tensor const& nL) { PH_[LHlim_] = nL; }
+    L(Tensor const& nL) { setPH(LHlim_,nL); }
     // Replace left edge tensor bordering site j
     // (so that nL includes sites < j)
     void
@@ -149,7 +156,7 @@ class LocalMPO
     R() const { return PH_[RHlim_]; }
     // Replace right edge tensor at current bond
     void
-    R(Tensor const& nR) { PH_[RHlim_] = nR; }
+    R(Tensor const& nR) { setPH(RHlim_,nR); }
     // Replace right edge tensor bordering site j
     // (so that nR includes sites > j)
     void
@@ -194,6 +201,20 @@ class LocalMPO
     std::string const&
     writeDir() const { return writedir_; }
 
+    //Number of bits (32 or 64) of the floating point
+    //numbers in which the environment tensors other
+    //than L() and R() are kept, in memory or on disk
+    int
+    precision() const { return single_ ? 32 : 64; }
+    void
+    precision(int bits);
+
+    //Environment tensor at position j, so L() is
+    //env(leftLim()) and R() is env(rightLim()).
+    //Empty if it has been written to disk.
+    Tensor const&
+    env(int j) const { return PH_.at(j); }
+
     int
     leftLim() const { return LHlim_; }
 
@@ -209,6 +230,10 @@ class LocalMPO
 
     const MPOt<Tensor>* Op_;
     std::vector<Tensor> PH_;
+    //Diagonal parts of PH_ and of the
+    //MPO tensors, computed as needed
+    mutable std::vector<Tensor> PHdiag_,
+                                Wdiag_;
     int LHlim_,RHlim_;
     int nc_;
 
@@ -216,6 +241,7 @@ class LocalMPO
 
     bool do_write_ = false;
     std::string writedir_ = "./";
+    bool single_ = false;
 
     const MPSt<Tensor>* Psi_;
 
@@ -230,12 +256,26 @@ class LocalMPO
     void
     makeR(const MPSType& psi, int k);
 
+    void
+    setPH(int j, Tensor const& nE)
+        {
+        PH_.at(j) = nE;
+        if(!PHdiag_.empty()) PHdiag_.at(j) = Tensor();
+        }
+
     void
     setLHlim(int val);
 
     void
     setRHlim(int val);
 
+    //Precision of PH_[j] once it is no
+    //longer L() or R(), and once it is again
+    void
+    retireEnv(int j);
+    void
+    restoreEnv(int j);
+
     void
     initWrite(Args const& args);
 
@@ -373,12 +413,33 @@ product(const Tensor& phi, Tensor& phip) const
         }
     }
 
+template <class Tensor>
+Tensor inline LocalMPO<Tensor>::
+diag() const
+    {
+    if(Op_ == 0) return lop_.diag();
+
+    auto b = position();
+    if(PHdiag_.empty()) PHdiag_.resize(PH_.size());
+    if(Wdiag_.empty()) Wdiag_.resize(Op_->N()+2);
+
+    auto& DL = PHdiag_.at(LHlim_);
+    if(!DL && L()) DL = diagEdge(L());
+    auto& DR = PHdiag_.at(RHlim_);
+    if(!DR && R()) DR = diagEdge(R());
+    for(auto j : {b,b+1})
+        {
+        if(!Wdiag_.at(j)) Wdiag_.at(j) = diagSite(Op_->A(j));
+        }
+    return combineDiag(DL,Wdiag_.at(b),Wdiag_.at(b+1),DR);
+    }
+
 template <class Tensor>
 void inline LocalMPO<Tensor>::
 L(int j, const Tensor& nL)
     {
     if(LHlim_ > j-1) setLHlim(j-1);
-    PH_[LHlim_] = nL;
+    setPH(LHlim_,nL);
     }
 
 template <class Tensor>
@@ -386,7 +447,7 @@ void inline LocalMPO<Tensor>::
 R(int j, const Tensor& nR)
     {
     if(RHlim_ < j+1) setRHlim(j+1);
-    PH_[RHlim_] = nR;
+    setPH(RHlim_,nR);
     }
 
 template <class Tensor>
@@ -446,11 +507,7 @@ shift(int j, Direction dir, const Tensor& A)
             std::cout << "j-1 = " << (j-1) << ", LHlim = " << LHlim_ << std::endl;
             Error("Can only shift at LHlim");
             }
-        Tensor& E = PH_.at(LHlim_);
-        Tensor& nE = PH_.at(j);
-        nE = E * A;
-        nE *= Op_->A(j);
-        nE *= dag(prime(A));
+        setPH(j,contractNetwork(PH_.at(LHlim_),A,Op_->A(j),dag(prime(A))));
         setLHlim(j);
         setRHlim(j+nc_+1);
 
@@ -463,11 +520,7 @@ shift(int j, Direction dir, const Tensor& A)
             std::cout << "j+1 = " << (j+1) << ", RHlim_ = " << RHlim_ << std::endl;
             Error("Can only shift at RHlim_");
             }
-        Tensor& E = PH_.at(RHlim_);
-        Tensor& nE = PH_.at(j);
-        nE = E * A;
-        nE *= Op_->A(j);
-        nE *= dag(prime(A));
+        setPH(j,contractNetwork(PH_.at(RHlim_),A,Op_->A(j),dag(prime(A))));
         setLHlim(j-nc_-1);
         setRHlim(j);
 
@@ -497,16 +550,7 @@ makeL(const MPSType& psi, int k)
             while(LHlim_ < k)
                 {
                 auto ll = LHlim_;
-                if(PH_.at(ll))
-                    {
-                    PH_.at(ll+1) = PH_.at(ll)*psi.A(ll+1);
-                    }
-                else
-                    {
-                    PH_.at(ll+1) = psi.A(ll+1);
-                    }
-                PH_.at(ll+1) *= Op_->A(ll+1);
-                PH_.at(ll+1) *= dag(prime(psi.A(ll+1)));
+                setPH(ll+1,contractNetwork(PH_.at(ll),psi.A(ll+1),Op_->A(ll+1),dag(prime(psi.A(ll+1)))));
                 setLHlim(ll+1);
                 }
             }
@@ -539,16 +583,7 @@ makeR(const MPSType& psi, int k)
                 //Print(PH_.at(rl));
                 //Print(Op_->A(rl-1));
                 //Print(psi.A(rl-1));
-                if(PH_.at(rl))
-                    {
-                    PH_.at(rl-1) = PH_.at(rl)*psi.A(rl-1);
-                    }
-                else
-                    {
-                    PH_.at(rl-1) = psi.A(rl-1);
-                    }
-                PH_.at(rl-1) *= Op_->A(rl-1);
-                PH_.at(rl-1) *= dag(prime(psi.A(rl-1)));
+                setPH(rl-1,contractNetwork(PH_.at(rl),psi.A(rl-1),Op_->A(rl-1),dag(prime(psi.A(rl-1)))));
                 //printfln("PH[%d] = \n%s",rl-1,PH_.at(rl-1));
                 //PAUSE
                 setRHlim(rl-1);
@@ -563,13 +598,15 @@ setLHlim(int val)
     {
     if(!do_write_)
         {
+        if(LHlim_ != val) retireEnv(LHlim_);
         LHlim_ = val;
+        restoreEnv(LHlim_);
         return;
         }
 
     if(LHlim_ != val && PH_.at(LHlim_))
         {
-        writeToFile(PHFName(LHlim_),PH_.at(LHlim_));
+        writeToFile(PHFName(LHlim_),single_ ? toSingle(PH_.at(LHlim_)) : PH_.at(LHlim_));
         PH_.at(LHlim_) = Tensor();
         }
     LHlim_ = val;
@@ -583,6 +620,7 @@ setLHlim(int val)
         {
         std::string fname = PHFName(LHlim_);
         readFromFile(fname,PH_.at(LHlim_));
+        restoreEnv(LHlim_);
         }
     }
 
@@ -592,13 +630,15 @@ setRHlim(int val)
     {
     if(!do_write_)
         {
+        if(RHlim_ != val) retireEnv(RHlim_);
         RHlim_ = val;
+        restoreEnv(RHlim_);
         return;
         }
 
     if(RHlim_ != val && PH_.at(RHlim_))
         {
-        writeToFile(PHFName(RHlim_),PH_.at(RHlim_));
+        writeToFile(PHFName(RHlim_),single_ ? toSingle(PH_.at(RHlim_)) : PH_.at(RHlim_));
         PH_.at(RHlim_) = Tensor();
         }
     RHlim_ = val;
@@ -612,6 +652,37 @@ setRHlim(int val)
         {
         std::string fname = PHFName(RHlim_);
         readFromFile(fname,PH_.at(RHlim_));
+        restoreEnv(RHlim_);
+        }
+    }
+
+template <class Tensor>
+void inline LocalMPO<Tensor>::
+retireEnv(int j)
+    {
+    if(!single_ || j < 0 || j >= int(PH_.size())) return;
+    PH_[j] = toSingle(PH_[j]);
+    }
+
+template <class Tensor>
+void inline LocalMPO<Tensor>::
+restoreEnv(int j)
+    {
+    if(j < 0 || j >= int(PH_.size())) return;
+    if(isSingle(PH_[j])) PH_[j] = toDouble(PH_[j]);
+    }
+
+template <class Tensor>
+void inline LocalMPO<Tensor>::
+precision(int bits)
+    {
+    if(bits != 32 && bits != 64) Error(format("LocalMPO: precision must be 32 or 64 bits, got %d",bits));
+    single_ = (bits == 32);
+    //Environments on disk are converted when read back in
+    for(auto j : range(PH_.size()))
+        {
+        if(single_ && int(j) != LHlim_ && int(j) != RHlim_) retireEnv(j);
+        else                                                restoreEnv(j);
         }
     }
 
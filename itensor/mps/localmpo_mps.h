@@ -5,6 +5,7 @@
 #ifndef __ITENSOR_LOCALMPO_MPS
 #define __ITENSOR_LOCALMPO_MPS
 #include "itensor/mps/localmpo.h"
+#include "itensor/util/threading.h"
 
 namespace itensor {
 
@@ -23,6 +24,7 @@ class LocalMPO_MPS
     //of each MPS in psis_
     std::vector<LocalMPOType> lmps_;
     Real weight_ = 1;
+    int nthread_ = 1;
     public:
 
     LocalMPO_MPS() { }
@@ -80,6 +82,20 @@ class LocalMPO_MPS
     void
     doWrite(bool val, Args const& args = Args::global()) { lmpo_.doWrite(val,args); }
 
+    int
+    precision() const { return lmpo_.precision(); }
+    void
+    precision(int bits)
+        {
+        lmpo_.precision(bits);
+        for(auto& M : lmps_) M.precision(bits);
+        }
+
+    int
+    nthread() const { return nthread_; }
+    void
+    nthread(int val) { nthread_ = std::max(val,1); }
+
     };
 
 template <class Tensor>
@@ -90,7 +106,8 @@ LocalMPO_MPS(MPOt<Tensor> const& Op,
   : Op_(&Op),
     psis_(&psis),
     lmps_(psis.size()),
-    weight_(args.getReal("Weight",1))
+    weight_(args.getReal("Weight",1)),
+    nthread_(getNThread(args))
     { 
     lmpo_ = LocalMPOType(Op);
 
@@ -112,7 +129,8 @@ LocalMPO_MPS(MPOt<Tensor> const& Op,
   : Op_(&Op),
     psis_(&psis),
     lmps_(psis.size()),
-    weight_(args.getReal("Weight",1))
+    weight_(args.getReal("Weight",1)),
+    nthread_(getNThread(args))
     { 
     lmpo_ = LocalMPOType(Op,LOp,ROp);
 #ifdef DEBUG
@@ -131,15 +149,33 @@ void inline LocalMPO_MPS<Tensor>::
 product(Tensor const& phi, 
         Tensor & phip) const
     {
-    lmpo_.product(phi,phip);
-
-    Tensor outer;
-    for(auto& M : lmps_)
+    //Term 0 is the MPO, terms 1,2,... are the 
+    //projectors onto each MPS in psis_.
+    //Each thread accumulates a partial sum
+    //which are then combined by tree reduction.
+    auto nterm = 1+lmps_.size();
+    auto nt = std::min<size_t>(nthread_,nterm);
+    auto partial = std::vector<Tensor>(nt);
+    parallelFor(nt,nt,[&](size_t t)
         {
-        M.product(phi,outer);
-        outer *= weight_;
-        phip += outer;
-        }
+        Tensor outer;
+        for(auto n = t; n < nterm; n += nt)
+            {
+            if(n == 0)
+                {
+                lmpo_.product(phi,outer);
+                }
+            else
+                {
+                lmps_[n-1].product(phi,outer);
+                outer *= weight_;
+                }
+            if(!partial[t]) partial[t] = std::move(outer);
+            else            partial[t] += outer;
+            }
+        });
+    treeReduce(partial,nt,[](Tensor& A, Tensor const& B) { A += B; });
+    phip = std::move(partial.front());
     }
 
 template <class Tensor>
@@ -147,11 +183,23 @@ template <class MPSType>
 void inline LocalMPO_MPS<Tensor>::
 position(int b, const MPSType& psi)
     {
-    lmpo_.position(b,psi);
-    for(auto& M : lmps_)
+    if(nthread_ <= 1 || psi.doWrite())
         {
-        M.position(b,psi);
+        lmpo_.position(b,psi);
+        for(auto& M : lmps_)
+            {
+            M.position(b,psi);
+            }
+        return;
         }
+    parallelFor(1+lmps_.size(),nthread_,[&](size_t n)
+        {
+        //MPSt::A updates internal bookkeeping,
+        //so give each thread a shallow copy
+        auto psi_n = psi;
+        if(n == 0) lmpo_.position(b,psi_n);
+        else       lmps_[n-1].position(b,psi_n);
+        });
     }
 
 } //namespace itensor
@@ -5,6 +5,7 @@
 #ifndef __ITENSOR_LOCALMPOSET
 #define __ITENSOR_LOCALMPOSET
 #include "itensor/mps/localmpo.h"
+#include "itensor/util/threading.h"
 
 namespace itensor {
 
@@ -13,6 +14,7 @@ class LocalMPOSet
     {
     std::vector<MPOt<Tensor>> const* Op_ = nullptr;
     std::vector<LocalMPO<Tensor>> lmpo_;
+    int nthread_ = 1;
     public:
 
     LocalMPOSet() { }
@@ -76,7 +78,10 @@ class LocalMPOSet
     void
     shift(int j, Direction dir, Tensor const& A)
         {
-        for(auto n : range(lmpo_)) lmpo_[n].shift(j,dir,A);
+        parallelFor(lmpo_.size(),nthread_,[&](size_t n)
+            {
+            lmpo_[n].shift(j,dir,A);
+            });
         }
 
     int
@@ -98,6 +103,26 @@ class LocalMPOSet
         for(auto& lm : lmpo_) lm.doWrite(val,args);
         }
 
+    int
+    precision() const { return lmpo_.front().precision(); }
+    void
+    precision(int bits) { for(auto& lm : lmpo_) lm.precision(bits); }
+
+    int
+    nthread() const { return nthread_; }
+    void
+    nthread(int val) { nthread_ = std::max(val,1); }
+
+    private:
+
+    //Evaluates term(n,T) for each MPO n, 
+    //accumulating terms into one partial
+    //sum per thread, then tree-reduces the
+    //partial sums into the returned tensor
+    template<typename TermFunc>
+    Tensor
+    sumTerms(TermFunc&& term) const;
+
     };
 
 template <class Tensor>
@@ -105,7 +130,8 @@ inline LocalMPOSet<Tensor>::
 LocalMPOSet(std::vector<MPOt<Tensor>> const& Op,
             Args const& args)
   : Op_(&Op),
-    lmpo_(Op.size())
+    lmpo_(Op.size()),
+    nthread_(getNThread(args))
     { 
     using LocalMPOT = LocalMPO<Tensor>;
     for(auto n : range(lmpo_.size()))
@@ -123,7 +149,8 @@ LocalMPOSet(std::vector<MPOt<Tensor>> const& H,
             int RHlim,
             Args const& args)
   : Op_(&H),
-    lmpo_(H.size())
+    lmpo_(H.size()),
+    nthread_(getNThread(args))
     { 
     using LocalMPOT = LocalMPO<Tensor>;
     for(auto n : range(lmpo_.size()))
@@ -132,31 +159,55 @@ LocalMPOSet(std::vector<MPOt<Tensor>> const& H,
         }
     }
 
+template <class Tensor>
+template<typename TermFunc>
+Tensor inline LocalMPOSet<Tensor>::
+sumTerms(TermFunc&& term) const
+    {
+    auto nt = std::min<size_t>(nthread_,lmpo_.size());
+    auto partial = std::vector<Tensor>(nt);
+    parallelFor(nt,nt,[&](size_t t)
+        {
+        Tensor T;
+        for(auto n = t; n < lmpo_.size(); n += nt)
+            {
+            if(!partial[t])
+                {
+                term(n,partial[t]);
+                }
+            else
+                {
+                term(n,T);
+                partial[t] += T;
+                }
+            }
+        });
+    treeReduce(partial,nt,[](Tensor& A, Tensor const& B) { A += B; });
+    return std::move(partial.front());
+    }
+
 template <class Tensor>
 void inline LocalMPOSet<Tensor>::
 product(Tensor const& phi, 
         Tensor & phip) const
     {
-    lmpo_.front().product(phi,phip);
-
-    Tensor phi_n;
-    for(auto n : range(1,lmpo_.size()))
+    phip = sumTerms([&](size_t n, Tensor& T)
         {
-        lmpo_[n].product(phi,phi_n);
-        phip += phi_n;
-        }
+        lmpo_[n].product(phi,T);
+        });
     }
 
 template <class Tensor>
 Real inline LocalMPOSet<Tensor>::
 expect(Tensor const& phi) const
     {
-    Real ex_ = 0;
-    for(size_t n = 0; n < lmpo_.size(); ++n)
-    for(auto n : range(lmpo_.size()))
+    auto ex = std::vector<Real>(lmpo_.size(),0.);
+    parallelFor(lmpo_.size(),nthread_,[&](size_t n)
         {
-        ex_ += lmpo_[n].expect(phi);
-        }
+        ex[n] = lmpo_[n].expect(phi);
+        });
+    Real ex_ = 0;
+    for(auto& e : ex) ex_ += e;
     return ex_;
     }
 
@@ -166,24 +217,20 @@ deltaRho(Tensor const& AA,
          Tensor const& comb, 
          Direction dir) const
     {
-    Tensor delta = lmpo_.front().deltaRho(AA,comb,dir);
-    for(auto n : range(1,lmpo_.size()))
+    return sumTerms([&](size_t n, Tensor& T)
         {
-        delta += lmpo_[n].deltaRho(AA,comb,dir);
-        }
-    return delta;
+        T = lmpo_[n].deltaRho(AA,comb,dir);
+        });
     }
 
 template <class Tensor>
 Tensor inline LocalMPOSet<Tensor>::
 diag() const
     {
-    Tensor D = lmpo_.front().diag();
-    for(auto n : range(1,lmpo_.size()))
+    return sumTerms([&](size_t n, Tensor& T)
         {
-        D += lmpo_[n].diag();
-        }
-    return D;
+        T = lmpo_[n].diag();
+        });
     }
 
 template <class Tensor>
@@ -192,10 +239,21 @@ void inline LocalMPOSet<Tensor>::
 position(int b, 
          MPSType const& psi)
     {
-    for(auto n : range(lmpo_.size()))
+    if(nthread_ <= 1 || psi.doWrite())
         {
-        lmpo_[n].position(b,psi);
+        for(auto n : range(lmpo_.size()))
+            {
+            lmpo_[n].position(b,psi);
+            }
+        return;
         }
+    parallelFor(lmpo_.size(),nthread_,[&](size_t n)
+        {
+        //MPSt::A updates internal bookkeeping,
+        //so give each thread a shallow copy
+        auto psi_n = psi;
+        lmpo_[n].position(b,psi_n);
+        });
     }
 
 template <class Tensor>
@@ -5,6 +5,7 @@
 #ifndef __ITENSOR_LOCAL_OP
 #define __ITENSOR_LOCAL_OP
 #include "itensor/iqtensor.h"
+#include "itensor/contractnetwork.h"
 //#include "itensor/util/print_macro.h"
 
 namespace itensor {
@@ -130,6 +131,39 @@ class LocalOp
 
     };
 
+//
+// Pieces of the diagonal of a LocalOp:
+// diagEdge(E) traces out the first index
+// pair (i,i') of an edge tensor such as L or R,
+// leaving i (E is returned unchanged if null
+// or if it has no such pair); diagSite(W)
+// does the same for the site indices (s,s')
+// of an operator tensor such as Op1 or Op2.
+//
+// combineDiag(DiagL,Diag1,Diag2,DiagR) contracts
+// these pieces into the diagonal of the operator,
+// as returned by LocalOp::diag. DiagL and DiagR
+// may be null. Callers which keep the edge
+// tensors between calls (like LocalMPO) can
+// cache the pieces so that each diagonal costs
+// only this final contraction.
+//
+
+template <class Tensor>
+Tensor
+diagEdge(Tensor const& E);
+
+template <class Tensor>
+Tensor
+diagSite(Tensor const& W);
+
+template <class Tensor>
+Tensor
+combineDiag(Tensor const& DiagL,
+            Tensor const& Diag1,
+            Tensor const& Diag2,
+            Tensor const& DiagR);
+
 template <class Tensor>
 inline LocalOp<Tensor>::
 LocalOp()
@@ -215,29 +249,11 @@ product(Tensor const& phi,
     {
     if(!(*this)) Error("LocalOp is null");
 
-    auto& Op1 = *Op1_;
-    auto& Op2 = *Op2_;
-
-    if(LIsNull())
-        {
-        phip = phi;
-
-        if(!RIsNull()) 
-            phip *= R(); //m^3 k d
-
-        phip *= Op2; //m^2 k^2
-        phip *= Op1; //m^2 k^2
-        }
-    else
-        {
-        phip = phi * L(); //m^3 k d
-
-        phip *= Op1; //m^2 k^2
-        phip *= Op2; //m^2 k^2
-
-        if(!RIsNull()) 
-            phip *= R();
-        }
+    //L and R may be null, in which case
+    //contractNetwork skips them; the order
+    //of contraction is chosen from the current
+    //values of m, k and d
+    phip = contractNetwork(std::vector<Tensor const*>{&phi,L_,Op1_,Op2_,R_});
 
     phip.mapprime(1,0);
     }
@@ -257,17 +273,9 @@ deltaRho(Tensor const& AA,
          Tensor const& combine, 
          Direction dir) const
     {
-    auto drho = AA;
-    if(dir == Fromleft)
-        {
-        if(!LIsNull()) drho *= L();
-        drho *= (*Op1_);
-        }
-    else //dir == Fromright
-        {
-        if(!RIsNull()) drho *= R();
-        drho *= (*Op2_);
-        }
+    auto drho = (dir == Fromleft)
+              ? contractNetwork(std::vector<Tensor const*>{&AA,L_,Op1_})
+              : contractNetwork(std::vector<Tensor const*>{&AA,R_,Op2_});
     drho.noprime();
     drho = combine * drho;
     auto ci = commonIndex(combine,drho);
@@ -287,56 +295,46 @@ diag() const
     {
     if(!(*this)) Error("LocalOp is null");
 
-    auto& Op1 = *Op1_;
-    auto& Op2 = *Op2_;
-
-    //lambda helper function:
-    auto findIndPair = [](Tensor const& T) {
-        for(auto& s : T.inds())
-            {
-            if(s.primeLevel() == 0 && hasindex(T,prime(s))) 
-                {
-                return s;
-                }
-            }
-        return IndexT();
-        };
-
-    auto toTie = noprime(findtype(Op1,Site));
-    auto Diag = Op1 * delta(toTie,prime(toTie),prime(toTie,2));
-    Diag.noprime();
-
-    toTie = noprime(findtype(Op2,Site));
-    auto Diag2 = Op2 * delta(toTie,prime(toTie),prime(toTie,2));
-    Diag *= noprime(Diag2);
+    auto DiagL = LIsNull() ? Tensor() : diagEdge(L());
+    auto DiagR = RIsNull() ? Tensor() : diagEdge(R());
+    return combineDiag(DiagL,diagSite(*Op1_),diagSite(*Op2_),DiagR);
+    }
 
-    if(!LIsNull())
+template <class Tensor>
+Tensor
+diagEdge(Tensor const& E)
+    {
+    if(!E) return E;
+    for(auto& s : E.inds())
         {
-        toTie = findIndPair(L());
-        if(toTie)
+        if(s.primeLevel() == 0 && hasindex(E,prime(s))) 
             {
-            auto DiagL = L() * delta(toTie,prime(toTie),prime(toTie,2));
-            Diag *= noprime(DiagL);
-            }
-        else
-            {
-            Diag *= L();
+            auto D = E * delta(s,prime(s),prime(s,2));
+            D.noprime();
+            return D;
             }
         }
+    return E;
+    }
 
-    if(!RIsNull())
-        {
-        toTie = findIndPair(R());
-        if(toTie)
-            {
-            auto DiagR = R() * delta(toTie,prime(toTie),prime(toTie,2));
-            Diag *= noprime(DiagR);
-            }
-        else
-            {
-            Diag *= R();
-            }
-        }
+template <class Tensor>
+Tensor
+diagSite(Tensor const& W)
+    {
+    auto s = noprime(findtype(W,Site));
+    auto D = W * delta(s,prime(s),prime(s,2));
+    D.noprime();
+    return D;
+    }
+
+template <class Tensor>
+Tensor
+combineDiag(Tensor const& DiagL,
+            Tensor const& Diag1,
+            Tensor const& Diag2,
+            Tensor const& DiagR)
+    {
+    auto Diag = contractNetwork(std::vector<Tensor const*>{&DiagL,&Diag1,&Diag2,&DiagR});
 
     Diag.dag();
     //Diag must be real since operator assumed Hermitian
@@ -5,6 +5,7 @@
 #include "itensor/util/print_macro.h"
 #include "itensor/mps/mpo.h"
 #include "itensor/mps/localop.h"
+#include "itensor/contractnetwork.h"
 
 namespace itensor {
 
@@ -197,7 +198,7 @@ findCenter(const IQMPO& psi)
     return -1;
     }
 
-void
+bool
 checkQNs(const IQMPO& H)
     {
     const int N = H.N();
@@ -207,7 +208,8 @@ checkQNs(const IQMPO& H)
     int center = findCenter(H);
     if(center == -1)
         {
-        Error("Did not find an ortho. center");
+        println("Did not find an ortho. center");
+        return false;
         }
 
     //Check that all IQTensors have zero div
@@ -217,13 +219,14 @@ checkQNs(const IQMPO& H)
         if(!H.A(i))
             {
             println("A(",i,") null, QNs not well defined");
-            Error("QNs not well defined");
+            return false;
             }
         if(div(H.A(i)) != Zero)
             {
             cout << "At i = " << i << endl;
             Print(H.A(i));
-            Error("Non-zero div IQTensor in IQMPO");
+            println("Non-zero div IQTensor in IQMPO");
+            return false;
             }
         }
 
@@ -233,14 +236,14 @@ checkQNs(const IQMPO& H)
         if(rightLinkInd(H,i).dir() != In) 
             {
             println("checkQNs: At site ",i," to the left of the OC, Right side Link not pointing In");
-            Error("Incorrect Arrow in IQMPO");
+            return false;
             }
         if(i > 1)
             {
             if(leftLinkInd(H,i).dir() != Out) 
                 {
                 println("checkQNs: At site ",i," to the left of the OC, Left side Link not pointing Out");
-                Error("Incorrect Arrow in IQMPO");
+                return false;
                 }
             }
         }
@@ -252,14 +255,15 @@ checkQNs(const IQMPO& H)
         if(rightLinkInd(H,i).dir() != Out) 
             {
             println("checkQNs: At site ",i," to the right of the OC, Right side Link not pointing Out");
-            Error("Incorrect Arrow in IQMPO");
+            return false;
             }
         if(leftLinkInd(H,i).dir() != In) 
             {
             println("checkQNs: At site ",i," to the right of the OC, Left side Link not pointing In");
-            Error("Incorrect Arrow in IQMPO");
+            return false;
             }
         }
+    return true;
     }
 
 
@@ -339,6 +343,28 @@ toMPO(IQMPO const& K)
     return res;
     }
 
+template<typename Tensor>
+MPOt<Tensor>
+sparseLinks(MPOt<Tensor> H)
+    {
+    using IndexT = typename Tensor::index_type;
+    auto N = H.N();
+    for(auto j : range1(N))
+        {
+        auto l1 = (j > 1) ? linkInd(H,j-1) : IndexT();
+        auto l2 = (j < N) ? linkInd(H,j) : IndexT();
+        if(!l1)
+            {
+            if(!l2) continue;
+            std::swap(l1,l2);
+            }
+        H.Aref(j) = sparseLinks(H.A(j),l1,l2);
+        }
+    return H;
+    }
+template MPO sparseLinks(MPO H);
+template IQMPO sparseLinks(IQMPO H);
+
 template<typename T>
 bool
 isComplex(MPOt<T> const& W)
@@ -364,21 +390,16 @@ overlap(MPSt<Tensor> const& psi,
     auto N = H.N();
     if(phi.N() != N || psi.N() != N) Error("psiHphi: mismatched N");
 
-    auto L = phi.A(1); 
+    auto nthread = detail::chainThreads({psi.doWrite(),H.doWrite(),phi.doWrite()});
+    auto A = detail::ChainSites<MPSt<Tensor>>(psi,N,nthread > 1);
+    auto W = detail::ChainSites<MPOt<Tensor>>(H,N,nthread > 1);
+    auto B = detail::ChainSites<MPSt<Tensor>>(phi,N,nthread > 1);
+    auto extend = [&A,&W,&B](Tensor const& E, int i)
+        {
+        return contractNetwork(E,B(i),W(i),dag(prime(A(i))));
+        };
     //Some Hamiltonians may store edge tensors in H.A(0) and H.A(N+1)
-    L *= (H.A(0) ? H.A(0)*H.A(1) : H.A(1));
-    L *= dag(prime(psi.A(1)));
-    for(int i = 2; i < N; ++i) 
-        { 
-        L *= phi.A(i); 
-        L *= H.A(i); 
-        L *= dag(prime(psi.A(i))); 
-        }
-    L *= phi.A(N); 
-    L *= H.A(N);
-    if(H.A(N+1)) L *= H.A(N+1);
-
-    auto z = (dag(prime(psi.A(N)))*L).cplx();
+    auto z = detail::contractChain(N,H.A(0),H.A(N+1),nthread,extend);
     re = z.real();
     im = z.imag();
     }
@@ -435,19 +456,15 @@ overlap(MPSt<Tensor> const& psi,
     auto N = psi.N();
     if(N != phi.N() || H.N() < N) Error("mismatched N in psiHphi");
 
-    auto L = (LB ? LB*phi.A(1) : phi.A(1));
-    L *= H.A(1); 
-    L *= dag(prime(psi.A(1)));
-    for(int i = 2; i <= N; ++i)
-        { 
-        L *= phi.A(i); 
-        L *= H.A(i); 
-        L *= dag(prime(psi.A(i))); 
-        }
-
-    if(RB) L *= RB;
-
-    auto z = L.cplx();
+    auto nthread = detail::chainThreads({psi.doWrite(),H.doWrite(),phi.doWrite()});
+    auto A = detail::ChainSites<MPSt<Tensor>>(psi,N,nthread > 1);
+    auto W = detail::ChainSites<MPOt<Tensor>>(H,N,nthread > 1);
+    auto B = detail::ChainSites<MPSt<Tensor>>(phi,N,nthread > 1);
+    auto extend = [&A,&W,&B](Tensor const& E, int i)
+        {
+        return contractNetwork(E,B(i),W(i),dag(prime(A(i))));
+        };
+    auto z = detail::contractChain(N,LB,RB,nthread,extend);
     re = z.real();
     im = z.imag();
     }
@@ -498,19 +515,17 @@ overlap(MPSt<Tensor> const& psi,
     Hp.mapprime(1,2);
     Hp.mapprime(0,1);
 
-    //scales as m^2 k^2 d
-    auto L = phi.A(1) * K.A(1) * Hp.A(1) * psidag.A(1);
-    //printfln("L%02d = %s",1,L);
-    for(int i = 2; i < N; i++)
+    auto nthread = detail::chainThreads({psidag.doWrite(),Hp.doWrite(),K.doWrite(),phi.doWrite()});
+    auto A = detail::ChainSites<MPSt<Tensor>>(psidag,N,nthread > 1);
+    auto W = detail::ChainSites<MPOt<Tensor>>(Hp,N,nthread > 1);
+    auto V = detail::ChainSites<MPOt<Tensor>>(K,N,nthread > 1);
+    auto B = detail::ChainSites<MPSt<Tensor>>(phi,N,nthread > 1);
+    auto extend = [&A,&W,&V,&B](Tensor const& E, int i)
         {
-        //scales as m^3 k^2 d + m^2 k^3 d^2
-        L = L * phi.A(i) * K.A(i) * Hp.A(i) * psidag.A(i);
-        //printfln("L%02d = %s",i,L);
-        }
-    //scales as m^2 k^2 d
-    L = L * phi.A(N) * K.A(N) * Hp.A(N) * psidag.A(N);
-    //PrintData(L);
-    auto z = L.cplx();
+        //best order scales as m^3 k^2 d + m^2 k^3 d^2
+        return contractNetwork(E,B(i),V(i),W(i),A(i));
+        };
+    auto z = detail::contractChain(N,Tensor(),Tensor(),nthread,extend);
     re = z.real();
     im = z.imag();
     }
@@ -94,10 +94,10 @@ class MPOt : private MPSt<Tensor>
             }
         }
 
-    void 
+    Spectrum 
     svdBond(int b, const Tensor& AA, Direction dir, const Args& args = Args::global())
         { 
-        Parent::svdBond(b,AA,dir,args + Args("UseSVD",true,"LogRefNorm",logrefNorm_)); 
+        return Parent::svdBond(b,AA,dir,args + Args("UseSVD",true,"LogRefNorm",logrefNorm_)); 
         }
 
     //Move the orthogonality center to site i 
@@ -184,6 +184,13 @@ operator*(Cplx z, MPOt<T> W) { return W *= z; }
 MPO
 toMPO(IQMPO const& K);
 
+//Store the tensors of H keeping only their
+//non-zero entries as matrices over the link
+//indices (see sparseLinks in itensor.h and iqtensor.h)
+template<typename Tensor>
+MPOt<Tensor>
+sparseLinks(MPOt<Tensor> H);
+
 template<typename T>
 bool
 isComplex(MPOt<T> const& W);
@@ -199,10 +206,13 @@ orthoCenter(MPOt<T> const& W);
 int
 findCenter(IQMPO const& psi);
 
-void inline 
-checkQNs(MPO const& psi) { }
+bool inline 
+checkQNs(MPO const& psi) { return true; }
 
-void
+//Returns false, printing the problem found, if a
+//tensor of psi has non-zero divergence or a link
+//arrow does not point towards the ortho. center
+bool
 checkQNs(IQMPO const& psi);
 
 template <class Tensor>
@@ -212,6 +222,11 @@ sum(MPOt<Tensor> L,
     Args const& args = Args::global());
 
 //<psi|H|phi>
+//
+//As for overlap(psi,phi), long chains are contracted
+//from both ends at once if the global Args value
+//"NThread" is 2 or more; the same holds for the
+//versions below.
 template <class Tensor>
 void 
 overlap(MPSt<Tensor> const& psi, 
@@ -273,6 +288,20 @@ overlapC(MPSt<Tensor> const& psi,
          MPOt<Tensor> const& K,
          MPSt<Tensor> const& phi);
 
+//Computes the product of two MPOs, res = A*B, where the
+//primed site indices of A contract with the unprimed
+//site indices of B.
+//
+//Arguments recognized:
+//   "Method": "DensityMatrix" (default) builds the product
+//             site by site from density matrices of the
+//             exact two-MPO clusters, so intermediate bond
+//             dimensions are k_A*k_B. "Fit" calls fitMultMPO.
+//   "Cutoff" (default 1E-14), "Maxm": truncation of res
+//   "Compress" (default false): if true, finish with
+//             compress(res) instead of res.orthogonalize(),
+//             so that "Maxm" also limits the final bonds
+//
 template<class MPOType>
 void 
 nmultMPO(MPOType const& Aorig, 
@@ -280,6 +309,48 @@ nmultMPO(MPOType const& Aorig,
          MPOType& res,
          Args args = Args::global());
 
+//Computes res = A*B (as nmultMPO) by variationally
+//fitting res to the product with two-site sweeps,
+//as in DMRG. Only the environments of res with A and B
+//and the two-site tensors of res are formed, so memory
+//and work scale with the bond dimension of res rather
+//than with that of the exact product. Useful for H^2.
+//
+//If res is null, A is used as the initial guess;
+//otherwise the given res is (which must have the
+//unprimed site indices of A and primed ones of B). Like fitApplyMPO, the fit
+//can get stuck if the guess is poor; use more sweeps
+//or a larger Maxm in that case.
+//
+//Arguments recognized:
+//   "Nsweep" (default 2): number of sweeps
+//   "Maxm", "Cutoff" (default 1E-14): truncation of res
+//   "Verbose" (default false)
+//
+template<class MPOType>
+void
+fitMultMPO(MPOType const& A,
+           MPOType const& B,
+           MPOType& res,
+           Args const& args = Args::global());
+
+//Reduces the bond dimension of an MPO W in place:
+//a sweep of QR decompositions brings W to left-
+//orthogonal form without truncating, then a sweep of
+//SVDs from the right truncates each bond, leaving
+//the orthogonality center on site 1. Truncating this
+//way is optimal in the Frobenius norm of W.
+//
+//Arguments recognized:
+//   "Maxm": target bond dimension
+//   "Cutoff" (default 1E-13): truncation error cutoff
+//   "Verbose" (default false)
+//
+template<class MPOType>
+void
+compress(MPOType & W,
+         Args const& args = Args::global());
+
 template<class Tensor>
 MPSt<Tensor>
 applyMPO(MPOt<Tensor> const& K,
@@ -319,12 +390,34 @@ zipUpApplyMPO(MPSt<Tensor> const& psi,
 //be controllably truncated further by providing
 //optional truncation args "Cutoff" and "Maxm"
 //
+//To reduce memory use for large bond dimensions,
+//the environment tensors can be recomputed instead
+//of stored by setting "Checkpoint" to k > 1 (keeps
+//only every k'th), or written to a temporary
+//directory in "WriteDir" by setting "WriteEnv" to true
+//
 template<class Tensor>
 MPSt<Tensor>
 exactApplyMPO(MPOt<Tensor> const& K,
               MPSt<Tensor> const& x,
               Args const& args = Args::global());
 
+//
+//Applies an MPO K to an MPS x (K|x>) by first forming
+//the exact product of each site tensor of x with that
+//of K, for all sites concurrently (using up to "NThread"
+//threads), then compressing the result: a left-to-right
+//sweep of QR decompositions fixes the gauge without
+//truncating, followed by a right-to-left sweep of SVDs
+//truncating with the args "Cutoff" and "Maxm".
+//Available through applyMPO using "Method"="Parallel".
+//
+template<class Tensor>
+MPSt<Tensor>
+parallelApplyMPO(MPOt<Tensor> const& K,
+                 MPSt<Tensor> const& x,
+                 Args const& args = Args::global());
+
 
 
 //Applies an MPO K to an MPS psi (|res>=K|psi>) using a sweeping/DMRG-like
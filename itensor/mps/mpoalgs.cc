@@ -2,9 +2,11 @@
 // Distributed under the ITensor Library License, Version 1.2
 //    (See accompanying LICENSE file.)
 //
+#include <cstdio>
 #include "itensor/util/print_macro.h"
 #include "itensor/mps/mpo.h"
 #include "itensor/mps/localop.h"
+#include "itensor/contractnetwork.h"
 
 namespace itensor {
 
@@ -30,6 +32,17 @@ nmultMPO(MPOType const& Aorig,
 
     if(!args.defined("Cutoff")) args.add("Cutoff",1E-14);
 
+    auto method = args.getString("Method","DensityMatrix");
+    if(method == "Fit")
+        {
+        fitMultMPO(Aorig,Borig,res,args);
+        return;
+        }
+    else if(method != "DensityMatrix")
+        {
+        Error("nmultMPO currently supports the following methods: 'DensityMatrix' (default), 'Fit' (fitMultMPO)");
+        }
+
     if(Aorig.N() != Borig.N()) Error("nmultMPO(MPOType): Mismatched N");
     const int N = Borig.N();
 
@@ -67,7 +80,7 @@ nmultMPO(MPOType const& Aorig,
             }
         else       
             { 
-            clust = nfork * A.A(i) * B.A(i); 
+            clust = contractNetwork(nfork,A.A(i),B.A(i)); 
             }
 
         if(i == N-1) break;
@@ -97,7 +110,7 @@ nmultMPO(MPOType const& Aorig,
         res.Aref(i+1) = Tensor(mid,siA,siB,rightLinkInd(res,i+1));
         }
 
-    nfork = clust * A.A(N) * B.A(N);
+    nfork = contractNetwork(clust,A.A(N),B.A(N));
 
     res.svdBond(N-1,nfork,Fromright, args);
     for(auto i : range1(N))
@@ -110,13 +123,164 @@ nmultMPO(MPOType const& Aorig,
             }
         res.Aref(i).mapprime(2,1);
         }
-    res.orthogonalize();
+    if(args.getBool("Compress",false)) compress(res,args);
+    else                               res.orthogonalize();
     }
 template
 void nmultMPO(const MPO& Aorig, const MPO& Borig, MPO& res, Args);
 template
 void nmultMPO(const IQMPO& Aorig, const IQMPO& Borig, IQMPO& res,Args);
 
+namespace detail {
+
+//Tensor with all indices of T except I,
+//for passing to qr or svd as Q or V
+template<typename Tensor>
+Tensor
+indsExcept(Tensor const& T,
+           typename Tensor::index_type const& I)
+    {
+    auto inds = std::vector<typename Tensor::index_type>();
+    for(auto& J : T.inds()) if(J != I) inds.push_back(J);
+    return Tensor(inds);
+    }
+
+} //namespace detail
+
+template<class MPOType>
+void
+compress(MPOType & W,
+         Args const& args)
+    {
+    using Tensor = typename MPOType::TensorT;
+    auto N = W.N();
+    if(N < 2) return;
+    if(W.doWrite()) Error("Cannot call compress when doWrite()==true");
+
+    auto sargs = Args{"Cutoff",args.getReal("Cutoff",1E-13)};
+    if(args.defined("Maxm")) sargs.add("Maxm",args.getInt("Maxm"));
+    auto verbose = args.getBool("Verbose",false);
+
+    //Left-to-right gauge fixing, no truncation
+    for(auto j : range1(W.leftLim()+1,N-1))
+        {
+        auto Q = detail::indsExcept(W.A(j),linkInd(W,j));
+        Tensor R;
+        qr(W.A(j),Q,R,{"IndexName",nameint("q",j),"IndexType",Link});
+        W.Aref(j) = Q;
+        W.Aref(j+1) *= R;
+        }
+
+    //Right-to-left truncation
+    for(auto j = N; j > 1; --j)
+        {
+        auto V = detail::indsExcept(W.A(j),linkInd(W,j-1));
+        Tensor U,D;
+        sargs.add("RightIndexName",nameint("l",j-1));
+        auto spec = svd(W.A(j),U,D,V,sargs);
+        if(verbose) printfln("  j=%02d truncerr=%.2E m=%d",j-1,spec.truncerr(),commonIndex(U,D).m());
+        W.Aref(j) = V;
+        W.Aref(j-1) *= U*D;
+        }
+    W.leftLim(0);
+    W.rightLim(2);
+    }
+template
+void compress(MPO& W, Args const&);
+template
+void compress(IQMPO& W, Args const&);
+
+template<class MPOType>
+void
+fitMultMPO(MPOType const& A,
+           MPOType const& B,
+           MPOType& res,
+           Args const& args)
+    {
+    using Tensor = typename MPOType::TensorT;
+    auto N = A.N();
+    if(B.N() != N) Error("fitMultMPO: Mismatched N");
+    if(N < 2) Error("fitMultMPO requires at least two sites");
+    if(&res == &A || &res == &B) Error("fitMultMPO: Result MPO cannot be same as an input MPO");
+
+    auto nsweep = args.getInt("Nsweep",2);
+    auto verbose = args.getBool("Verbose",false);
+    auto sargs = Args{"Cutoff",args.getReal("Cutoff",1E-14)};
+    if(args.defined("Maxm")) sargs.add("Maxm",args.getInt("Maxm"));
+
+    //Copies of the site tensors (sharing storage) with
+    //the links of A and B primed apart from those of res,
+    //and the sites of B primed so that A*B has sites s,s''
+    auto primeLinks = [N](Tensor T, MPOType const& W, int j, int inc)
+        {
+        if(j > 1) T.prime(linkInd(W,j-1),inc);
+        if(j < N) T.prime(linkInd(W,j),inc);
+        return T;
+        };
+    auto Ap = std::vector<Tensor>(N+1),
+         Bp = std::vector<Tensor>(N+1);
+    for(auto j : range1(N))
+        {
+        Ap.at(j) = primeLinks(A.A(j),A,j,2);
+        Bp.at(j) = prime(primeLinks(B.A(j),B,j,3));
+        }
+
+    //Initial guess, by default A with its primed site
+    //indices replaced by the primed site indices of B
+    if(!res || res.N() != N) 
+        {
+        res = A;
+        for(auto j : range1(N))
+            {
+            auto K = commonIndex(Ap.at(j),Bp.at(j));
+            auto J = (j == 1) ? uniqueIndex(Bp.at(j),Ap.at(j),Bp.at(j+1))
+                   : (j == N) ? uniqueIndex(Bp.at(j),Ap.at(j),Bp.at(j-1))
+                   : uniqueIndex(Bp.at(j),Ap.at(j),Bp.at(j-1),Bp.at(j+1));
+            if(J.noprimeEquals(K)) res.Aref(j).prime(K,J.primeLevel()-K.primeLevel());
+            else                   res.Aref(j) *= delta(dag(K),J);
+            }
+        }
+    else
+        {
+        for(auto j : range1(N)) res.Aref(j).mapprime(1,2,Site);
+        }
+    res.position(1);
+
+    auto extend = [&](Tensor const& E, int j)
+        {
+        return contractNetwork(E,Ap.at(j),Bp.at(j),dag(res.A(j)));
+        };
+
+    auto L = std::vector<Tensor>(N+2),
+         R = std::vector<Tensor>(N+2);
+    for(auto j = N; j > 2; --j) R.at(j) = extend(R.at(j+1),j);
+
+    for(auto sw : range1(nsweep))
+        {
+        for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N))
+            {
+            auto phi = contractNetwork(L.at(b-1),Ap.at(b),Bp.at(b),
+                                       Ap.at(b+1),Bp.at(b+1),R.at(b+2));
+            auto spec = res.svdBond(b,phi,(ha==1?Fromleft:Fromright),sargs);
+            if(verbose)
+                {
+                printfln("Sweep=%d, HS=%d, Bond=(%d,%d), Trunc. err=%.1E, m=%d",
+                         sw,ha,b,b+1,spec.truncerr(),linkInd(res,b).m());
+                }
+            if(ha == 1) L.at(b) = extend(L.at(b-1),b);
+            else        R.at(b+1) = extend(R.at(b+2),b+1);
+            }
+        }
+
+    for(auto j : range1(N)) res.Aref(j).mapprime(2,1,Site);
+    res.leftLim(0);
+    res.rightLim(2);
+    }
+template
+void fitMultMPO(MPO const& A, MPO const& B, MPO& res, Args const&);
+template
+void fitMultMPO(IQMPO const& A, IQMPO const& B, IQMPO& res, Args const&);
+
 template<class Tensor>
 MPSt<Tensor>
 applyMPO(MPOt<Tensor> const& K,
@@ -136,8 +300,10 @@ applyMPO(MPOt<Tensor> const& K,
         res = exactApplyMPO(K,x,argsp);
     else if(method == "Fit")
         res = fitApplyMPO(x,K,argsp);
+    else if(method == "Parallel")
+        res = parallelApplyMPO(K,x,argsp);
     else
-        Error("applyMPO currently supports the following methods: 'DensityMatrix' (previously called with exactApplyMPO), 'Fit' (previously called with fitApplyMPO)");
+        Error("applyMPO currently supports the following methods: 'DensityMatrix' (previously called with exactApplyMPO), 'Fit' (previously called with fitApplyMPO), 'Parallel' (parallelApplyMPO)");
 
     return res;
     }
@@ -206,42 +372,69 @@ exactApplyMPO(MPOt<Tensor> const& K,
 
     auto N = psi.N();
 
-    //Set up conjugate psi and K
-    auto psic = psi;
-    auto Kc = K;
-    for(auto j : range1(N)) 
+    //Conjugate of site j of psi or K with relabelled
+    //prime levels. Made only when needed, sharing
+    //storage with A unless complex conjugation is required.
+    auto conj = [&](Tensor const& A, Tensor const& Anext, int j)
         {
-        //Modify prime levels of psic and Kc
         if(j == 1)
             {
-            auto ci = commonIndex(psi.A(1),psi.A(2),linkType);
-            psic.Aref(j) = dag(mapprime(psi.A(j),siteType,0,2,ci,0,plev));
-            ci = commonIndex(Kc.A(1),Kc.A(2),linkType);
-            Kc.Aref(j) = dag(mapprime(K.A(j),siteType,0,2,ci,0,plev));
+            auto ci = commonIndex(A,Anext,linkType);
+            return dag(mapprime(A,siteType,0,2,ci,0,plev));
             }
-        else
-            {
-            psic.Aref(j) = dag(mapprime(psi.A(j),siteType,0,2,linkType,0,plev));
-            Kc.Aref(j) = dag(mapprime(K.A(j),siteType,0,2,linkType,0,plev));
-            }
-        }
+        return dag(mapprime(A,siteType,0,2,linkType,0,plev));
+        };
+    auto extend = [&](Tensor const& L, int j)
+        {
+        return contractNetwork(L,psi.A(j),K.A(j),
+                               conj(K.A(j),K.A(j+1),j),
+                               conj(psi.A(j),psi.A(j+1),j));
+        };
+
+    //Environment tensors from the left, E[j] including sites 1..j.
+    //By default all are kept in memory. With "Checkpoint" > 1, only
+    //every Checkpoint'th is kept and the others recomputed as needed;
+    //with "WriteEnv" they are written to disk in "WriteDir".
+    auto every = std::max(1l,args.getInt("Checkpoint",1));
+    auto write_env = args.getBool("WriteEnv",false);
+    auto writedir = write_env ? mkTempDir("EnvApply",args.getString("WriteDir","./")) : string();
+    auto envFName = [&writedir](int j) { return format("%s/E_%03d",writedir,j); };
 
-    //Build environment tensors from the left
     if(verbose) print("Building environment tensors...");
-    auto E = std::vector<Tensor>(N+1);
-    E.at(1) = psi.A(1)*K.A(1)*Kc.A(1)*psic.A(1);
-    for(int j = 2; j < N; ++j)
+    auto E = std::vector<Tensor>(N);
+    auto L = Tensor();
+    for(int j = 1; j < N; ++j)
         {
-        E.at(j) = E.at(j-1)*psi.A(j)*K.A(j)*Kc.A(j)*psic.A(j);
-        //assert(rank(E[j])==4);
+        L = extend(L,j);
+        if(j == N-1) E.at(j) = std::move(L);
+        else if(write_env) writeToFile(envFName(j),L);
+        else if(j % every == 0) E.at(j) = L;
         }
     if(verbose) println("done");
 
+    //Returns E[j], for j decreasing from N-1 to 1,
+    //freeing E[j+1] which is no longer needed
+    auto env = [&](int j) -> Tensor const&
+        {
+        if(j+1 < N) E.at(j+1) = Tensor();
+        if(E.at(j)) return E.at(j);
+        if(write_env)
+            {
+            readFromFile(envFName(j),E.at(j));
+            std::remove(envFName(j).c_str());
+            return E.at(j);
+            }
+        //Recompute from the nearest checkpoint c < j
+        //(E[0] is an empty tensor)
+        for(auto k = j-j%every+1; k <= j; ++k) E.at(k) = extend(E.at(k-1),k);
+        return E.at(j);
+        };
+
     //O is the representation of the product of K*psi in the new MPS basis
     auto O = psi.A(N)*K.A(N);
     O.noprime(siteType);
 
-    auto rho = E.at(N-1) * O * dag(prime(O,plev));
+    auto rho = env(N-1) * O * dag(prime(O,plev));
     Tensor U,D;
     dargs.add("IndexName=",nameint("a",N));
     auto spec = diagHermitian(rho,U,D,dargs);
@@ -259,13 +452,13 @@ exactApplyMPO(MPOt<Tensor> const& K,
             //Infer maxm from bond dim of original MPS
             //times bond dim of MPO
             //i.e. upper bound on rank of rho
-            auto cip = commonIndex(psi.A(j),E.at(j-1));
-            auto ciw = commonIndex(K.A(j),E.at(j-1));
+            auto cip = commonIndex(psi.A(j),env(j-1));
+            auto ciw = commonIndex(K.A(j),env(j-1));
             auto maxm = (cip) ? cip.m() : 1l;
             maxm *= (ciw) ? ciw.m() : 1l;
             dargs.add("Maxm",maxm);
             }
-        rho = E.at(j-1) * O * dag(prime(O,plev));
+        rho = env(j-1) * O * dag(prime(O,plev));
         dargs.add("IndexName=",nameint("a",j));
         auto spec = diagHermitian(rho,U,D,dargs);
         O = O*U*psi.A(j-1)*K.A(j-1);
@@ -274,6 +467,8 @@ exactApplyMPO(MPOt<Tensor> const& K,
         if(verbose) printfln("  j=%02d truncerr=%.2E m=%d",j,spec.truncerr(),commonIndex(U,D).m());
         }
 
+    if(write_env) std::remove(writedir.c_str());
+
     if(normalize) O /= norm(O);
     res.Aref(1) = O;
     res.leftLim(0);
@@ -288,6 +483,92 @@ template
 IQMPS
 exactApplyMPO(IQMPO const& K, IQMPS const& x, Args const&);
 
+template<class Tensor>
+MPSt<Tensor>
+parallelApplyMPO(MPOt<Tensor> const& K,
+                 MPSt<Tensor> const& psi,
+                 Args const& args)
+    {
+    auto N = psi.N();
+    if(K.N() != N) Error("Mismatched N in parallelApplyMPO");
+    if(N < 2) Error("parallelApplyMPO requires at least two sites");
+    auto nthread = getNThread(args);
+    auto normalize = args.getBool("Normalize",false);
+    auto verbose = args.getBool("Verbose",false);
+    auto sargs = Args{"Cutoff",args.getReal("Cutoff",1E-13)};
+    if(args.defined("Maxm")) sargs.add("Maxm",args.getInt("Maxm"));
+
+    //Combiners merging the links of psi and K on each bond
+    auto C = std::vector<Tensor>(N);
+    for(auto b : range1(N-1))
+        {
+        C.at(b) = combiner({linkInd(psi,b),linkInd(K,b)},{"IndexName",nameint("a",b)});
+        }
+
+    //Fetch the site tensors here: A() is not safe to call
+    //from several threads (it moves the position of the
+    //tensors held in memory, or on disk if doWrite() is on)
+    auto B = std::vector<Tensor>(N+1);
+    auto KA = std::vector<Tensor>(N+1);
+    for(auto j : range1(N))
+        {
+        B.at(j) = psi.A(j);
+        KA.at(j) = K.A(j);
+        }
+
+    //Exact product of site tensors
+    parallelFor(N,nthread,[&](size_t n)
+        {
+        auto j = int(n)+1;
+        auto T = B.at(j)*KA.at(j);
+        T.mapprime(1,0,Site);
+        if(j > 1) T *= dag(C.at(j-1));
+        if(j < N) T *= C.at(j);
+        B.at(j) = std::move(T);
+        });
+
+    //Left-to-right gauge fixing, no truncation
+    for(auto j : range1(N-1))
+        {
+        auto Q = Tensor(findtype(B.at(j),Site));
+        if(j > 1) Q = Tensor(findtype(B.at(j),Site),commonIndex(B.at(j),B.at(j-1)));
+        Tensor R;
+        qr(B.at(j),Q,R,{"IndexName",nameint("q",j)});
+        B.at(j) = std::move(Q);
+        B.at(j+1) = R*B.at(j+1);
+        }
+
+    //Right-to-left truncation
+    auto res = psi;
+    //res is held in memory even when psi is written to disk
+    res.doWrite(false);
+    for(auto j = N; j > 1; --j)
+        {
+        auto V = Tensor(findtype(B.at(j),Site));
+        if(j < N) V = Tensor(findtype(B.at(j),Site),commonIndex(B.at(j),res.A(j+1)));
+        Tensor U,D;
+        sargs.add("RightIndexName",nameint("a",j-1));
+        auto spec = svd(B.at(j),U,D,V,sargs);
+        if(verbose) printfln("  j=%02d truncerr=%.2E m=%d",j-1,spec.truncerr(),commonIndex(U,D).m());
+        res.Aref(j) = V;
+        B.at(j-1) *= U*D;
+        B.at(j) = Tensor();
+        }
+
+    if(normalize) B.at(1) /= norm(B.at(1));
+    res.Aref(1) = B.at(1);
+    res.leftLim(0);
+    res.rightLim(2);
+
+    return res;
+    }
+template
+MPS
+parallelApplyMPO(MPO const& K, MPS const& x, Args const&);
+template
+IQMPS
+parallelApplyMPO(IQMPO const& K, IQMPS const& x, Args const&);
+
 template<class Tensor>
 MPSt<Tensor>
 exactApplyMPO(MPSt<Tensor> const& x,
@@ -835,7 +1116,7 @@ zipUpApplyMPO(MPSt<Tensor> const& psi,
 
 #ifdef DEBUG
     checkQNs(psi);
-    checkQNs(K);
+    if(!checkQNs(K)) Error("Incorrect QNs in IQMPO");
     /*
     cout << "Checking divergence in zip" << endl;
     for(int i = 1; i <= N; i++)
@@ -6,6 +6,7 @@
 #define __ITENSOR_MPS_H
 #include "itensor/decomp.h"
 #include "itensor/mps/siteset.h"
+#include "itensor/util/threading.h"
 
 namespace itensor {
 
@@ -428,6 +429,10 @@ Real
 overlap(MPSType const& psi, MPSType const& phi);
 
 // <psi|phi>
+//
+// For long chains, the left and right halves are
+// contracted concurrently when the global Args
+// value "NThread" (default: 1) is 2 or more.
 template <class MPSType>
 Cplx 
 overlapC(MPSType const& psi, 
@@ -246,30 +246,124 @@ checkOrtho(MPSt<Tensor> const& psi)
     return true;
     }
 
+namespace detail {
+
+//Chains with fewer sites are always
+//contracted serially from the left
+const int ChainSplitMin = 8;
+
+//
+// Site tensors of an MPS or MPO used by
+// contractChain. MPSt::A() moves the bond the
+// tensors are held around (reading and writing
+// them to disk if doWrite() is on), so it must
+// not be called from several threads. If fetch
+// is true, shallow copies of all site tensors are
+// made on the calling thread; otherwise A(i) is
+// called directly, which is only safe serially.
+//
+template<typename MPSType>
+class ChainSites
+    {
+    using Tensor = typename MPSType::TensorT;
+    MPSType const* psi_ = nullptr;
+    std::vector<Tensor> A_;
+    public:
+
+    ChainSites(MPSType const& psi,
+               int N,
+               bool fetch)
+      : psi_(&psi)
+        { 
+        if(!fetch) return;
+        A_.resize(N+1);
+        for(auto i : range1(N)) A_[i] = psi.A(i);
+        }
+
+    Tensor const&
+    operator()(int i) const { return A_.empty() ? psi_->A(i) : A_[i]; }
+    };
+
+//Number of threads for contractChain: 
+//serial if any operand is written to disk
+int inline
+chainThreads(std::initializer_list<bool> do_write)
+    {
+    for(auto w : do_write) if(w) return 1;
+    return getNThread(Args::global());
+    }
+
+//
+// Contracts a closed chain of N sites, where
+// extend(E,i) returns the environment E times
+// the tensors of site i (E may be a null tensor
+// at the ends of the chain).
+// LB and RB are optional edge tensors.
+//
+// If nthread >= 2 the left half is contracted from
+// the left end and the right half from the right end
+// at the same time, and the two are joined in the
+// middle. Splitting into more pieces would create
+// tensors with both bonds of a segment open, costing
+// more than the serial contraction.
+//
+// With nthread >= 2, extend must not call A()
+// of an MPS or MPO, but use ChainSites instead.
+//
+template<typename Tensor, typename Extend>
+Cplx
+contractChain(int N,
+              Tensor const& LB,
+              Tensor const& RB,
+              int nthread,
+              Extend const& extend)
+    {
+    auto L = LB;
+    if(N < ChainSplitMin || nthread < 2)
+        {
+        for(auto i : range1(N)) L = extend(L,i);
+        if(RB) L *= RB;
+        return L.cplx();
+        }
+    auto mid = N/2;
+    auto R = RB;
+    parallelFor(2,2,[&](size_t n)
+        {
+        if(n == 0) 
+            {
+            for(auto i : range1(mid)) L = extend(L,i);
+            }
+        else
+            {
+            for(auto i = N; i > mid; --i) R = extend(R,i);
+            }
+        });
+    return (L*R).cplx();
+    }
+
+} //namespace detail
+
 template <class MPSType>
 Cplx 
 overlapC(MPSType const& psi, 
          MPSType const& phi)
     {
+    using Tensor = typename MPSType::TensorT;
     auto N = psi.N();
     if(N != phi.N()) Error("overlap: mismatched N");
 
-    auto l1 = linkInd(psi,1);
-    auto L = phi.A(1);
-    if(l1) L *= dag(prime(psi.A(1),l1)); 
-    else   L *= dag(psi.A(1));
-
-    if(N == 1) return L.cplx();
-
-    for(decltype(N) i = 2; i < N; ++i) 
-        { 
-        L = L * phi.A(i) * dag(prime(psi.A(i),Link)); 
-        }
-    L = L * phi.A(N);
-
-    auto lNm = linkInd(psi,N-1);
-    if(lNm) return (dag(prime(psi.A(N),lNm))*L).cplx();
-    return (dag(psi.A(N))*L).cplx();
+    auto nthread = detail::chainThreads({psi.doWrite(),phi.doWrite()});
+    auto A = detail::ChainSites<MPSType>(psi,N,nthread > 1);
+    auto B = detail::ChainSites<MPSType>(phi,N,nthread > 1);
+    auto extend = [&A,&B,N](Tensor const& E, int i)
+        {
+        auto bra = dag(A(i));
+        if(i > 1) if(auto l = commonIndex(A(i),A(i-1),Link)) bra.prime(l);
+        if(i < N) if(auto l = commonIndex(A(i),A(i+1),Link)) bra.prime(l);
+        if(!E) return B(i)*bra;
+        return (E*B(i))*bra;
+        };
+    return detail::contractChain(N,Tensor(),Tensor(),nthread,extend);
     }
 
 template <class MPSType>
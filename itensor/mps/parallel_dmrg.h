@@ -0,0 +1,413 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_PARALLEL_DMRG_H
+#define __ITENSOR_PARALLEL_DMRG_H
+
+#include "itensor/util/parallel.h"
+#include "itensor/mps/idmrg.h"
+
+//
+// Real-space parallel DMRG
+// (E.M. Stoudenmire and S.R. White, PRB 87, 155137 (2013))
+//
+// The chain is split into one block of consecutive
+// sites per MPI node. Each node sweeps its own block
+// with a LocalMPO capped off by boundary environments;
+// neighboring nodes meet at the bond between their
+// blocks, where the left node optimizes the two-site
+// wavefunction and both nodes exchange the new
+// boundary site tensor and environment.
+//
+// The wavefunction across a block boundary is stored as
+//
+//   ... A(e) V A(e+1) ...
+//
+// where A(e) = U*S, A(e+1) = S*Vt and V = S^{-1},
+// so each node can keep working with its own copy of
+// the singular values while the other one sweeps.
+//
+// Blocks alternate between sweeping right and left
+// such that even nodes and their right neighbors
+// meet in the middle of every sweep, and odd nodes
+// and their right neighbors at the end.
+//
+// Usage (compile with mpicxx, run with mpirun -np N):
+//
+//   Environment env(argc,argv);
+//   auto sites = SpinHalf();
+//   auto H = MPO();
+//   auto psi = MPS();
+//   if(env.firstNode())
+//       {
+//       sites = SpinHalf(N);
+//       ... //make H and psi
+//       }
+//   env.broadcast(sites,H,psi);
+//   auto energy = parallelDMRG(env,psi,H,sweeps,{"Quiet",true});
+//
+// psi and H must be the same (with the same indices)
+// on every node, so build them on the first node and
+// broadcast them. Every node needs at least two sites.
+//
+// On return the first node holds the full optimized
+// MPS, normalized and orthogonalized to site 1. The
+// other nodes only hold their own block. The energy
+// is returned on every node.
+//
+// Named arguments recognized:
+//
+// Quiet - if true, do not print sweep information
+//         (default false)
+// InverseCut - singular values smaller than this are
+//              dropped when computing V = S^{-1}
+//              (default 1E-8)
+//
+
+namespace itensor {
+
+template<class Tensor>
+Real
+parallelDMRG(Environment const& env,
+             MPSt<Tensor> & psi,
+             MPOt<Tensor> const& H,
+             Sweeps const& sweeps,
+             Args args = Args::global());
+
+namespace detail {
+
+//First and last site of the block
+//of node n out of nnodes
+inline std::pair<int,int>
+pdmrgBlock(int N, int nnodes, int n)
+    {
+    auto size = N/nnodes,
+         rem = N%nnodes;
+    auto b = 1+n*size+std::min(n,rem);
+    auto e = b+size-1+(n < rem ? 1 : 0);
+    return std::make_pair(b,e);
+    }
+
+template<class Tensor>
+Tensor
+pseudoInverse(Tensor const& S, Real cut)
+    {
+    auto V = dag(S);
+    V.apply(PseudoInvert(cut));
+    return V;
+    }
+
+//
+// Data sent to each node at the start of
+// parallel DMRG: boundary environments, the
+// inverse singular values and site tensor just
+// past the right end of the block, and the
+// block tensors
+//
+template<class Tensor>
+struct PDMRGBlock
+    {
+    Tensor LH, //left environment, sites < b
+           RH, //right environment, sites > e+1
+           V,  //inverse singular values at bond e
+           A1; //V*A(e+1) (right-orthogonal)
+    std::vector<Tensor> A;
+
+    void
+    write(std::ostream& s) const
+        {
+        itensor::write(s,LH);
+        itensor::write(s,RH);
+        itensor::write(s,V);
+        itensor::write(s,A1);
+        itensor::write(s,A);
+        }
+
+    void
+    read(std::istream& s)
+        {
+        itensor::read(s,LH);
+        itensor::read(s,RH);
+        itensor::read(s,V);
+        itensor::read(s,A1);
+        itensor::read(s,A);
+        }
+    };
+
+//
+// Bring psi (on the first node only) into the
+// form ... A(e) V A(e+1) ... at every block
+// boundary, with each block right-orthogonal
+// and its first site holding S*Vt, and compute
+// the boundary environments of every block
+//
+template<class Tensor>
+std::vector<PDMRGBlock<Tensor>>
+pdmrgSplit(MPSt<Tensor> & psi,
+           MPOt<Tensor> const& H,
+           int nnodes,
+           Real inverse_cut)
+    {
+    auto N = psi.N();
+    auto blocks = std::vector<PDMRGBlock<Tensor>>(nnodes);
+    auto isEnd = std::vector<int>(N+2,-1);   //isEnd[e] = n if e is the last site of node n
+    auto isBegin = std::vector<int>(N+2,-1); //isBegin[b] = n if b is the first site of node n
+    for(auto n : range(nnodes))
+        {
+        auto be = pdmrgBlock(N,nnodes,n);
+        isBegin.at(be.first) = n;
+        isEnd.at(be.second) = n;
+        }
+
+    psi.position(N);
+
+    //Left environments of sites < e
+    //(all left-orthogonal at this point)
+    auto Lpos = std::vector<Tensor>(nnodes);
+    auto elast = (nnodes > 1) ? pdmrgBlock(N,nnodes,nnodes-2).second : 0;
+    Tensor L;
+    for(auto j : range1(elast))
+        {
+        auto n = isEnd.at(j);
+        if(n >= 0) Lpos.at(n) = L;
+        L = contractNetwork(L,psi.A(j),H.A(j),dag(prime(psi.A(j))));
+        }
+
+    //Sweep the orthogonality center back to site 1,
+    //keeping the singular values at block boundaries
+    for(auto j = N-1; j >= 1; --j)
+        {
+        auto phi = psi.A(j)*psi.A(j+1);
+        Tensor U = psi.A(j), S, Vt;
+        svd(phi,U,S,Vt,{"Cutoff",1E-14});
+        S /= norm(S);
+        auto n = isEnd.at(j);
+        if(n >= 0)
+            {
+            psi.Aref(j+1) = S*Vt;
+            blocks.at(n).V = pseudoInverse(S,inverse_cut);
+            blocks.at(n+1).LH = contractNetwork(Lpos.at(n),U,H.A(j),dag(prime(U)));
+            }
+        else
+            {
+            psi.Aref(j+1) = Vt;
+            }
+        psi.Aref(j) = U*S;
+        }
+
+    //Right environments of sites > e+1 made
+    //from the right-orthogonal V*A(b) and A(j>b)
+    auto efirst = pdmrgBlock(N,nnodes,0).second;
+    Tensor R;
+    for(auto j = N; j > efirst; --j)
+        {
+        auto n = isEnd.at(j-1);
+        if(n >= 0) blocks.at(n).RH = R;
+        auto Aj = psi.A(j);
+        auto m = isBegin.at(j);
+        if(m > 0)
+            {
+            Aj = blocks.at(m-1).V*Aj;
+            blocks.at(m-1).A1 = Aj;
+            }
+        if(j > efirst+1) R = contractNetwork(R,Aj,H.A(j),dag(prime(Aj)));
+        }
+
+    for(auto n : range(nnodes))
+        {
+        auto be = pdmrgBlock(N,nnodes,n);
+        for(auto j : range1(be.first,be.second)) blocks.at(n).A.push_back(psi.A(j));
+        }
+    return blocks;
+    }
+
+} //namespace detail
+
+template<class Tensor>
+Real
+parallelDMRG(Environment const& env,
+             MPSt<Tensor> & psi,
+             MPOt<Tensor> const& H,
+             Sweeps const& sweeps,
+             Args args)
+    {
+    const bool quiet = args.getBool("Quiet",false);
+    const auto inverse_cut = args.getReal("InverseCut",1E-8);
+
+    const auto N = psi.N();
+    const auto nnodes = env.nnodes();
+    const auto node = env.rank();
+    if(N < 2*nnodes) Error(format("parallelDMRG: need at least 2 sites per node (N=%d, nodes=%d)",N,nnodes));
+
+    auto be = detail::pdmrgBlock(N,nnodes,node);
+    const auto b = be.first,
+               e = be.second;
+    const auto has_left = (node > 0),
+               has_right = (node < nnodes-1);
+
+    //
+    // Split psi on the first node and send
+    // each node the data for its block
+    //
+    auto blk = detail::PDMRGBlock<Tensor>();
+    if(env.firstNode())
+        {
+        auto blocks = detail::pdmrgSplit(psi,H,nnodes,inverse_cut);
+        for(auto n : range1(nnodes-1))
+            {
+            MailBox mbox(env,n);
+            mbox.send(blocks.at(n));
+            }
+        blk = std::move(blocks.front());
+        }
+    else
+        {
+        MailBox mbox(env,0);
+        mbox.receive(blk);
+        }
+    for(auto j : range1(b,e)) psi.Aref(j) = std::move(blk.A.at(j-b));
+    if(has_right) psi.Aref(e+1) = blk.A1;
+    auto V = blk.V;
+
+    auto Lmbox = std::unique_ptr<MailBox>(has_left ? new MailBox(env,node-1) : nullptr);
+    auto Rmbox = std::unique_ptr<MailBox>(has_right ? new MailBox(env,node+1) : nullptr);
+
+    auto PH = LocalMPO<Tensor>(H,blk.LH,b-1,blk.RH,has_right ? e+2 : N+1,args);
+    blk = detail::PDMRGBlock<Tensor>();
+
+    args.add("DoNormalize",true);
+
+    Real energy = NAN;
+
+    //Sweep the bonds of this block from
+    //the left edge to the right edge
+    //(dir == Fromleft) or back
+    auto sweepBlock = [&](Direction dir)
+        {
+        psi.leftLim(dir == Fromleft ? b-1 : e-1);
+        psi.rightLim(dir == Fromleft ? b+1 : e+1);
+        for(auto n : range(e-b))
+            {
+            auto j = (dir == Fromleft) ? b+n : e-1-n;
+            PH.position(j,psi);
+            auto phi = psi.A(j)*psi.A(j+1);
+            energy = davidson(PH,phi,args);
+            psi.svdBond(j,phi,dir,PH,args);
+            }
+        };
+
+    //Optimize the bond between the last site
+    //of this block and the first of the next
+    auto leftBoundary = [&]()
+        {
+        auto R = Rmbox->receive<Tensor>();
+        auto A1 = Rmbox->receive<Tensor>();
+        psi.Aref(e+1) = V*A1;
+        PH.R(e+1,R);
+        PH.position(e,psi);
+        auto phi = psi.A(e)*psi.A(e+1);
+        energy = davidson(PH,phi,args);
+
+        //Noise is only used inside the blocks
+        Tensor U = psi.A(e), S, Vt;
+        svd(phi,U,S,Vt,{args,"Noise",0.});
+        S /= norm(S);
+        psi.Aref(e) = U*S;
+        psi.Aref(e+1) = Vt;
+        V = detail::pseudoInverse(S,inverse_cut);
+
+        //Overlap sending S*Vt with computing
+        //the next node's left environment
+        auto req = Rmbox->isend(S*Vt);
+        Rmbox->send(contractNetwork(PH.L(),U,H.A(e),dag(prime(U))));
+        };
+
+    //Let the previous node optimize the bond
+    //between its block and this one
+    auto rightBoundary = [&]()
+        {
+        PH.position(b,psi);
+        auto& A = psi.A(b+1);
+        Lmbox->send(contractNetwork(PH.R(),A,H.A(b+1),dag(prime(A))));
+        Lmbox->send(psi.A(b));
+        psi.Aref(b) = Lmbox->receive<Tensor>();
+        PH.L(b,Lmbox->receive<Tensor>());
+        };
+
+    const auto even = (node%2 == 0);
+    for(auto sw : range1(sweeps.nsweep()))
+        {
+        cpu_time sw_time;
+        args.add("Sweep",sw);
+        args.add("Cutoff",sweeps.cutoff(sw));
+        args.add("Minm",sweeps.minm(sw));
+        args.add("Maxm",sweeps.maxm(sw));
+        args.add("Noise",sweeps.noise(sw));
+        args.add("MaxIter",sweeps.niter(sw));
+
+        //Even nodes meet their right neighbors...
+        if(even)
+            {
+            sweepBlock(Fromleft);
+            if(has_right) leftBoundary();
+            sweepBlock(Fromright);
+            }
+        else
+            {
+            if(sw > 1) sweepBlock(Fromright);
+            rightBoundary();
+            sweepBlock(Fromleft);
+            }
+        //...then odd nodes do
+        if(even)
+            {
+            if(has_left) rightBoundary();
+            }
+        else
+            {
+            if(has_right) leftBoundary();
+            }
+
+        if(!quiet && env.firstNode())
+            {
+            auto sm = sw_time.sincemark();
+            printfln("    Sweep %d/%d: energy = %.14f, wall time = %s",
+                     sw,sweeps.nsweep(),energy,showtime(sm.wall));
+            }
+        }
+
+    //
+    // Collect the blocks on the first node,
+    // absorbing V into the last site of each block
+    //
+    if(has_right) psi.Aref(e) *= V;
+    if(env.firstNode())
+        {
+        for(auto n : range1(nnodes-1))
+            {
+            MailBox mbox(env,n);
+            auto A = mbox.receive<std::vector<Tensor>>();
+            auto nb = detail::pdmrgBlock(N,nnodes,n).first;
+            for(auto j : range(A)) psi.Aref(nb+j) = std::move(A[j]);
+            }
+        psi.leftLim(0);
+        psi.rightLim(N+1);
+        psi.position(1);
+        psi.normalize();
+        }
+    else
+        {
+        auto A = std::vector<Tensor>();
+        for(auto j : range1(b,e)) A.push_back(psi.A(j));
+        MailBox mbox(env,0);
+        mbox.send(A);
+        }
+
+    broadcast(env,energy);
+    return energy;
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,99 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SU2SPINHALF_H
+#define __ITENSOR_SU2SPINHALF_H
+#include "itensor/mps/siteset.h"
+#include "itensor/su2tensor.h"
+
+namespace itensor {
+
+//
+// Spin 1/2 sites for SU(2) symmetric tensors
+// (see su2tensor.h). Each site index has a
+// single sector, one spin 1/2 multiplet.
+//
+// Operators are given by their reduced matrix
+// elements divided by sqrt(2j+1), so that "Id"
+// (made by SiteSet) is 1: times sqrt(2), they are
+// the <1/2||T^k||1/2> taken by wignerEckart in
+// su2.h. "S2" has k=0, and the spin vector "S" has
+// k=1, with Sz as its q=0 component.
+//
+// The site indices are what SU2Tensor MPS
+// tensors are built from. The operators cannot
+// be used with AutoMPO, MPO or the measurement
+// routines, which assume abelian quantum
+// numbers; they only record the reduced
+// elements, for example to check a Wigner-Eckart
+// evaluation. The header is not part of all.h.
+//
+
+class SU2SpinHalfSite;
+
+using SU2SpinHalf = BasicSiteSet<SU2SpinHalfSite>;
+
+class SU2SpinHalfSite
+    {
+    IQIndex s;
+    public:
+
+    SU2SpinHalfSite() { }
+
+    SU2SpinHalfSite(IQIndex I) : s(I) { }
+
+    SU2SpinHalfSite(int n, Args const& args = Args::global())
+        {
+        s = su2Index(nameint("S=1/2 ",n),{{1,1}},Site);
+        }
+
+    IQIndex
+    index() const { return s; }
+
+    IQIndexVal
+    state(std::string const& state)
+        {
+        if(state == "S=1/2")
+            {
+            return s(1);
+            }
+        else
+            {
+            Error("State " + state + " not recognized");
+            }
+        return IQIndexVal{};
+        }
+
+	IQTensor
+	op(std::string const& opname,
+	   Args const& args) const
+        {
+        auto sP = prime(s);
+
+        auto S = s(1);
+        auto SP = sP(1);
+
+        auto Op = IQTensor(dag(s),sP);
+
+        if(opname == "S")
+            {
+            Op.set(S,SP,std::sqrt(3.)/2.);
+            }
+        else
+        if(opname == "S2")
+            {
+            Op.set(S,SP,0.75);
+            }
+        else
+            {
+            Error("Operator \"" + opname + "\" name not recognized");
+            }
+
+        return Op;
+        }
+    };
+
+} //namespace itensor
+
+#endif
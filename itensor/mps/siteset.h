@@ -4,10 +4,111 @@
 //
 #ifndef __ITENSOR_SITESET_H
 #define __ITENSOR_SITESET_H
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include "itensor/iqtensor.h"
 
 namespace itensor {
 
+//
+// OpName is an interned operator name.
+// Constructing an OpName from a string looks it
+// up in a global table (adding it if not found),
+// after which copying, hashing and testing for 
+// equality cost as much as for a pointer.
+// Converts implicitly to std::string const&.
+//
+class OpName
+    {
+    std::string const* name_;
+    public:
+
+    OpName();
+
+    OpName(std::string const& name);
+
+    OpName(const char* name);
+
+    std::string const&
+    str() const { return *name_; }
+
+    operator std::string const&() const { return *name_; }
+
+    //Unique for each distinct name
+    size_t
+    id() const { return reinterpret_cast<size_t>(name_); }
+
+    bool
+    empty() const { return name_->empty(); }
+
+    size_t
+    size() const { return name_->size(); }
+
+    char
+    front() const { return name_->front(); }
+
+    std::string::const_iterator
+    begin() const { return name_->begin(); }
+
+    std::string::const_iterator
+    end() const { return name_->end(); }
+
+    bool
+    operator==(OpName const& o) const { return name_ == o.name_; }
+
+    bool
+    operator!=(OpName const& o) const { return name_ != o.name_; }
+
+    //Alphabetical order
+    bool
+    operator<(OpName const& o) const { return name_ != o.name_ && *name_ < *o.name_; }
+
+    bool
+    operator>(OpName const& o) const { return o < *this; }
+    };
+
+namespace detail {
+
+//Returns the address of the unique copy of name
+//held in a global table; addresses of elements 
+//of unordered_set are stable under insertion
+inline std::string const*
+internOpName(std::string const& name)
+    {
+    static std::mutex mutex;
+    static std::unordered_set<std::string> table;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &(*table.insert(name).first);
+    }
+
+} //namespace detail
+
+inline OpName::
+OpName()
+    {
+    static std::string const* empty_name = detail::internOpName("");
+    name_ = empty_name;
+    }
+
+inline OpName::
+OpName(std::string const& name)
+  : name_(detail::internOpName(name))
+    { }
+
+inline OpName::
+OpName(const char* name)
+  : name_(detail::internOpName(name))
+    { }
+
+inline std::ostream& 
+operator<<(std::ostream& s, OpName const& op)
+    {
+    return s << op.str();
+    }
+
+
 //
 // Classes derived from SiteSet 
 // represent the Hilbert space of a 
@@ -25,10 +126,12 @@ namespace itensor {
 
 class GenericSite;
 struct SiteStore;
+namespace detail { struct OpCache; }
 
 class SiteSet
     {
     std::shared_ptr<SiteStore> sites_;
+    std::shared_ptr<detail::OpCache> ops_;
     public:
 
     using String = std::string;
@@ -60,8 +163,19 @@ class SiteSet
 
     //Get the operator indicated by
     //"opname" located at site i
+    //
+    //Operators are built once per site and name
+    //(including compound names such as "Sz*Sz",
+    //whose product is formed once) and cached;
+    //later calls return a copy sharing storage
+    //with the cached tensor, which is cheap.
+    //Calls passing args other than Args::global()
+    //bypass the cache, and the cache is emptied
+    //when the contents of Args::global() change.
+    //Copies of a SiteSet share their cache. Passing an OpName avoids the
+    //lookup of the interned name.
     IQTensor
-    op(String const& opname, int i,
+    op(OpName const& opname, int i,
        Args const& args = Args::global()) const;
 
     void 
@@ -92,6 +206,12 @@ class SiteSet
         { return prime(operator()(i,state)); }
 
 
+    private:
+
+    IQTensor
+    makeOp(OpName const& opname, int i,
+           Args const& args) const;
+
     protected:
 
     void
@@ -235,6 +355,21 @@ struct SiteStore
     };
 
 
+namespace detail {
+
+//Operators of a SiteSet, for each site
+//keyed by the interned operator name
+struct OpCache
+    {
+    std::mutex mutex;
+    std::vector<std::unordered_map<size_t,IQTensor>> ops;
+    std::string args; //contents of Args::global() used to make ops
+
+    OpCache(int N) : ops(1+N) { }
+    };
+
+} //namespace detail
+
 inline SiteSet::
 SiteSet(int N, int d)
     {
@@ -278,12 +413,47 @@ operator()(int i, String const& state) const
     }
 
 inline IQTensor SiteSet::
-op(String const& opname, 
+op(OpName const& opname, 
    int i, 
    Args const& args) const
     { 
     if(not *this) Error("Cannot call .op(..) on default-initialized SiteSet");
-    if(opname == "Id")
+    if(not args.isGlobal()) return makeOp(opname,i,args);
+
+    //Operators can read the global Args (such as "State"
+    //for "Proj"), so the cache is only used while the
+    //global Args are the same as when the ops were made
+    std::ostringstream gargs;
+    args.write(gargs);
+    auto cur_args = gargs.str();
+
+    auto& C = *ops_;
+    auto& ops = C.ops.at(i);
+    {
+    std::lock_guard<std::mutex> lock(C.mutex);
+    if(cur_args != C.args)
+        {
+        for(auto& o : C.ops) o.clear();
+        C.args = cur_args;
+        }
+    auto it = ops.find(opname.id());
+    if(it != ops.end()) return it->second;
+    }
+    //Not holding the lock here since makeOp
+    //calls op for the parts of compound names
+    auto Op = makeOp(opname,i,args);
+    std::lock_guard<std::mutex> lock(C.mutex);
+    if(cur_args != C.args) return Op;
+    return ops.emplace(opname.id(),std::move(Op)).first->second;
+    }
+
+inline IQTensor SiteSet::
+makeOp(OpName const& opname, 
+       int i, 
+       Args const& args) const
+    { 
+    auto& name = opname.str();
+    if(name == "Id")
         {
         IQIndex s = dag(si(i));
         IQIndex sP = siP(i);
@@ -295,7 +465,7 @@ op(String const& opname,
         return id_;
         }
     else
-    if(opname == "Proj")
+    if(name == "Proj")
         {
         auto n = args.getInt("State");
         auto v = si(i)(n);
@@ -314,13 +484,13 @@ op(String const& opname,
 
         //If opname of the form "Name1*Name2",
         //return product of Name1 operator times Name2 operator
-        auto found = opname.find_first_of('*');
+        auto found = name.find_first_of('*');
         if(found != std::string::npos)
             {
-            return multSiteOps(op(op1(opname,found),i,args),
-                               op(op2(opname,found),i,args));
+            return multSiteOps(op(op1(name,found),i,args),
+                               op(op2(name,found),i,args));
             }
-        return sites_->op(i,opname,args);
+        return sites_->op(i,name,args);
         }
     }
 
@@ -328,6 +498,7 @@ void inline SiteSet::
 init(SiteStore && store)
     { 
     sites_ = std::make_shared<SiteStore>(std::move(store));
+    ops_ = std::make_shared<detail::OpCache>(sites_->N());
     }
 
 template<typename SiteType>
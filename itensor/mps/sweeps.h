@@ -107,6 +107,21 @@ class Sweeps
     SweepSetter<int> 
     niter();
 
+    //Number of bits (32 or 64, default 64) of the
+    //floating point numbers in which dmrg stores the
+    //environment tensors away from the current bond
+    int 
+    precision(int sw) const { return precision_.at(sw); }
+    void 
+    setprecision(int sw, int val) { precision_.at(sw) = val; }
+    void 
+    setprecision(int val) { precision_.assign(nsweep_+1,val); }
+
+    //Use as sweeps.precision() = 32,32,64; (single precision
+    //environments for the first two sweeps, double after)
+    SweepSetter<int> 
+    precision();
+
     void
     read(std::istream& s);
 
@@ -123,7 +138,8 @@ class Sweeps
 
     std::vector<int> maxm_,
                      minm_,
-                     niter_;
+                     niter_,
+                     precision_;
     std::vector<Real> cutoff_,
                       noise_;
     int nsweep_;
@@ -337,6 +353,9 @@ noise() { return SweepSetter<Real>(noise_); }
 SweepSetter<int> inline Sweeps::
 niter() { return SweepSetter<int>(niter_); }
 
+SweepSetter<int> inline Sweeps::
+precision() { return SweepSetter<int>(precision_); }
+
 void inline Sweeps::
 nsweep(int val)
     { 
@@ -354,12 +373,14 @@ init(Args const& args)
     auto cutoff = args.getReal("Cutoff");
     auto noise = args.getReal("Noise",0.);
     auto niter = args.getInt("Niter",2);
+    auto precision = args.getInt("Precision",64);
 
     minm_ = std::vector<int>(nsweep_+1,min_m);
     maxm_ = std::vector<int>(nsweep_+1,max_m);
     cutoff_ = std::vector<Real>(nsweep_+1,cutoff);
     niter_ = std::vector<int>(nsweep_+1,niter);
     noise_ = std::vector<Real>(nsweep_+1,noise);
+    precision_ = std::vector<int>(nsweep_+1,precision);
 
     ////Set number of Davidson iterations
     //const int Max_niter = 9;
@@ -382,6 +403,7 @@ tableInit(InputGroup& table)
     cutoff_ = std::vector<Real>(nsweep_+1,0);
     niter_ = std::vector<int>(nsweep_+1,0);
     noise_ = std::vector<Real>(nsweep_+1,0);
+    precision_ = std::vector<int>(nsweep_+1,64);
 
     //printfln("Got nsweep_=%d",nsweep_);
     table.SkipLine(); //SkipLine so we can have a table key
@@ -430,6 +452,9 @@ read(std::istream& s)
     itensor::read(s,niter_);
     itensor::read(s,noise_);
     itensor::read(s,nsweep_);
+    //Precision is not saved, keeping the
+    //format of previously written files
+    precision_ = std::vector<int>(nsweep_+1,64);
     }
 
 inline std::ostream&
@@ -438,8 +463,10 @@ operator<<(std::ostream& s, const Sweeps& swps)
     s << "Sweeps:\n";
     for(int sw = 1; sw <= swps.nsweep(); ++sw)
         {
-        s << format("%d  Maxm=%d, Minm=%d, Cutoff=%.1E, Niter=%d, Noise=%.1E\n",
+        s << format("%d  Maxm=%d, Minm=%d, Cutoff=%.1E, Niter=%d, Noise=%.1E",
               sw,swps.maxm(sw),swps.minm(sw),swps.cutoff(sw),swps.niter(sw),swps.noise(sw));
+        if(swps.precision(sw) != 64) s << format(", Precision=%d",swps.precision(sw));
+        s << "\n";
         }
     return s;
     }
@@ -0,0 +1,189 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include "itensor/su2.h"
+#include "itensor/util/error.h"
+
+namespace itensor {
+
+namespace detail {
+
+//Largest n for which n! fits in a double
+const int MaxFactorial = 170;
+
+Real
+factorial(int n)
+    {
+    //Filled once (thread safe), only read afterwards
+    static const auto table = []()
+        {
+        auto t = std::vector<Real>(MaxFactorial+1,1.);
+        for(auto k = 1; k <= MaxFactorial; ++k) t[k] = t[k-1]*k;
+        return t;
+        }();
+    if(n < 0) Error("SU(2) coefficient: negative factorial argument");
+    if(n > MaxFactorial) Error("SU(2) coefficient: spin too large");
+    return table[n];
+    }
+
+Real
+phase(int n) { return (n%2 == 0) ? 1. : -1.; }
+
+//Triangle coefficient Delta(a,b,c),
+//arguments twice the spins
+Real
+triangleCoef(int a, int b, int c)
+    {
+    return std::sqrt(factorial((a+b-c)/2)*factorial((a-b+c)/2)*factorial((-a+b+c)/2)
+                    /factorial((a+b+c)/2+1));
+    }
+
+//Pack six twice-spins (or spin projections
+//shifted to be non-negative) into a cache key
+unsigned long long
+packKey(int a, int b, int c, int d, int e, int f)
+    {
+    unsigned long long key = 0;
+    for(auto n : {a,b,c,d,e,f}) key = (key << 10) | (unsigned long long)(n & 0x3FF);
+    return key;
+    }
+
+bool
+validProj(int j, int m)
+    {
+    return j >= 0 && m >= -j && m <= j && (j+m)%2 == 0;
+    }
+
+Real
+computeCG(int j1, int m1,
+          int j2, int m2,
+          int j,  int m)
+    {
+    auto pre = std::sqrt((j+1)*factorial((j+j1-j2)/2)*factorial((j-j1+j2)/2)
+                              *factorial((j1+j2-j)/2)/factorial((j1+j2+j)/2+1))
+             * std::sqrt(factorial((j+m)/2)*factorial((j-m)/2)
+                        *factorial((j1-m1)/2)*factorial((j1+m1)/2)
+                        *factorial((j2-m2)/2)*factorial((j2+m2)/2));
+    //Range of k for which all factorial arguments are >= 0
+    auto kmin = std::max(0,std::max((j2-j-m1)/2,(j1-j+m2)/2)),
+         kmax = std::min((j1+j2-j)/2,std::min((j1-m1)/2,(j2+m2)/2));
+    Real sum = 0;
+    for(auto k = kmin; k <= kmax; ++k)
+        {
+        sum += phase(k)/(factorial(k)*factorial((j1+j2-j)/2-k)*factorial((j1-m1)/2-k)
+                        *factorial((j2+m2)/2-k)*factorial((j-j2+m1)/2+k)*factorial((j-j1-m2)/2+k));
+        }
+    return pre*sum;
+    }
+
+Real
+compute6j(int j1, int j2, int j3,
+          int j4, int j5, int j6)
+    {
+    auto pre = triangleCoef(j1,j2,j3)*triangleCoef(j1,j5,j6)
+              *triangleCoef(j4,j2,j6)*triangleCoef(j4,j5,j3);
+    auto a1 = (j1+j2+j3)/2,
+         a2 = (j1+j5+j6)/2,
+         a3 = (j4+j2+j6)/2,
+         a4 = (j4+j5+j3)/2;
+    auto b1 = (j1+j2+j4+j5)/2,
+         b2 = (j2+j3+j5+j6)/2,
+         b3 = (j3+j1+j6+j4)/2;
+    auto tmin = std::max(std::max(a1,a2),std::max(a3,a4)),
+         tmax = std::min(b1,std::min(b2,b3));
+    Real sum = 0;
+    for(auto t = tmin; t <= tmax; ++t)
+        {
+        sum += phase(t)*factorial(t+1)
+              /(factorial(t-a1)*factorial(t-a2)*factorial(t-a3)*factorial(t-a4)
+               *factorial(b1-t)*factorial(b2-t)*factorial(b3-t));
+        }
+    return pre*sum;
+    }
+
+} //namespace detail
+
+bool
+su2Triangle(int j1, int j2, int j3)
+    {
+    if(j1 < 0 || j2 < 0 || j3 < 0) return false;
+    if((j1+j2+j3)%2 != 0) return false;
+    return j3 >= std::abs(j1-j2) && j3 <= j1+j2;
+    }
+
+Real
+clebschGordan(int j1, int m1,
+              int j2, int m2,
+              int j,  int m)
+    {
+    if(m1+m2 != m) return 0;
+    if(!detail::validProj(j1,m1) || !detail::validProj(j2,m2) || !detail::validProj(j,m)) return 0;
+    if(!su2Triangle(j1,j2,j)) return 0;
+
+    static thread_local auto cache = std::unordered_map<unsigned long long,Real>{};
+    auto key = detail::packKey(j1,j1+m1,j2,j2+m2,j,j+m);
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+    auto val = detail::computeCG(j1,m1,j2,m2,j,m);
+    cache[key] = val;
+    return val;
+    }
+
+Real
+wigner3j(int j1, int j2, int j3,
+         int m1, int m2, int m3)
+    {
+    if(m1+m2+m3 != 0) return 0;
+    return detail::phase((j1-j2-m3)/2)/std::sqrt(j3+1.)
+          *clebschGordan(j1,m1,j2,m2,j3,-m3);
+    }
+
+Real
+wigner6j(int j1, int j2, int j3,
+         int j4, int j5, int j6)
+    {
+    if(!su2Triangle(j1,j2,j3) || !su2Triangle(j1,j5,j6)
+    || !su2Triangle(j4,j2,j6) || !su2Triangle(j4,j5,j3)) return 0;
+
+    static thread_local auto cache = std::unordered_map<unsigned long long,Real>{};
+    auto key = detail::packKey(j1,j2,j3,j4,j5,j6);
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+    auto val = detail::compute6j(j1,j2,j3,j4,j5,j6);
+    cache[key] = val;
+    return val;
+    }
+
+Real
+wigner9j(int j1, int j2, int j3,
+         int j4, int j5, int j6,
+         int j7, int j8, int j9)
+    {
+    //Sum over x of products of 6j symbols
+    auto xmin = std::max(std::abs(j1-j9),std::max(std::abs(j4-j8),std::abs(j2-j6))),
+         xmax = std::min(j1+j9,std::min(j4+j8,j2+j6));
+    Real sum = 0;
+    for(auto x = xmin; x <= xmax; x += 2)
+        {
+        sum += detail::phase(x)*(x+1)
+              *wigner6j(j1,j4,j7,j8,j9,x)
+              *wigner6j(j2,j5,j8,j4,x,j6)
+              *wigner6j(j3,j6,j9,x,j1,j2);
+        }
+    return sum;
+    }
+
+Real
+wignerEckart(Real reduced,
+             int jp, int mp,
+             int k,  int q,
+             int j,  int m)
+    {
+    return clebschGordan(j,m,k,q,jp,mp)*reduced/std::sqrt(jp+1.);
+    }
+
+} //namespace itensor
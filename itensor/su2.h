@@ -0,0 +1,71 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SU2_H
+#define __ITENSOR_SU2_H
+
+#include "itensor/real.h"
+
+namespace itensor {
+
+//
+// SU(2) coupling and recoupling coefficients
+//
+// All spins and spin projections are given as twice
+// their value, as for the "Sz" QN of the spin site sets:
+// a spin 1/2 has j=1 and m=-1 or m=+1.
+//
+// Values are computed from the Racah formulas and
+// cached, so repeated calls (for example when working
+// with reduced matrix elements of SU(2) symmetric
+// tensors) cost a single hash table lookup. Each
+// thread has its own cache, so these functions can
+// be called from several threads at once.
+//
+
+//True if j1, j2, j3 satisfy the triangle
+//condition and j1+j2+j3 is an integer
+bool
+su2Triangle(int j1, int j2, int j3);
+
+//Clebsch-Gordan coefficient <j1 m1; j2 m2 | j m>
+Real
+clebschGordan(int j1, int m1,
+              int j2, int m2,
+              int j,  int m);
+
+//Wigner 3j symbol ( j1 j2 j3 )
+//                 ( m1 m2 m3 )
+Real
+wigner3j(int j1, int j2, int j3,
+         int m1, int m2, int m3);
+
+//Wigner 6j symbol { j1 j2 j3 }
+//                 { j4 j5 j6 }
+Real
+wigner6j(int j1, int j2, int j3,
+         int j4, int j5, int j6);
+
+//Wigner 9j symbol { j1 j2 j3 }
+//                 { j4 j5 j6 }
+//                 { j7 j8 j9 }
+Real
+wigner9j(int j1, int j2, int j3,
+         int j4, int j5, int j6,
+         int j7, int j8, int j9);
+
+//Matrix element <j' m'| T^k_q |j m> of component q
+//of a rank k tensor operator given its reduced matrix
+//element <j'||T^k||j>, by the Wigner-Eckart theorem
+//  <j' m'|T^k_q|j m> = <j m; k q|j' m'> <j'||T^k||j>/sqrt(j'+1)
+//(with j' twice the spin, so that <j||1||j> = sqrt(j+1))
+Real
+wignerEckart(Real reduced,
+             int jp, int mp,
+             int k,  int q,
+             int j,  int m);
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,512 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <algorithm>
+#include <cmath>
+#include "itensor/su2tensor.h"
+#include "itensor/tensor/algs.h"
+#include "itensor/util/error.h"
+
+namespace itensor {
+
+IQIndex
+su2Index(std::string const& name,
+         std::vector<std::pair<int,long>> const& sectors,
+         IndexType type)
+    {
+    auto iq = IQIndex::storage{};
+    for(auto& s : sectors)
+        {
+        if(s.first < 0 || s.second < 1) Error("su2Index: invalid sector");
+        for(auto& q : iq) if(q.qn[0] == s.first) Error("su2Index: repeated spin");
+        iq.emplace_back(Index(nameint(name+" j",s.first),s.second,type),QN(QNVal(s.first)));
+        }
+    return IQIndex(name,std::move(iq));
+    }
+
+int
+su2Spin(IQIndex const& I, long b) { return I.qn(b)[0]; }
+
+long
+su2FullDim(IQIndex const& I)
+    {
+    long dim = 0;
+    for(auto b : range1(I.nblock())) dim += I.index(b).m()*(su2Spin(I,b)+1);
+    return dim;
+    }
+
+namespace detail {
+
+std::vector<Index>
+sectorInds(std::vector<IQIndex> const& is,
+           SU2Tensor::Key const& k)
+    {
+    auto inds = std::vector<Index>(is.size());
+    for(auto n : range(is)) inds[n] = is[n].index(k[n]);
+    return inds;
+    }
+
+ITensor
+zeroBlock(std::vector<Index> const& inds)
+    {
+    long size = 1;
+    for(auto& i : inds) size *= i.m();
+    return ITensor(IndexSet(inds),DenseReal(size));
+    }
+
+//Elements of a block, with its indices
+//in the order given (first fastest)
+std::vector<Real>
+blockData(ITensor b,
+          std::vector<Index> const& inds)
+    {
+    b.order(IndexSet(inds));
+    auto G = GetData<Real>{};
+    doTask(G,b.store());
+    auto d = std::vector<Real>(G.data,G.data+G.size);
+#ifdef USESCALE
+    auto fac = b.scale().real();
+    if(fac != 1.) for(auto& x : d) x *= fac;
+#endif
+    return d;
+    }
+
+//Number of intermediate spins of a rank n tensor
+long
+ninter(long n) { return std::max(0l,n-3); }
+
+} //namespace detail
+
+SU2Tensor::
+SU2Tensor(std::vector<IQIndex> const& is)
+  : is_(is)
+    {
+    if(is_.size() < 2) Error("SU2Tensor must have at least two indices");
+    }
+
+bool SU2Tensor::
+allowed(Key const& k) const
+    {
+    auto n = r();
+    if(long(k.size()) != n+detail::ninter(n)) return false;
+    for(auto i : range(n)) if(k[i] < 1 || k[i] > is_[i].nblock()) return false;
+    auto j = [this,&k](long i) { return su2Spin(is_[i],k[i]); };
+    if(n == 2) return j(0) == j(1);
+    auto cur = j(0);
+    for(auto i : range1(n-2))
+        {
+        auto target = (i < n-2) ? int(k[n+i-1]) : j(n-1);
+        if(!su2Triangle(cur,j(i),target)) return false;
+        cur = target;
+        }
+    return true;
+    }
+
+std::vector<SU2Tensor::Key> SU2Tensor::
+allowedKeys() const
+    {
+    auto n = r();
+    auto keys = std::vector<Key>{};
+    auto k = Key(n+detail::ninter(n),0);
+    //Loop over the sectors of every index
+    std::function<void(long)> sectors;
+    //Loop over the intermediate spins
+    std::function<void(long,int)> inter;
+    sectors = [&](long i)
+        {
+        if(i == n)
+            {
+            if(n == 2) { if(allowed(k)) keys.push_back(k); }
+            else       inter(1,su2Spin(is_[0],k[0]));
+            return;
+            }
+        for(auto b : range1(is_[i].nblock()))
+            {
+            k[i] = b;
+            sectors(i+1);
+            }
+        };
+    inter = [&](long i, int cur)
+        {
+        auto ji = su2Spin(is_[i],k[i]);
+        if(i == n-2)
+            {
+            if(su2Triangle(cur,ji,su2Spin(is_[n-1],k[n-1]))) keys.push_back(k);
+            return;
+            }
+        for(auto x = std::abs(cur-ji); x <= cur+ji; x += 2)
+            {
+            k[n+i-1] = x;
+            inter(i+1,x);
+            }
+        };
+    sectors(0);
+    return keys;
+    }
+
+ITensor& SU2Tensor::
+block(Key const& k)
+    {
+    auto it = blocks_.find(k);
+    if(it != blocks_.end()) return it->second;
+    if(!allowed(k)) Error("SU2Tensor::block: key not allowed by SU(2) coupling rules");
+    return blocks_[k] = detail::zeroBlock(detail::sectorInds(is_,k));
+    }
+
+long SU2Tensor::
+reducedSize() const
+    {
+    long size = 0;
+    for(auto& b : blocks_)
+        {
+        long bs = 1;
+        for(auto& i : b.second.inds()) bs *= i.m();
+        size += bs;
+        }
+    return size;
+    }
+
+SU2Tensor& SU2Tensor::
+operator*=(Real fac)
+    {
+    for(auto& b : blocks_) b.second *= fac;
+    return *this;
+    }
+
+SU2Tensor& SU2Tensor::
+operator+=(SU2Tensor const& B)
+    {
+    if(B.is_ != is_) Error("SU2Tensor +=: mismatched indices");
+    for(auto& b : B.blocks_) block(b.first) += b.second;
+    return *this;
+    }
+
+SU2Tensor
+randomSU2Tensor(std::vector<IQIndex> const& is)
+    {
+    auto T = SU2Tensor(is);
+    for(auto& k : T.allowedKeys())
+        {
+        auto& b = T.block(k);
+        randomize(b);
+        }
+    return T;
+    }
+
+Real
+norm(SU2Tensor const& T)
+    {
+    //Each reduced element stands for (j+1) elements of
+    //unit total weight per state of the last index
+    Real nrm2 = 0;
+    auto& last = T.inds().back();
+    for(auto& b : T.blocks())
+        {
+        auto j = su2Spin(last,b.first[T.r()-1]);
+        nrm2 += (j+1)*sqr(norm(b.second));
+        }
+    return std::sqrt(nrm2);
+    }
+
+SU2Tensor
+operator*(SU2Tensor const& A, SU2Tensor const& B)
+    {
+    auto na = A.r(),
+         nb = B.r();
+    auto& c = A.inds().back();
+    if(!(c == B.inds().front())) Error("SU2Tensor contraction: last index of A must be first index of B");
+
+    auto is = std::vector<IQIndex>(A.inds().begin(),A.inds().end()-1);
+    is.insert(is.end(),B.inds().begin()+1,B.inds().end());
+    auto C = SU2Tensor(is);
+
+    //The contracted index becomes an intermediate
+    //spin of C, unless A or B is rank 2
+    auto addc = (na > 2 && nb > 2);
+    for(auto& a : A.blocks())
+    for(auto& b : B.blocks())
+        {
+        auto& ka = a.first;
+        auto& kb = b.first;
+        if(ka[na-1] != kb[0]) continue;
+        auto k = SU2Tensor::Key(ka.begin(),ka.begin()+na-1);
+        k.insert(k.end(),kb.begin()+1,kb.begin()+nb);
+        k.insert(k.end(),ka.begin()+na,ka.end());
+        if(addc) k.push_back(su2Spin(c,ka[na-1]));
+        k.insert(k.end(),kb.begin()+nb,kb.end());
+        C.block(k) += a.second*b.second;
+        }
+    return C;
+    }
+
+Spectrum
+svd(SU2Tensor const& T,
+    SU2Tensor & A,
+    SU2Tensor & B,
+    Args const& args)
+    {
+    if(T.r() != 4) Error("SU2Tensor svd: only rank 4 tensors supported");
+    auto cutoff = args.getReal("Cutoff",MIN_CUT);
+    auto maxm = args.getInt("Maxm",MAX_M);
+    auto minm = args.getInt("Minm",1);
+    auto name = args.getString("IndexName","a");
+
+    auto& l = T.index(1);
+    auto& s1 = T.index(2);
+    auto& s2 = T.index(3);
+    auto& r = T.index(4);
+    using Pair = std::pair<long,long>;
+
+    struct Sector
+        {
+        std::map<Pair,long> rows, cols;
+        long nrow = 0, ncol = 0;
+        Mat<Real> U, V;
+        Vector D;
+        long keep = 0;
+        };
+    auto sectors = std::map<int,Sector>{};
+
+    //Group the blocks by intermediate spin x
+    for(auto& b : T.blocks())
+        {
+        auto& k = b.first;
+        auto& S = sectors[k[4]];
+        S.rows[Pair(k[0],k[1])] = 0;
+        S.cols[Pair(k[2],k[3])] = 0;
+        }
+
+    struct SVal { int x; Real s; };
+    auto svals = std::vector<SVal>{};
+    Real total = 0;
+    for(auto& xs : sectors)
+        {
+        auto x = xs.first;
+        auto& S = xs.second;
+        for(auto& rw : S.rows)
+            {
+            rw.second = S.nrow;
+            S.nrow += l.index(rw.first.first).m()*s1.index(rw.first.second).m();
+            }
+        for(auto& cl : S.cols)
+            {
+            cl.second = S.ncol;
+            S.ncol += s2.index(cl.first.first).m()*r.index(cl.first.second).m();
+            }
+        //Weight the columns so that the singular values
+        //are those of the full tensor (each (x+1) times)
+        auto M = Mat<Real>(S.nrow,S.ncol);
+        for(auto& b : T.blocks())
+            {
+            auto& k = b.first;
+            if(k[4] != x) continue;
+            auto inds = detail::sectorInds(T.inds(),k);
+            auto d = detail::blockData(b.second,inds);
+            auto dl = inds[0].m(), d1 = inds[1].m(), d2 = inds[2].m();
+            auto row0 = S.rows.at(Pair(k[0],k[1])),
+                 col0 = S.cols.at(Pair(k[2],k[3]));
+            auto w = std::sqrt((su2Spin(r,k[3])+1.)/(x+1.));
+            for(auto e : range(d.size()))
+                {
+                auto al = long(e)%dl,
+                     a1 = (long(e)/dl)%d1,
+                     a2 = (long(e)/(dl*d1))%d2,
+                     ar = long(e)/(dl*d1*d2);
+                M(row0+al+dl*a1,col0+a2+d2*ar) = w*d[e];
+                }
+            }
+        SVD(M,S.U,S.D,S.V);
+        for(auto n : range(S.D.size()))
+            {
+            svals.push_back(SVal{x,S.D(n)});
+            total += (x+1)*sqr(S.D(n));
+            }
+        }
+    if(total == 0) Error("SU2Tensor svd: tensor is zero");
+
+    //Keep the largest singular values
+    std::sort(svals.begin(),svals.end(),[](SVal const& a, SVal const& b) { return a.s > b.s; });
+    auto weight = [&svals](long n) { return (svals[n].x+1)*sqr(svals[n].s); };
+    long n = svals.size();
+    Real err = 0;
+    while(n > std::max(1l,maxm)) { err += weight(n-1); --n; }
+    while(n > std::max(1l,minm) && err+weight(n-1) <= cutoff*total) { err += weight(n-1); --n; }
+    auto eigs = Vector(n);
+    for(auto i : range(n))
+        {
+        ++sectors.at(svals[i].x).keep;
+        eigs(i) = sqr(svals[i].s)/total;
+        }
+
+    auto asec = std::vector<std::pair<int,long>>{};
+    for(auto& xs : sectors) if(xs.second.keep > 0) asec.emplace_back(xs.first,xs.second.keep);
+    auto a = su2Index(name,asec);
+
+    A = SU2Tensor({l,s1,a});
+    B = SU2Tensor({a,s2,r});
+    long ba = 0;
+    for(auto& xs : sectors)
+        {
+        auto x = xs.first;
+        auto& S = xs.second;
+        if(S.keep == 0) continue;
+        ++ba;
+        auto K = S.keep;
+        for(auto& rw : S.rows)
+            {
+            auto k = SU2Tensor::Key{rw.first.first,rw.first.second,ba};
+            if(!A.allowed(k)) continue;
+            auto inds = detail::sectorInds(A.inds(),k);
+            auto dl = inds[0].m(), d1 = inds[1].m();
+            auto d = DenseReal(dl*d1*K);
+            for(auto kk : range(K))
+            for(auto i : range(dl*d1))
+                {
+                d[i+dl*d1*kk] = S.U(rw.second+i,kk);
+                }
+            A.block(k) = ITensor(IndexSet(inds),std::move(d));
+            }
+        for(auto& cl : S.cols)
+            {
+            auto k = SU2Tensor::Key{ba,cl.first.first,cl.first.second};
+            if(!B.allowed(k)) continue;
+            auto inds = detail::sectorInds(B.inds(),k);
+            auto d2 = inds[1].m(), dr = inds[2].m();
+            auto w = std::sqrt((su2Spin(r,k[2])+1.)/(x+1.));
+            auto d = DenseReal(K*d2*dr);
+            for(auto i : range(d2*dr))
+            for(auto kk : range(K))
+                {
+                d[kk+K*i] = S.D(kk)*S.V(cl.second+i,kk)/w;
+                }
+            B.block(k) = ITensor(IndexSet(inds),std::move(d));
+            }
+        }
+    return Spectrum(std::move(eigs),{"Truncerr",err/total});
+    }
+
+SU2Tensor
+applySdotS(SU2Tensor const& T,
+           std::function<Real(Real)> const& f)
+    {
+    if(T.r() != 4) Error("applySdotS: only rank 4 tensors supported");
+    auto R = SU2Tensor(T.inds());
+    for(auto& b : T.blocks())
+        {
+        auto& k = b.first;
+        auto jl = su2Spin(T.index(1),k[0]),
+             j1 = su2Spin(T.index(2),k[1]),
+             j2 = su2Spin(T.index(3),k[2]),
+             jr = su2Spin(T.index(4),k[3]);
+        auto x = int(k[4]);
+        //Recoupling ((l s1)x s2)r -> (l (s1 s2)y)r
+        auto U = [=](int x, int y)
+            {
+            auto ph = ((jl+j1+j2+jr)/2)%2 == 0 ? 1. : -1.;
+            return ph*std::sqrt((x+1.)*(y+1.))*wigner6j(jl,j1,x,j2,jr,y);
+            };
+        //S1.S2 = (Sy^2-S1^2-S2^2)/2 in the coupled basis
+        auto e = [=](int y) { return (y*(y+2.)-j1*(j1+2.)-j2*(j2+2.))/8.; };
+        for(auto xp = std::abs(jl-j1); xp <= jl+j1; xp += 2)
+            {
+            if(!su2Triangle(xp,j2,jr)) continue;
+            Real h = 0;
+            for(auto y = std::abs(j1-j2); y <= j1+j2; y += 2)
+                {
+                if(!su2Triangle(jl,y,jr)) continue;
+                h += U(xp,y)*f(e(y))*U(x,y);
+                }
+            if(std::fabs(h) < 1E-14) continue;
+            auto kp = k;
+            kp[4] = xp;
+            R.block(kp) += h*b.second;
+            }
+        }
+    return R;
+    }
+
+ITensor
+toITensor(SU2Tensor const& T,
+          std::vector<Index> const& full)
+    {
+    auto n = T.r();
+    if(long(full.size()) != n) Error("toITensor: wrong number of Indices");
+    auto off = std::vector<std::vector<long>>(n);
+    auto stride = std::vector<long>(n);
+    long size = 1;
+    for(auto i : range(n))
+        {
+        auto& I = T.index(i+1);
+        if(full[i].m() != su2FullDim(I)) Error("toITensor: Index dimension does not match");
+        off[i].push_back(0);
+        for(auto b : range1(I.nblock())) off[i].push_back(off[i].back()+I.index(b).m()*(su2Spin(I,b)+1));
+        stride[i] = size;
+        size *= full[i].m();
+        }
+    auto data = DenseReal(size,0.);
+
+    auto j = std::vector<int>(n);
+    auto m = std::vector<int>(n);
+    auto dims = std::vector<long>(n);
+    for(auto& b : T.blocks())
+        {
+        auto& k = b.first;
+        auto inds = detail::sectorInds(T.inds(),k);
+        auto d = detail::blockData(b.second,inds);
+        for(auto i : range(n))
+            {
+            j[i] = su2Spin(T.index(i+1),k[i]);
+            dims[i] = inds[i].m();
+            m[i] = j[i];
+            }
+        //Loop over m of all but the last index
+        while(true)
+            {
+            Real coef = 1;
+            auto mc = m[0];
+            if(n == 2)
+                {
+                m[1] = m[0];
+                }
+            else
+                {
+                auto jc = j[0];
+                for(auto i : range1(n-2))
+                    {
+                    auto target = (i < n-2) ? int(k[n+i-1]) : j[n-1];
+                    coef *= clebschGordan(jc,mc,j[i],m[i],target,mc+m[i]);
+                    mc += m[i];
+                    jc = target;
+                    }
+                m[n-1] = mc;
+                }
+            if(coef != 0 && std::abs(m[n-1]) <= j[n-1])
+                {
+                for(auto e : range(d.size()))
+                    {
+                    long pos = 0,
+                         rem = e;
+                    for(auto i : range(n))
+                        {
+                        auto a = rem%dims[i];
+                        rem /= dims[i];
+                        pos += stride[i]*(off[i][k[i]-1]+a*(j[i]+1)+(j[i]-m[i])/2);
+                        }
+                    data[pos] += coef*d[e];
+                    }
+                }
+            //Next m, as an odometer
+            long i = 0;
+            for(; i < n-1; ++i)
+                {
+                if(m[i] > -j[i]) { m[i] -= 2; break; }
+                m[i] = j[i];
+                }
+            if(i == n-1) break;
+            }
+        }
+    return ITensor(IndexSet(full),std::move(data));
+    }
+
+} //namespace itensor
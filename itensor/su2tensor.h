@@ -0,0 +1,192 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_SU2TENSOR_H
+#define __ITENSOR_SU2TENSOR_H
+
+#include <functional>
+#include <map>
+#include "itensor/iqtensor.h"
+#include "itensor/spectrum.h"
+#include "itensor/su2.h"
+
+namespace itensor {
+
+//
+// SU(2) symmetric tensors
+//
+// An IQIndex made by su2Index has its sectors
+// labelled by SU(2) irreps instead of abelian
+// quantum numbers: a sector of spin j (twice the
+// spin, as in su2.h) and multiplicity d stands for
+// d multiplets, that is d*(j+1) states.
+//
+// An SU2Tensor with indices i1,i2,...,in stores
+// only reduced elements, in the basis of the
+// coupling tree
+//
+//   (...((i1 x i2)->x1 x i3)->x2 ... x i(n-1))->in
+//
+// where i1 and i2 couple to an intermediate spin
+// x1, x1 and i3 to x2 and so on, the last coupling
+// giving in. So an MPS tensor A(l,s,r) couples l
+// and s to r, and a two-site tensor (l,s1,s2,r)
+// has one intermediate spin. A rank 2 tensor (l,r)
+// is an invariant matrix, diagonal in the spin.
+//
+// Each block is labelled by a sector of every index
+// and the intermediate spins, and is an ITensor
+// over the sector Indices. The full tensor is the
+// block times a product of Clebsch-Gordan
+// coefficients, one per coupling, so memory and
+// the cost of contractions and SVDs are reduced
+// by the multiplet dimensions.
+//
+// Scope and limitations:
+//
+// SU2Tensor is a standalone class, not an ITData
+// storage type, so it cannot be held by an
+// ITensor or IQTensor and the MPS/MPO classes and
+// algorithms (dmrg, applyMPO, ...) do not take it.
+// It only supports the operations declared below:
+//
+// - operator* contracts the last index of A with
+//   the first index of B only; there is no general
+//   contraction over arbitrary common indices.
+// - svd only splits rank 4 tensors (two-site MPS
+//   wavefunctions) at their intermediate spin.
+// - applySdotS is the only two-site operator;
+//   SU(2) symmetric MPOs are not supported.
+// - There are no priming, dag or read/write
+//   functions.
+//
+// toITensor expands a tensor to dense form and is
+// meant for testing small tensors.
+//
+
+//sectors are pairs (twice spin j, multiplicity d)
+IQIndex
+su2Index(std::string const& name,
+         std::vector<std::pair<int,long>> const& sectors,
+         IndexType type = Link);
+
+//Twice the spin of sector b (1-indexed) of I
+int
+su2Spin(IQIndex const& I, long b);
+
+//Number of states of I counting all multiplets
+long
+su2FullDim(IQIndex const& I);
+
+class SU2Tensor
+    {
+    public:
+    //Sector (1-indexed) of each index,
+    //then the intermediate spins
+    using Key = std::vector<long>;
+    using Blocks = std::map<Key,ITensor>;
+    private:
+    std::vector<IQIndex> is_;
+    Blocks blocks_;
+    public:
+
+    SU2Tensor() { }
+
+    explicit
+    SU2Tensor(std::vector<IQIndex> const& is);
+
+    explicit operator bool() const { return !is_.empty(); }
+
+    long
+    r() const { return is_.size(); }
+
+    std::vector<IQIndex> const&
+    inds() const { return is_; }
+
+    //1-indexed
+    IQIndex const&
+    index(long n) const { return is_.at(n-1); }
+
+    Blocks const&
+    blocks() const { return blocks_; }
+
+    //Block k, created (as zero) if not stored yet
+    ITensor&
+    block(Key const& k);
+
+    //True if k is allowed by the coupling rules
+    bool
+    allowed(Key const& k) const;
+
+    //All keys allowed by the coupling rules
+    std::vector<Key>
+    allowedKeys() const;
+
+    //Number of reduced elements stored
+    long
+    reducedSize() const;
+
+    SU2Tensor&
+    operator*=(Real fac);
+
+    SU2Tensor&
+    operator+=(SU2Tensor const& B);
+    };
+
+//Tensor with every allowed block
+//filled with random elements
+SU2Tensor
+randomSU2Tensor(std::vector<IQIndex> const& is);
+
+//Norm of the full tensor
+Real
+norm(SU2Tensor const& T);
+
+//Contracts the last index of A with the
+//first index of B (which must be equal)
+SU2Tensor
+operator*(SU2Tensor const& A, SU2Tensor const& B);
+
+//
+// Splits a rank 4 tensor T(l,s1,s2,r) at its
+// intermediate spin into A(l,s1,a) and B(a,s2,r),
+// with a a new index. A is left orthogonal and
+// the singular values are absorbed into B.
+// Singular values are computed per spin and
+// count (j+1) times in the truncation error.
+//
+// Args: "Cutoff", "Maxm" and "Minm" as for svd,
+// where "Maxm" and "Minm" count multiplets.
+// "IndexName" is the name of a (default "a").
+//
+Spectrum
+svd(SU2Tensor const& T,
+    SU2Tensor & A,
+    SU2Tensor & B,
+    Args const& args = Args::global());
+
+//
+// Applies f(S2.S3), where Sn is the spin
+// operator of index n, to a rank 4 tensor
+// T(l,s1,s2,r). By default f(x) = x, giving the
+// Heisenberg bond; f(x) = exp(-tau*x) gives an
+// imaginary time step.
+//
+SU2Tensor
+applySdotS(SU2Tensor const& T,
+           std::function<Real(Real)> const& f = [](Real x) { return x; });
+
+//
+// Full tensor over the Indices full, of
+// dimensions su2FullDim of the indices of T.
+// States are ordered by sector, then by
+// multiplet, then by m = j,j-2,...,-j.
+//
+ITensor
+toITensor(SU2Tensor const& T,
+          std::vector<Index> const& full);
+
+} //namespace itensor
+
+#endif
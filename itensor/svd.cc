@@ -36,7 +36,7 @@ svdImpl(ITensor const& A,
         ITensor & V,
         Args const& args)
     {
-    SCOPED_TIMER(7);
+    PROFILE_SCOPE(svd)
     auto do_truncate = args.getBool("Truncate");
     auto thresh = args.getReal("SVDThreshold",1E-3);
     auto cutoff = args.getReal("Cutoff",MIN_CUT);
@@ -57,9 +57,9 @@ svdImpl(ITensor const& A,
     Mat<T> UU,VV;
     Vector DD;
 
-    TIMER_START(6)
+    PROFILE_START(svd_decomp)
     SVD(M,UU,DD,VV,thresh);
-    TIMER_STOP(6)
+    PROFILE_STOP(svd_decomp)
 
     //conjugate VV so later we can just do
     //U*D*V to reconstruct ITensor A:
@@ -192,7 +192,8 @@ svdImpl(IQTensor A,
     //      make dvecs a vector<VecRef>
     auto dvecs = vector<Vector>(Nblock);
 
-    auto alleig = stdx::reserve_vector<Real>(std::min(uI.m(),vI.m()));
+    auto alleig = Vector::storage_type{};
+    alleig.reserve(std::min(uI.m(),vI.m()));
 
     auto alleigqn = vector<EigQN>{};
     if(compute_qn)
@@ -413,6 +414,101 @@ svdImpl(IQTensor A,
 
     } // svdImpl IQTensor
 
+template<typename T>
+void
+qrImpl(ITensor const& A,
+       Index const& qi, 
+       Index const& ri,
+       ITensor & Q, 
+       ITensor & R,
+       Args const& args)
+    {
+    PROFILE_SCOPE(qr)
+    auto name = args.getString("IndexName","qr");
+    auto itype = getIndexType(args,"IndexType",Link);
+
+    auto M = toMatRefc<T>(A,qi,ri);
+    Mat<T> QQ,RR;
+    QR(M,QQ,RR);
+
+    auto q = Index(name,ncols(QQ),itype);
+    Q = ITensor({qi,q},Dense<T>(move(QQ.storage())));
+    R = ITensor({q,ri},Dense<T>(move(RR.storage())),A.scale());
+    }
+
+template<typename T>
+void
+qrImpl(IQTensor const& A,
+       IQIndex const& qI, 
+       IQIndex const& rI,
+       IQTensor & Q, 
+       IQTensor & R,
+       Args const& args)
+    {
+    PROFILE_SCOPE(qr)
+    auto name = args.getString("IndexName","qr");
+    auto itype = getIndexType(args,"IndexType",Link);
+
+    auto blocks = doTask(GetBlocks<T>{A.inds(),qI,rI},A.store());
+    auto Nblock = blocks.size();
+    if(Nblock == 0) throw ResultIsZero("IQTensor has no blocks");
+
+    auto Qmats = vector<Mat<T>>(Nblock);
+    auto Rmats = vector<Mat<T>>(Nblock);
+    auto Liq = IQIndex::storage{};
+    Liq.reserve(Nblock);
+    for(auto b : range(Nblock))
+        {
+        QR(blocks[b].M,Qmats[b],Rmats[b]);
+        Liq.emplace_back(Index("q",ncols(Qmats[b]),itype),qI.qn(1+blocks[b].i1));
+        }
+
+    auto L = IQIndex(name,move(Liq),qI.dir());
+    auto Qis = IQIndexSet(qI,dag(L));
+    auto Ris = IQIndexSet(L,rI);
+    auto Qstore = QDense<T>(Qis,QN());
+    auto Rstore = QDense<T>(Ris,div(A));
+
+    for(auto b : range(Nblock))
+        {
+        auto& B = blocks[b];
+        long n = b;
+        auto pQ = getBlock(Qstore,Qis,stdx::make_array(B.i1,n));
+        auto Qref = makeMatRef(pQ.data(),pQ.size(),qI[B.i1].m(),L[n].m());
+        Qref &= Qmats[b];
+        auto pR = getBlock(Rstore,Ris,stdx::make_array(n,B.i2));
+        auto Rref = makeMatRef(pR.data(),pR.size(),L[n].m(),rI[B.i2].m());
+        Rref &= Rmats[b];
+        }
+
+    Q = IQTensor(Qis,move(Qstore));
+    R = IQTensor(Ris,move(Rstore),A.scale());
+    }
+
+template<typename IndexT>
+void
+qrRank2(ITensorT<IndexT> const& A, 
+        IndexT const& qi, 
+        IndexT const& ri,
+        ITensorT<IndexT> & Q, 
+        ITensorT<IndexT> & R,
+        Args const& args)
+    {
+    if(A.r() != 2) 
+        {
+        Print(A);
+        Error("A must be matrix-like (rank 2)");
+        }
+    if(isComplex(A)) qrImpl<Cplx>(A,qi,ri,Q,R,args);
+    else             qrImpl<Real>(A,qi,ri,Q,R,args);
+    }
+template void
+qrRank2(ITensor const&,Index const&,Index const&,
+        ITensor &,ITensor &,Args const&);
+template void
+qrRank2(IQTensor const&,IQIndex const&,IQIndex const&,
+        IQTensor &,IQTensor &,Args const&);
+
 template<typename IndexT>
 Spectrum 
 svdRank2(ITensorT<IndexT> const& A, 
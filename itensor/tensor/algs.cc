@@ -587,6 +587,82 @@ SVDRef(MatRefc<T> const& M,
 template void SVDRef(MatRefc<Real> const&,MatRef<Real> const&, VectorRef const&, MatRef<Real> const&,Real);
 template void SVDRef(MatRefc<Cplx> const&,MatRef<Cplx> const&, VectorRef const&, MatRef<Cplx> const&,Real);
 
+namespace detail {
+
+//Calls dgeqrf/dorgqr or zgeqrf/zungqr
+void inline
+qrFactor(LAPACK_INT* m, LAPACK_INT* n, Real* A, LAPACK_INT* lda, Real* tau, LAPACK_INT* info)
+    {
+    dgeqrf_wrapper(m,n,A,lda,tau,info);
+    }
+void inline
+qrFactor(LAPACK_INT* m, LAPACK_INT* n, Cplx* A, LAPACK_INT* lda, Cplx* tau, LAPACK_INT* info)
+    {
+    zgeqrf_wrapper(m,n,A,lda,tau,info);
+    }
+
+void inline
+qrFormQ(LAPACK_INT* m, LAPACK_INT* k, Real* A, LAPACK_INT* lda, Real* tau, LAPACK_INT* info)
+    {
+    dorgqr_wrapper(m,k,k,A,lda,tau,info);
+    }
+void inline
+qrFormQ(LAPACK_INT* m, LAPACK_INT* k, Cplx* A, LAPACK_INT* lda, Cplx* tau, LAPACK_INT* info)
+    {
+    zungqr_wrapper(m,k,k,A,lda,tau,info);
+    }
+
+template<typename T>
+void
+QRImpl(MatRefc<T> const& M,
+       Mat<T> & Q,
+       Mat<T> & R)
+    {
+    LAPACK_INT m = nrows(M),
+               n = ncols(M);
+    LAPACK_INT k = std::min(m,n);
+    Q = Mat<T>(m,k);
+    R = Mat<T>(k,n);
+    if(k == 0) return;
+
+    auto A = Mat<T>(m,n);
+    makeRef(A) &= M;
+    auto tau = std::vector<T>(k);
+    LAPACK_INT lda = m;
+    LAPACK_INT info = 0;
+    qrFactor(&m,&n,A.data(),&lda,tau.data(),&info);
+    if(info != 0) throw std::runtime_error("QR: error in LAPACK QR factorization");
+
+    for(auto j : range(n))
+    for(auto i : range(std::min<long>(j+1,k)))
+        {
+        R(i,j) = A(i,j);
+        }
+
+    //Q is formed from the first k columns of A
+    qrFormQ(&m,&k,A.data(),&lda,tau.data(),&info);
+    if(info != 0) throw std::runtime_error("QR: error forming Q");
+    makeRef(Q) &= MatRefc<T>(columns(A,0,k));
+    }
+
+} //namespace detail
+
+void
+QR(MatRefc<Real> const& M,
+   Mat<Real> & Q,
+   Mat<Real> & R)
+    {
+    detail::QRImpl(M,Q,R);
+    }
+
+void
+QR(MatRefc<Cplx> const& M,
+   Mat<Cplx> & Q,
+   Mat<Cplx> & R)
+    {
+    detail::QRImpl(M,Q,R);
+    }
+
 
 
 //void
@@ -105,6 +105,20 @@ SVD(MatM && M,
     MatV && V,
     Real thresh = SVD_THRESH);
 
+//
+// QR decomposition M = Q*R, where Q has
+// k = min(nrows(M),ncols(M)) orthonormal
+// columns and R is k x ncols(M), upper triangular.
+//
+void
+QR(MatRefc<Real> const& M,
+   Mat<Real> & Q,
+   Mat<Real> & R);
+
+void
+QR(MatRefc<Cplx> const& M,
+   Mat<Cplx> & Q,
+   Mat<Cplx> & R);
 
 } //namespace itensor
 
@@ -1,152 +1,113 @@
 #include "itensor/tensor/lapack_wrap.h"
 #include "itensor/tensor/slicemat.h"
-#include "itensor/util/safe_ptr.h"
+#include <algorithm>
+#include <memory>
 
 namespace itensor {
 
-struct dgemmTask
+//
+// Complex products are computed with real dgemm
+// calls on the real and imaginary parts ("planes")
+// of the complex operands. Each complex operand is
+// split into its two planes once per product,
+// in a scratch buffer. Each thread keeps its buffer
+// between calls, up to MaxKeptScratch doubles (8MB);
+// larger products allocate for the call only.
+//
+// For large products of two complex matrices the
+// 3M method is used, which needs three real
+// products instead of four:
+//
+//   T1 = Ar*Br, T2 = Ai*Bi, T3 = (Ar+Ai)*(Br+Bi)
+//   Re(A*B) = T1-T2, Im(A*B) = T3-T1-T2
+//
+// Defining ITENSOR_NO_GEMM3M turns this off.
+//
+
+namespace {
+
+//Smallest value of min(m,n,k) for which the 3M
+//method saves more than its extra additions cost
+const long Min3M = 32;
+
+//Largest scratch buffer (in doubles) kept per thread
+const size_t MaxKeptScratch = 1ul<<20;
+
+class Scratch
     {
-    bool copyToC = false;
-    bool copyFromC = false;
-    size_t Apart = 0ul,
-           Bpart = 0ul,
-           Cpart = 0ul;
-    Real alpha = 0.,
-         beta  = 0.;
+    std::unique_ptr<Real[]> own_;
+    Real* data_ = nullptr;
+    public:
 
-    dgemmTask(size_t Ap,
-              size_t Bp,
-              size_t Cp,
-              Real a,
-              Real b)
-      : Apart(Ap),Bpart(Bp),Cpart(Cp),alpha(a),beta(b)
-        { 
-        if(b != 0.0) copyFromC = true;
+    explicit
+    Scratch(size_t size)
+        {
+        if(size > MaxKeptScratch)
+            {
+            own_.reset(new Real[size]);
+            data_ = own_.get();
+            return;
+            }
+        static thread_local std::vector<Real> buf;
+        if(buf.size() < size) buf.resize(size);
+        data_ = buf.data();
         }
 
-    dgemmTask(size_t Ap,
-              size_t Bp,
-              size_t Cp,
-              Real a)
-      : Apart(Ap),Bpart(Bp),Cpart(Cp),alpha(a),beta(1.0)
-        { }
+    Scratch(Scratch const&) = delete;
+    Scratch& operator=(Scratch const&) = delete;
 
-    dgemmTask(size_t Cp)
-       : copyToC(true),Cpart(Cp)
-        { }
+    Real*
+    data() const { return data_; }
     };
 
 void
-cplxToRealBuf(SAFE_PTR_OF(const Real) C,
-              size_t imagPart,
-              SAFE_PTR_OF(Real) Rbegin,
-              SAFE_PTR_OF(Real) Rend)
+splitPlanes(Cplx const* z,
+            size_t n,
+            Real* re,
+            Real* im)
     {
-    C += imagPart;
-    for(auto r=Rbegin; r != Rend; ++r, C+=2)
+    for(size_t j = 0; j < n; ++j)
         {
-        *r = *C;
+        re[j] = z[j].real();
+        im[j] = z[j].imag();
         }
     }
+
+//C = alpha*(re + i*im) + beta*C
 void
-realBufToCplx(SAFE_PTR_OF(Real) Rbegin,
-              SAFE_PTR_OF(Real) Rend,
-              SAFE_PTR_OF(Real) C,
-              size_t imagPart)
+mergePlanes(Real const* re,
+            Real const* im,
+            size_t n,
+            Cplx* C,
+            Real alpha,
+            Real beta)
     {
-    C += imagPart;
-    for(auto r=Rbegin; r != Rend; ++r, C+=2)
+    if(beta == 0.)
         {
-        *C = *r;
+        for(size_t j = 0; j < n; ++j) C[j] = Cplx(alpha*re[j],alpha*im[j]);
+        }
+    else
+        {
+        for(size_t j = 0; j < n; ++j) C[j] = beta*C[j] + Cplx(alpha*re[j],alpha*im[j]);
         }
     }
 
-template<size_t NTask, typename VA, typename VB>
+template<typename MatA, typename MatB>
 void
-gemm_emulator(MatRefc<VA> A,
-              MatRefc<VB> B,
-              MatRef<Cplx>  C,
-              Real alpha,
-              Real beta,
-              std::array<const dgemmTask,NTask> const& tasks)
+planeGemm(MatA const& A,
+          MatB const& B,
+          long m, long n, long k,
+          Real alpha,
+          Real const* pA,
+          Real const* pB,
+          Real beta,
+          Real* pC)
     {
-    static_assert(!(isReal(A) && isReal(B)),
-                  "only use gemm_emulator for complex case");
-    auto Abufsize = isCplx(A) ? A.size() : 0ul;
-    auto Bbufsize = isCplx(B) ? B.size() : 0ul;
-    auto Cbufsize = C.size();
-
-    auto Ad = MAKE_SAFE_PTR(A.data(),A.size());
-    auto Bd = MAKE_SAFE_PTR(B.data(),B.size());
-    auto Cd = MAKE_SAFE_PTR(C.data(),C.size());
-    auto Ard = SAFE_REINTERPRET(const Real,Ad);
-    auto Brd = SAFE_REINTERPRET(const Real,Bd);
-    auto Crd = SAFE_REINTERPRET(Real,Cd);
-
-    auto d = std::vector<Real>(Abufsize+Bbufsize+Cbufsize);
-    auto pd = MAKE_SAFE_PTR(d.data(),d.size());
-    auto ab = pd;
-    auto ae = ab+Abufsize;
-    auto bb = ae;
-    auto be = bb+Bbufsize;
-    auto cb = be;
-    auto ce = cb+Cbufsize;
-
-    for(auto t : tasks)
-        {
-        if(t.copyToC)
-            {
-            realBufToCplx(cb,ce,Crd,t.Cpart);
-            }
-        else
-            {
-            if(isCplx(A))   cplxToRealBuf(Ard,t.Apart,ab,ae);
-            if(isCplx(B))   cplxToRealBuf(Brd,t.Bpart,bb,be);
-            if(t.copyFromC) cplxToRealBuf(Crd,t.Cpart,cb,ce);
-
-            if(isReal(A))
-                {
-                gemm_wrapper(isTransposed(A),
-                             isTransposed(B),
-                             nrows(A),
-                             ncols(B),
-                             ncols(A),
-                             t.alpha,
-                             SAFE_PTR_GET(Ard,A.size()),
-                             SAFE_PTR_GET(bb,B.size()),
-                             t.beta,
-                             SAFE_PTR_GET(cb,C.size()));
-                }
-            else if(isReal(B))
-                {
-                gemm_wrapper(isTransposed(A),
-                             isTransposed(B),
-                             nrows(A),
-                             ncols(B),
-                             ncols(A),
-                             t.alpha,
-                             SAFE_PTR_GET(ab,A.size()),
-                             SAFE_PTR_GET(Brd,B.size()),
-                             t.beta,
-                             SAFE_PTR_GET(cb,C.size()));
-                }
-            else //A and B are both Cplx
-                {
-                gemm_wrapper(isTransposed(A),
-                             isTransposed(B),
-                             nrows(A),
-                             ncols(B),
-                             ncols(A),
-                             t.alpha,
-                             SAFE_PTR_GET(ab,A.size()),
-                             SAFE_PTR_GET(bb,B.size()),
-                             t.beta,
-                             SAFE_PTR_GET(cb,C.size()));
-                }
-            }
-        }
+    gemm_wrapper(isTransposed(A),isTransposed(B),m,n,k,alpha,pA,pB,beta,pC);
     }
 
+} //namespace
+
 void
 gemm_impl(MatRefc<Cplx> A,
           MatRefc<Cplx> B,
@@ -165,17 +126,57 @@ gemm_impl(MatRefc<Cplx> A,
                  B.data(),
                  beta,
                  C.data());
-#else //emulate zgemm by calling dgemm four times
-    std::array<const dgemmTask,6> 
-    tasks = 
-        {{dgemmTask(0,0,0,+alpha,beta),
-          dgemmTask(1,1,0,-alpha),
-          dgemmTask(0),
-          dgemmTask(1,0,1,+alpha,beta),
-          dgemmTask(0,1,1,+alpha),
-          dgemmTask(1)
-          }};
-    gemm_emulator(A,B,C,alpha,beta,tasks);
+#else //emulate zgemm using dgemm
+    long m = nrows(A),
+         n = ncols(B),
+         k = ncols(A);
+    auto sa = A.size(),
+         sb = B.size(),
+         sc = C.size();
+#ifndef ITENSOR_NO_GEMM3M
+    if(std::min(m,std::min(n,k)) >= Min3M)
+        {
+        Scratch scratch(3*sa+3*sb+3*sc);
+        auto Ar = scratch.data();
+        auto Ai = Ar+sa,
+             As = Ai+sa,
+             Br = As+sa,
+             Bi = Br+sb,
+             Bs = Bi+sb,
+             T1 = Bs+sb,
+             T2 = T1+sc,
+             T3 = T2+sc;
+        splitPlanes(A.data(),sa,Ar,Ai);
+        splitPlanes(B.data(),sb,Br,Bi);
+        for(size_t j = 0; j < sa; ++j) As[j] = Ar[j]+Ai[j];
+        for(size_t j = 0; j < sb; ++j) Bs[j] = Br[j]+Bi[j];
+        planeGemm(A,B,m,n,k,1.,Ar,Br,0.,T1);
+        planeGemm(A,B,m,n,k,1.,Ai,Bi,0.,T2);
+        planeGemm(A,B,m,n,k,1.,As,Bs,0.,T3);
+        for(size_t j = 0; j < sc; ++j)
+            {
+            T3[j] -= T1[j]+T2[j];
+            T1[j] -= T2[j];
+            }
+        mergePlanes(T1,T3,sc,C.data(),alpha,beta);
+        return;
+        }
+#endif
+    Scratch scratch(2*sa+2*sb+2*sc);
+    auto Ar = scratch.data();
+    auto Ai = Ar+sa,
+         Br = Ai+sa,
+         Bi = Br+sb,
+         Cr = Bi+sb,
+         Ci = Cr+sc;
+    splitPlanes(A.data(),sa,Ar,Ai);
+    splitPlanes(B.data(),sb,Br,Bi);
+    if(beta != 0.) splitPlanes(C.data(),sc,Cr,Ci);
+    planeGemm(A,B,m,n,k,+alpha,Ar,Br,beta,Cr);
+    planeGemm(A,B,m,n,k,-alpha,Ai,Bi,1.,Cr);
+    planeGemm(A,B,m,n,k,+alpha,Ai,Br,beta,Ci);
+    planeGemm(A,B,m,n,k,+alpha,Ar,Bi,1.,Ci);
+    mergePlanes(Cr,Ci,sc,C.data(),1.,0.);
 #endif
     }
 
@@ -187,14 +188,21 @@ gemm_impl(MatRefc<Real> A,
           Real alpha,
           Real beta)
     {
-    std::array<const dgemmTask,4> 
-    tasks = 
-        {{dgemmTask(0,0,0,+alpha,beta),
-          dgemmTask(0),
-          dgemmTask(0,1,1,+alpha,beta),
-          dgemmTask(1)
-          }};
-    gemm_emulator(A,B,C,alpha,beta,tasks);
+    long m = nrows(A),
+         n = ncols(B),
+         k = ncols(A);
+    auto sb = B.size(),
+         sc = C.size();
+    Scratch scratch(2*sb+2*sc);
+    auto Br = scratch.data();
+    auto Bi = Br+sb,
+         Cr = Bi+sb,
+         Ci = Cr+sc;
+    splitPlanes(B.data(),sb,Br,Bi);
+    if(beta != 0.) splitPlanes(C.data(),sc,Cr,Ci);
+    planeGemm(A,B,m,n,k,alpha,A.data(),Br,beta,Cr);
+    planeGemm(A,B,m,n,k,alpha,A.data(),Bi,beta,Ci);
+    mergePlanes(Cr,Ci,sc,C.data(),1.,0.);
     }
 
 void
@@ -204,14 +212,38 @@ gemm_impl(MatRefc<Cplx> A,
           Real alpha,
           Real beta)
     {
-    std::array<const dgemmTask,4> 
-    tasks = 
-        {{dgemmTask(0,0,0,+alpha,beta),
-          dgemmTask(0),
-          dgemmTask(1,0,1,+alpha,beta),
-          dgemmTask(1)
-          }};
-    gemm_emulator(A,B,C,alpha,beta,tasks);
+    long m = nrows(A),
+         n = ncols(B),
+         k = ncols(A);
+    if(!isTransposed(A))
+        {
+        //Interleaved storage of A and C (column major)
+        //is that of real 2m x k and 2m x n matrices,
+        //so a single dgemm suffices
+        gemm_wrapper(false,
+                     isTransposed(B),
+                     2*m,
+                     n,
+                     k,
+                     alpha,
+                     reinterpret_cast<Real const*>(A.data()),
+                     B.data(),
+                     beta,
+                     reinterpret_cast<Real*>(C.data()));
+        return;
+        }
+    auto sa = A.size(),
+         sc = C.size();
+    Scratch scratch(2*sa+2*sc);
+    auto Ar = scratch.data();
+    auto Ai = Ar+sa,
+         Cr = Ai+sa,
+         Ci = Cr+sc;
+    splitPlanes(A.data(),sa,Ar,Ai);
+    if(beta != 0.) splitPlanes(C.data(),sc,Cr,Ci);
+    planeGemm(A,B,m,n,k,alpha,Ar,B.data(),beta,Cr);
+    planeGemm(A,B,m,n,k,alpha,Ai,B.data(),beta,Ci);
+    mergePlanes(Cr,Ci,sc,C.data(),1.,0.);
     }
 
 void
@@ -110,6 +110,8 @@ gemm_wrapper(bool transa,
              LAPACK_REAL beta,
              LAPACK_REAL * C)
     {
+    PROFILE_COUNT(flops,2.*m*n*k);
+    PROFILE_COUNT(gemm_bytes,sizeof(Real)*(1.*m*k+1.*k*n+2.*m*n));
     LAPACK_INT lda = m,
                ldb = k;
 #ifdef ITENSOR_USE_CBLAS
@@ -160,6 +162,8 @@ gemm_wrapper(bool transa,
              Cplx beta,
              Cplx* C)
     {
+    PROFILE_COUNT(flops,8.*m*n*k);
+    PROFILE_COUNT(gemm_bytes,sizeof(Cplx)*(1.*m*k+1.*k*n+2.*m*n));
     LAPACK_INT lda = m,
                ldb = k;
 #ifdef PLATFORM_openblas
@@ -203,11 +207,9 @@ gemm_wrapper(bool transa,
         bt = CblasTrans;
         ldb = n;
         }
-    TIMER_START(31)
     auto palpha = (void*)(&alpha); 
     auto pbeta = (void*)(&beta); 
     cblas_zgemm(CblasColMajor,at,bt,m,n,k,palpha,(void*)A,lda,(void*)B,ldb,pbeta,(void*)C,m);
-    TIMER_STOP(31)
 #else //use Fortran zgemm
     auto *ncA = const_cast<Cplx*>(A);
     auto *ncB = const_cast<Cplx*>(B);
@@ -418,6 +420,53 @@ dorgqr_wrapper(LAPACK_INT* m,     //number of rows of A
     F77NAME(dorgqr)(m,n,k,A,lda,tau,work.data(),&lwork,info);
     }
 
+//
+// zgeqrf
+//
+// QR factorization of a complex matrix A
+//
+void 
+zgeqrf_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               Cplx* A,           //matrix A
+                                  //on return upper triangle contains R
+               LAPACK_INT* lda,   //size of A (usually same as n)
+               Cplx* tau,         //scalar factors of elementary reflectors
+                                  //length should be min(m,n)
+               LAPACK_INT* info)  //error info
+    {
+    static_assert(sizeof(LAPACK_COMPLEX)==sizeof(Cplx),"LAPACK_COMPLEX and itensor::Cplx have different size");
+    std::vector<LAPACK_COMPLEX> work;
+    LAPACK_INT lwork = std::max(1,4*std::max(*n,*m));
+    work.resize(lwork+2); 
+    auto pA = reinterpret_cast<LAPACK_COMPLEX*>(A);
+    auto ptau = reinterpret_cast<LAPACK_COMPLEX*>(tau);
+    F77NAME(zgeqrf)(m,n,pA,lda,ptau,work.data(),&lwork,info);
+    }
+
+//
+// zungqr
+//
+// Generates Q from output of QR factorization routine zgeqrf (see above)
+//
+void 
+zungqr_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               LAPACK_INT* k,     //number of elementary reflectors, typically min(m,n)
+               Cplx* A,           //matrix A, as returned from "A" argument of zgeqrf
+                                  //on return contains Q
+               LAPACK_INT* lda,   //size of A (usually same as n)
+               Cplx* tau,         //scalar factors as returned by zgeqrf
+               LAPACK_INT* info)  //error info
+    {
+    std::vector<LAPACK_COMPLEX> work;
+    LAPACK_INT lwork = std::max(1,4*std::max(*n,*m));
+    work.resize(lwork+2); 
+    auto pA = reinterpret_cast<LAPACK_COMPLEX*>(A);
+    auto ptau = reinterpret_cast<LAPACK_COMPLEX*>(tau);
+    F77NAME(zungqr)(m,n,k,pA,lda,ptau,work.data(),&lwork,info);
+    }
+
 //
 // zheev
 //
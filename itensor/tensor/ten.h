@@ -9,6 +9,7 @@
 #include "itensor/tensor/teniter.h"
 #include "itensor/tensor/range.h"
 #include "itensor/tensor/lapack_wrap.h"
+#include "itensor/util/mapalloc.h"
 
 namespace itensor {
 
@@ -483,7 +484,9 @@ class Ten : public TensorType
     {
     public:
     using value_type = value_type_;
-    using storage_type = std::vector<value_type>;
+    //Same allocator as Dense storage, so the data of
+    //a Ten can be moved into an ITensor without a copy
+    using storage_type = std::vector<value_type,MapAllocator<value_type>>;
     using ref_storage_type = DataRange<value_type>;
     using const_ref_storage_type = DataRange<const value_type>;
     using iterator = typename storage_type::iterator;
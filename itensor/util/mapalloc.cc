@@ -0,0 +1,217 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "itensor/util/mapalloc.h"
+#include "itensor/util/error.h"
+#include "itensor/util/print.h"
+
+namespace itensor {
+
+namespace detail {
+
+const size_t NoMap = std::numeric_limits<size_t>::max();
+
+std::atomic<size_t> map_min_bytes_(NoMap);
+std::atomic<long> map_count_(0);
+std::atomic<long long> map_bytes_(0);
+
+//Longest path which fits in the header page
+const size_t MaxMapPath = MapHeaderBytes-sizeof(MapTag)-1;
+
+struct MapRegistry
+    {
+    std::mutex mutex;
+    std::string dir;
+    bool warned = false;
+    };
+
+MapRegistry&
+mapRegistry()
+    {
+    static MapRegistry R;
+    return R;
+    }
+
+char*
+mapBase(void const* p) { return static_cast<char*>(const_cast<void*>(p))-MapHeaderBytes; }
+
+void
+countMap(long long length)
+    {
+    map_count_.fetch_add(length > 0 ? 1 : -1);
+    map_bytes_.fetch_add(length);
+    }
+
+void*
+mapAlloc(size_t bytes)
+    {
+    if(bytes == 0) return nullptr;
+    auto& R = mapRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    if(R.dir.empty()) return nullptr;
+
+    auto fname = R.dir + "/itensor_map_XXXXXX";
+    auto buf = std::vector<char>(fname.begin(),fname.end());
+    buf.push_back('\0');
+    auto length = MapHeaderBytes+bytes;
+    auto fd = mkstemp(buf.data());
+    void* p = MAP_FAILED;
+    if(fd >= 0)
+        {
+        //Reserve the blocks of the file now: a sparse
+        //file (ftruncate) would raise SIGBUS on the
+        //first write into the mapping once the disk
+        //is full, instead of falling back below
+        if(posix_fallocate(fd,0,length) == 0)
+            {
+            p = mmap(nullptr,length,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+            }
+        close(fd);
+        if(p == MAP_FAILED) unlink(buf.data());
+        }
+    if(p == MAP_FAILED)
+        {
+        //Fall back to the heap, e.g. if the disk is full
+        if(!R.warned)
+            {
+            printfln("Warning: could not map %d bytes in directory %s, using heap storage",bytes,R.dir);
+            R.warned = true;
+            }
+        return nullptr;
+        }
+    auto base = static_cast<char*>(p);
+    std::copy(buf.begin(),buf.end(),base);
+    auto data = base+MapHeaderBytes;
+    mapTag(data).length = length;
+    mapTag(data).magic = MapMagic;
+    countMap(length);
+    return data;
+    }
+
+void
+mapFree(void* p)
+    {
+    auto base = mapBase(p);
+    auto length = mapTag(p).length;
+    unlink(base);
+    munmap(base,length);
+    countMap(-(long long)length);
+    }
+
+void
+writeAll(int fd,
+         char const* p,
+         size_t n,
+         std::string const& fname)
+    {
+    while(n > 0)
+        {
+        auto w = write(fd,p,n);
+        if(w < 0)
+            {
+            close(fd);
+            throw ITError(format("mapSave: could not write to file %s",fname));
+            }
+        p += w;
+        n -= w;
+        }
+    }
+
+//Returns false if the file ends before n bytes are read
+bool
+readAll(int fd,
+        char* p,
+        size_t n)
+    {
+    while(n > 0)
+        {
+        auto r = read(fd,p,n);
+        if(r <= 0) return false;
+        p += r;
+        n -= r;
+        }
+    return true;
+    }
+
+void
+mapSave(void const* p,
+        size_t bytes,
+        std::string const& fname)
+    {
+    auto fd = open(fname.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd < 0) throw ITError(format("mapSave: could not open file %s for writing",fname));
+    auto header = std::vector<char>(MapHeaderBytes,'\0');
+    auto& htag = *(reinterpret_cast<MapTag*>(header.data()+MapHeaderBytes)-1);
+    htag.length = MapHeaderBytes+bytes;
+    htag.magic = MapMagic;
+    writeAll(fd,header.data(),header.size(),fname);
+    writeAll(fd,static_cast<char const*>(p),bytes,fname);
+    close(fd);
+    }
+
+void
+mapLoad(std::string const& fname,
+        void* p,
+        size_t bytes)
+    {
+    auto fd = open(fname.c_str(),O_RDONLY);
+    if(fd < 0) throw ITError(format("mapLoad: could not open file %s",fname));
+    auto header = std::vector<char>(MapHeaderBytes,'\0');
+    auto htag = MapTag{};
+    if(readAll(fd,header.data(),header.size()))
+        {
+        htag = *(reinterpret_cast<MapTag*>(header.data()+MapHeaderBytes)-1);
+        }
+    if(htag.magic != MapMagic || htag.length != MapHeaderBytes+bytes)
+        {
+        close(fd);
+        throw ITError(format("mapLoad: file %s is not a tensor data file of %d bytes",fname,bytes));
+        }
+    auto ok = readAll(fd,static_cast<char*>(p),bytes);
+    close(fd);
+    if(!ok) throw ITError(format("mapLoad: could not read file %s",fname));
+    }
+
+} //namespace detail
+
+void
+mapStorage(std::string const& dir,
+           size_t min_bytes)
+    {
+    if(dir.empty()) Error("mapStorage: directory name is empty");
+    if(access(dir.c_str(),W_OK) != 0) Error(format("mapStorage: cannot write to directory %s",dir));
+    if(dir.size()+20 > detail::MaxMapPath) Error(format("mapStorage: directory name %s is too long",dir));
+    auto& R = detail::mapRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    R.dir = dir;
+    R.warned = false;
+    detail::map_min_bytes_ = std::max(min_bytes,size_t(1));
+    }
+
+void
+unmapStorage()
+    {
+    auto& R = detail::mapRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    R.dir.clear();
+    detail::map_min_bytes_ = detail::NoMap;
+    }
+
+bool
+storageMapped() { return detail::map_min_bytes_.load() != detail::NoMap; }
+
+long
+numStorageMaps() { return detail::map_count_.load(); }
+
+long long
+mappedBytes() { return detail::map_bytes_.load(); }
+
+} //namespace itensor
@@ -0,0 +1,174 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_MAPALLOC_H
+#define __ITENSOR_MAPALLOC_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+
+//
+// File-backed (memory mapped) tensor storage
+//
+// After calling
+//
+//   mapStorage("/scratch/me");
+//
+// the data of every new ITensor or IQTensor with
+// Dense or QDense storage of at least 1 MB (see
+// min_bytes below), and of every Matrix, Vector or
+// Tensor of that size, is placed in a file in the given
+// directory mapped into memory with mmap, instead
+// of on the heap. The operating system page cache
+// then decides which parts are held in RAM, writing
+// pages out to the file under memory pressure, so
+// the total size of the tensors can exceed the
+// physical memory of the machine.
+//
+// Mapped data is accessed exactly like heap data:
+// contraction, addition and all other operations
+// work without change, at the speed of the page
+// cache once the data is resident.
+//
+// Each file is named itensor_map_XXXXXX and is
+// removed when its storage is freed. A program which
+// crashes leaves its files behind in the directory.
+// The space of each file is reserved when it is
+// created; if that fails (e.g. the disk is full)
+// the storage is placed on the heap instead.
+// Tensors can be saved as raw data files, and read
+// back into (possibly mapped) storage, with
+// writeMapped and readMapped (see itensor/mapstorage.h).
+//
+// unmapStorage() turns mapping off again for new
+// storage; existing mapped storage stays valid.
+//
+
+namespace itensor {
+
+//Map storage of at least min_bytes into
+//files created in the directory dir
+void
+mapStorage(std::string const& dir,
+           size_t min_bytes = 1024*1024);
+
+void
+unmapStorage();
+
+//True if new storage may be mapped
+bool
+storageMapped();
+
+//Number and total bytes of mappings currently alive
+long
+numStorageMaps();
+
+long long
+mappedBytes();
+
+namespace detail {
+
+extern std::atomic<size_t> map_min_bytes_;
+
+//
+// Every block handed out by MapAllocator is
+// preceded by a MapTag. Heap blocks have length 0.
+// Mapped blocks start a page (MapHeaderBytes) before
+// the data: the page holds the path of the file,
+// removed when the block is freed, and ends with
+// the tag, whose length is that of the whole mapping.
+//
+struct MapTag
+    {
+    size_t length = 0;
+    size_t magic = 0;
+    };
+
+const size_t MapHeaderBytes = 4096;
+const size_t MapMagic = 0x495450414d; //"ITMAP"
+
+inline MapTag&
+mapTag(void const* p) { return *(reinterpret_cast<MapTag*>(const_cast<void*>(p))-1); }
+
+//Returns the data pointer of a new mapped block, or
+//nullptr if mapping is off or fails
+void*
+mapAlloc(size_t bytes);
+
+//Unmaps the mapped block with data p and removes
+//its file
+void
+mapFree(void* p);
+
+//Writes the bytes at p to the file fname: a header
+//page holding a MapTag, then the data
+void
+mapSave(void const* p,
+        size_t bytes,
+        std::string const& fname);
+
+//Reads the data of the file fname, written by
+//mapSave, into the bytes at p
+void
+mapLoad(std::string const& fname,
+        void* p,
+        size_t bytes);
+
+} //namespace detail
+
+//
+// Allocator for std::vector placing large blocks
+// in mapped files while storage is mapped, and on
+// the heap otherwise. Each block carries a MapTag
+// (16 bytes) telling deallocate how to free it, so
+// freeing takes no lock. While nothing is mapped
+// the only other cost is one relaxed atomic load
+// per allocation.
+//
+template<typename T>
+struct MapAllocator
+    {
+    using value_type = T;
+
+    MapAllocator() { }
+
+    template<typename U>
+    MapAllocator(MapAllocator<U> const&) { }
+
+    T*
+    allocate(size_t n)
+        {
+        auto bytes = n*sizeof(T);
+        if(bytes >= detail::map_min_bytes_.load(std::memory_order_relaxed))
+            {
+            auto p = detail::mapAlloc(bytes);
+            if(p) return static_cast<T*>(p);
+            }
+        auto tag = static_cast<detail::MapTag*>(::operator new(bytes+sizeof(detail::MapTag)));
+        new(tag) detail::MapTag{};
+        return reinterpret_cast<T*>(tag+1);
+        }
+
+    void
+    deallocate(T* p, size_t)
+        {
+        if(detail::mapTag(p).length > 0) detail::mapFree(p);
+        else                             ::operator delete(&detail::mapTag(p));
+        }
+    };
+
+template<typename T, typename U>
+bool
+operator==(MapAllocator<T> const&, MapAllocator<U> const&) { return true; }
+
+template<typename T, typename U>
+bool
+operator!=(MapAllocator<T> const&, MapAllocator<U> const&) { return false; }
+
+} //namespace itensor
+
+#endif
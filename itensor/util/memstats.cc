@@ -0,0 +1,179 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <array>
+#include <mutex>
+#include <ostream>
+#include "itensor/util/memstats.h"
+#include "itensor/util/error.h"
+#include "itensor/util/print.h"
+
+namespace itensor {
+
+namespace detail {
+
+std::atomic<bool> mem_tracking_on_(false);
+
+thread_local MemCategory mem_category_ = MemCategory::Other;
+
+//Largest number of distinct storage type names
+const size_t MaxMemType = 64;
+
+struct MemTotals
+    {
+    std::atomic<long long> live;
+    std::atomic<long long> peak;
+    std::atomic<long> count;
+
+    MemTotals() : live(0), peak(0), count(0) { }
+
+    void
+    add(long long bytes)
+        {
+        auto now = live.fetch_add(bytes,std::memory_order_relaxed)+bytes;
+        count.fetch_add(bytes >= 0 ? 1 : -1,std::memory_order_relaxed);
+        auto cur = peak.load(std::memory_order_relaxed);
+        while(now > cur && !peak.compare_exchange_weak(cur,now,std::memory_order_relaxed)) { }
+        }
+
+    MemEntry
+    entry(std::string const& name) const
+        {
+        auto e = MemEntry();
+        e.name = name;
+        e.live = live.load();
+        e.peak = peak.load();
+        e.count = count.load();
+        return e;
+        }
+    };
+
+struct MemRegistry
+    {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::array<MemTotals,MaxMemType> types;
+    std::array<MemTotals,NMemCategory> categories;
+    MemTotals total;
+    };
+
+MemRegistry&
+memRegistry()
+    {
+    static MemRegistry R;
+    return R;
+    }
+
+int
+memTypeId(const char* name)
+    {
+    auto& R = memRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    size_t id = 0;
+    for(; id < R.names.size(); ++id)
+        {
+        if(R.names[id] == name) return id;
+        }
+    if(R.names.size() >= MaxMemType) Error("Too many distinct storage type names");
+    R.names.emplace_back(name);
+    return id;
+    }
+
+void
+memAdd(int id, MemCategory c, long long bytes)
+    {
+    auto& R = memRegistry();
+    R.types[id].add(bytes);
+    R.categories[int(c)].add(bytes);
+    R.total.add(bytes);
+    }
+
+} //namespace detail
+
+const char*
+memCategoryName(MemCategory c)
+    {
+    switch(c)
+        {
+        case MemCategory::Environment: return "environment";
+        case MemCategory::Wavefunction: return "wavefunction";
+        case MemCategory::Temporary: return "temporary";
+        default: return "other";
+        }
+    }
+
+bool
+memTracking(bool val)
+    {
+    return detail::mem_tracking_on_.exchange(val);
+    }
+
+MemCategory
+memCategory() { return detail::mem_category_; }
+
+MemScope::
+MemScope(MemCategory c)
+  : prev_(detail::mem_category_)
+    {
+    detail::mem_category_ = c;
+    }
+
+MemScope::
+~MemScope()
+    {
+    detail::mem_category_ = prev_;
+    }
+
+MemEntry const* MemStats::
+type(std::string const& name) const
+    {
+    for(auto& e : types) if(e.name == name) return &e;
+    return nullptr;
+    }
+
+MemStats
+memStats()
+    {
+    auto& R = detail::memRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    auto M = MemStats();
+    M.total = R.total.entry("total");
+    for(auto n = 0ul; n < R.names.size(); ++n)
+        {
+        M.types.push_back(R.types[n].entry(R.names[n]));
+        }
+    for(auto c = 0; c < NMemCategory; ++c)
+        {
+        M.categories.push_back(R.categories[c].entry(memCategoryName(MemCategory(c))));
+        }
+    return M;
+    }
+
+void
+resetMemPeak()
+    {
+    auto& R = detail::memRegistry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    auto reset = [](detail::MemTotals & T) { T.peak = T.live.load(); };
+    for(auto& T : R.types) reset(T);
+    for(auto& T : R.categories) reset(T);
+    reset(R.total);
+    }
+
+std::ostream&
+operator<<(std::ostream& s, MemStats const& M)
+    {
+    auto MB = [](long long bytes) { return bytes/(1024.*1024.); };
+    auto show = [&s,&MB](MemEntry const& e)
+        {
+        s << format("%-14s live = %.3f MB, peak = %.3f MB, objects = %d\n",
+                    e.name,MB(e.live),MB(e.peak),e.count);
+        };
+    show(M.total);
+    for(auto& e : M.categories) if(e.peak > 0) show(e);
+    for(auto& e : M.types) if(e.peak > 0) show(e);
+    return s;
+    }
+
+} //namespace itensor
@@ -0,0 +1,171 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_MEMSTATS_H
+#define __ITENSOR_MEMSTATS_H
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//
+// Memory accounting for tensor storage
+//
+// While tracking is on (memTracking(true)), every
+// ITensor or IQTensor storage object records its
+// size in bytes when it is created, under its
+// storage type (e.g. "DenseReal") and under the
+// category of the innermost MemScope active on the
+// creating thread:
+//
+//   {
+//   MemScope scope(MemCategory::Environment);
+//   L = L*psi.A(j)*H.A(j)*dag(prime(psi.A(j)));
+//   }
+//
+// The bytes are subtracted when the storage is
+// destroyed. Live and peak (high-water mark) bytes
+// are read with memStats(), e.g.
+//
+//   memTracking(true);
+//   ... //do work
+//   auto M = memStats();
+//   printfln("peak = %d bytes",M.total.peak);
+//   println(M);
+//
+// Storage created while tracking was off is never
+// counted. Storage modified in place keeps the size
+// it was created with, and keeps its category when
+// shared with or moved into other tensors.
+//
+// While tracking is off, creating storage costs
+// one relaxed atomic load.
+//
+
+namespace itensor {
+
+enum class MemCategory
+    {
+    Other = 0,
+    Environment,
+    Wavefunction,
+    Temporary
+    };
+
+const int NMemCategory = 4;
+
+const char*
+memCategoryName(MemCategory c);
+
+namespace detail {
+extern std::atomic<bool> mem_tracking_on_;
+}
+
+bool inline
+memTracking() { return detail::mem_tracking_on_.load(std::memory_order_relaxed); }
+
+//Turn memory tracking on or off;
+//returns the previous setting
+bool
+memTracking(bool val);
+
+//
+// Sets memTracking(val) for the lifetime of the
+// scope, restoring the previous setting on exit
+// (including when an exception is thrown)
+//
+class MemTrackingScope
+    {
+    bool prev_;
+    public:
+
+    explicit
+    MemTrackingScope(bool val) : prev_(memTracking(val)) { }
+
+    MemTrackingScope(MemTrackingScope const&) = delete;
+
+    MemTrackingScope&
+    operator=(MemTrackingScope const&) = delete;
+
+    ~MemTrackingScope() { memTracking(prev_); }
+    };
+
+//Category of storage created on this thread
+MemCategory
+memCategory();
+
+//
+// Storage created on this thread while a MemScope
+// is alive is counted under its category
+//
+class MemScope
+    {
+    MemCategory prev_;
+    public:
+
+    explicit
+    MemScope(MemCategory c);
+
+    MemScope(MemScope const&) = delete;
+
+    MemScope&
+    operator=(MemScope const&) = delete;
+
+    ~MemScope();
+    };
+
+struct MemEntry
+    {
+    std::string name;
+    long long live = 0;  //bytes currently allocated
+    long long peak = 0;  //largest value of live
+    long count = 0;      //number of live storage objects
+    };
+
+struct MemStats
+    {
+    MemEntry total;
+    std::vector<MemEntry> types;      //per storage type
+    std::vector<MemEntry> categories; //per MemCategory
+
+    MemEntry const&
+    category(MemCategory c) const { return categories.at(int(c)); }
+
+    //Entry of the storage type called name
+    //(nullptr if none was created yet)
+    MemEntry const*
+    type(std::string const& name) const;
+    };
+
+//Current totals
+MemStats
+memStats();
+
+//Set all peak values to the current live values,
+//for example to find the high-water mark of one sweep
+void
+resetMemPeak();
+
+//Prints live and peak megabytes of every
+//category and storage type in use
+std::ostream&
+operator<<(std::ostream& s, MemStats const& M);
+
+namespace detail {
+
+//Id used to count storage of type name
+int
+memTypeId(const char* name);
+
+//Add bytes (negative when freeing) to the
+//totals of storage type id and category c
+void
+memAdd(int id, MemCategory c, long long bytes);
+
+} //namespace detail
+
+} //namespace itensor
+
+#endif
@@ -3,9 +3,11 @@
 #include "mpi.h"
 #include <sstream>
 #include <vector>
+#include <memory>
 #include <type_traits>
 #include "itensor/util/readwrite.h"
 #include "itensor/util/args.h"
+#include "itensor/iqtensor.h"
 
 #define DEFAULT_BUFSIZE 500000
 
@@ -24,6 +26,12 @@ template <class T, class... Rest>
 void 
 broadcast(Environment const& env, T & obj, Rest &... rest);
 
+//Broadcast Dense and QDense data directly
+//from and into tensor storage
+template <typename I>
+void
+broadcast(Environment const& env, ITensorT<I> & T);
+
 template <typename T>
 void 
 scatterVector(Environment const& env, std::vector<T> &v);
@@ -104,6 +112,102 @@ class Environment
 
     };
 
+namespace detail {
+
+//Raw data of a Dense or QDense tensor,
+//viewed as an array of doubles
+struct MsgData
+    {
+    double* data = nullptr;
+    size_t size = 0;
+    std::vector<BlOf> const* offsets = nullptr;
+    };
+
+inline const char*
+typeNameOf(MsgData const&) { return "MsgData"; }
+
+template<typename T>
+void
+doTask(MsgData & M, Dense<T> const& d)
+    {
+    M.data = reinterpret_cast<double*>(const_cast<T*>(d.data()));
+    M.size = d.size()*sizeof(T)/sizeof(double);
+    }
+
+template<typename T>
+void
+doTask(MsgData & M, QDense<T> const& d)
+    {
+    M.data = reinterpret_cast<double*>(const_cast<T*>(d.data()));
+    M.size = d.size()*sizeof(T)/sizeof(double);
+    M.offsets = &d.offsets;
+    }
+
+//Largest number of doubles sent in one message
+//(keeps MPI's int counts in range)
+const size_t MaxRawChunk = 1ul << 27;
+
+struct SendState
+    {
+    char flag = 'f';
+    int msize = 0;
+    std::string header;
+    std::shared_ptr<const ITData> store; //keeps the raw data alive
+    std::vector<MPI_Request> reqs;
+    };
+
+} //namespace detail
+
+//
+// Handle to a non-blocking send started by
+// MailBox::isend. The send is complete after
+// wait() returns or test() returns true;
+// the destructor waits for completion.
+//
+class SendRequest
+    {
+    std::unique_ptr<detail::SendState> s_;
+    public:
+
+    SendRequest() { }
+
+    explicit
+    SendRequest(std::unique_ptr<detail::SendState>&& s) : s_(std::move(s)) { }
+
+    SendRequest(SendRequest&& o) = default;
+
+    SendRequest&
+    operator=(SendRequest&& o) 
+        { 
+        wait(); 
+        s_ = std::move(o.s_); 
+        return *this; 
+        }
+
+    ~SendRequest() { wait(); }
+
+    //True if the send has not yet completed
+    explicit operator bool() const { return bool(s_); }
+
+    bool
+    test()
+        {
+        if(!s_) return true;
+        int done = 0;
+        MPI_Testall(s_->reqs.size(),s_->reqs.data(),&done,MPI_STATUSES_IGNORE);
+        if(done) s_.reset();
+        return done;
+        }
+
+    void
+    wait()
+        {
+        if(!s_) return;
+        MPI_Waitall(s_->reqs.size(),s_->reqs.data(),MPI_STATUSES_IGNORE);
+        s_.reset();
+        }
+    };
+
 class MailBox
     {
     Environment const* env_;
@@ -158,6 +262,32 @@ class MailBox
     void 
     send(std::stringstream const& data);
 
+    //
+    // ITensors and IQTensors with Dense or QDense
+    // storage are sent as a short header (indices,
+    // scale and block offsets) followed by the raw
+    // data, which goes straight from the storage of
+    // the sent tensor into the storage of the
+    // received one. Other storage is serialized.
+    //
+
+    template <typename I>
+    void
+    receive(ITensorT<I>& T);
+
+    template <typename I>
+    void
+    send(ITensorT<I> const& T) { isend(T).wait(); }
+
+    //Non-blocking send: returns right away, so
+    //work can be done while the data is in flight.
+    //T can be modified or destroyed meanwhile,
+    //since the request holds a (copy-on-write)
+    //reference to its storage.
+    template <typename I>
+    SendRequest
+    isend(ITensorT<I> const& T);
+
     template <class T> 
     void 
     broadcast(T& obj) const { checkValid(); env_->broadcast(obj); }
@@ -176,6 +306,9 @@ class MailBox
         MPI_Irecv(&flag_,1,MPI_CHAR,other_node_,flagTag(),com,&req_); 
         }
 
+    void
+    receiveRaw(detail::MsgData const& M);
+
     static int new_tag(Environment const& env, int other_node)
         {
         static std::vector<int> tag(env.nnodes(),0);
@@ -286,11 +419,96 @@ broadcast(Environment const& env, T & obj, Rest &... rest)
     broadcast(env,rest...);
     }
 
+namespace detail {
+
+template <typename I>
+MsgData
+writeHeader(std::ostream& s, ITensorT<I> const& T)
+    {
+    auto type = StorageType::Null;
+    if(T.store()) type = doTask(StorageType{},T.store());
+    itensor::write(s,type);
+    auto M = MsgData{};
+    if(type != StorageType::DenseReal && type != StorageType::DenseCplx
+       && type != StorageType::QDenseReal && type != StorageType::QDenseCplx)
+        {
+        itensor::write(s,T);
+        return M;
+        }
+    doTask(M,T.store());
+    itensor::write(s,T.inds());
+    itensor::write(s,LogNum(T.scale()));
+    if(M.offsets) itensor::write(s,*M.offsets);
+    itensor::write(s,M.size);
+    return M;
+    }
+
+template <typename StoreT, typename I>
+MsgData
+makeStorage(ITensorT<I>& T, 
+            IndexSetT<I>&& is, 
+            StoreT&& d, 
+            LogNum const& scale)
+    {
+    auto M = MsgData{};
+    doTask(M,d);
+    T = ITensorT<I>(std::move(is),std::move(d),scale);
+    return M;
+    }
+
+//Reads a header written by writeHeader, then
+//returns the storage to receive the raw data in
+template <typename I>
+MsgData
+readHeader(std::istream& s, ITensorT<I>& T)
+    {
+    auto type = StorageType::Null;
+    itensor::read(s,type);
+    if(type != StorageType::DenseReal && type != StorageType::DenseCplx
+       && type != StorageType::QDenseReal && type != StorageType::QDenseCplx)
+        {
+        itensor::read(s,T);
+        return MsgData{};
+        }
+    auto is = IndexSetT<I>{};
+    itensor::read(s,is);
+    auto scale = LogNum{};
+    itensor::read(s,scale);
+    auto off = std::vector<BlOf>{};
+    if(type == StorageType::QDenseReal || type == StorageType::QDenseCplx) itensor::read(s,off);
+    size_t size = 0;
+    itensor::read(s,size);
+    if(type == StorageType::DenseReal) return makeStorage(T,std::move(is),DenseReal(size),scale);
+    if(type == StorageType::DenseCplx) return makeStorage(T,std::move(is),DenseCplx(size/2),scale);
+    if(type == StorageType::QDenseReal) return makeStorage(T,std::move(is),QDenseReal(off,size),scale);
+    return makeStorage(T,std::move(is),QDenseCplx(off,size/2),scale);
+    }
+
+} //namespace detail
+
+template <typename I>
+void
+broadcast(Environment const& env, ITensorT<I> & T)
+    {
+    if(env.nnodes() == 1) return;
+    const int root = 0;
+    std::stringstream header;
+    auto M = detail::MsgData{};
+    if(env.rank() == root) M = detail::writeHeader(header,T);
+    env.broadcast(header);
+    if(env.rank() != root) M = detail::readHeader(header,T);
+    for(size_t n = 0; n < M.size; n += detail::MaxRawChunk)
+        {
+        auto count = std::min(detail::MaxRawChunk,M.size-n);
+        MPI_Bcast(M.data+n,count,MPI_DOUBLE,root,MPI_COMM_WORLD);
+        }
+    }
+
 template <class T>
 void Environment::
 broadcast(T& obj) const 
     { 
-    itensor::broadcast<T>(*this,obj); 
+    itensor::broadcast(*this,obj); 
     }
 
 template <class T, class... Rest>
@@ -487,13 +705,30 @@ template <class T, typename... Args>
 T MailBox::
 receive(Args&&... args)
     { 
-    std::stringstream data; 
-    receive(data); 
     T obj(std::forward<Args>(args)...);
-    itensor::read(data,obj);
+    receive(obj);
     return obj;
     }
 
+void inline MailBox::
+receiveRaw(detail::MsgData const& M)
+    {
+    for(size_t n = 0; n < M.size; n += detail::MaxRawChunk)
+        {
+        auto count = std::min(detail::MaxRawChunk,M.size-n);
+        MPI_Recv(M.data+n,count,MPI_DOUBLE,other_node_,tag(),com,&rstatus_);
+        }
+    }
+
+template <typename I>
+void MailBox::
+receive(ITensorT<I>& T)
+    {
+    std::stringstream header;
+    receive(header);
+    receiveRaw(detail::readHeader(header,T));
+    }
+
 
 void inline MailBox::
 send(std::stringstream const& data)
@@ -525,6 +760,45 @@ send(T const& obj)
     send(data); 
     }
 
+template <typename I>
+SendRequest MailBox::
+isend(ITensorT<I> const& T)
+    {
+    checkValid();
+    auto S = std::unique_ptr<detail::SendState>(new detail::SendState);
+    std::stringstream header;
+    auto M = detail::writeHeader(header,T);
+    if(M.data) S->store = T.store().p;
+    S->header = header.str();
+    S->msize = S->header.length();
+
+    auto post = [this,&S](void* buf, int count, MPI_Datatype type, int tag)
+        {
+        S->reqs.emplace_back();
+        MPI_Isend(buf,count,type,other_node_,tag,com,&S->reqs.back());
+        };
+
+    post(&S->flag,1,MPI_CHAR,flagTag());
+    post(&S->msize,1,MPI_INT,sizeTag());
+
+    //Same chunks as send(std::stringstream)
+    auto datap = const_cast<char*>(S->header.data());
+    int quo = S->msize/rbuffer.size(), 
+        rem = S->msize%rbuffer.size();
+    for(int q = 0; q < quo; ++q)
+        {
+        post(datap+q*rbuffer.size(),rbuffer.size(),MPI_CHAR,tag());
+        }
+    post(datap+quo*rbuffer.size(),rem,MPI_CHAR,tag());
+
+    for(size_t n = 0; n < M.size; n += detail::MaxRawChunk)
+        {
+        auto count = std::min(detail::MaxRawChunk,M.size-n);
+        post(M.data+n,count,MPI_DOUBLE,tag());
+        }
+    return SendRequest(std::move(S));
+    }
+
 } //namespace itensor
 
 #endif
@@ -0,0 +1,186 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#include <array>
+#include <mutex>
+#include <ostream>
+#include "itensor/util/profiling.h"
+#include "itensor/util/error.h"
+#include "itensor/util/print.h"
+
+namespace itensor {
+
+namespace detail {
+
+std::atomic<bool> profiling_on_(false);
+
+//Largest number of distinct section names
+const size_t MaxSection = 256;
+
+struct SectionTotals
+    {
+    std::atomic<long long> nanosec;
+    std::atomic<long> count;
+    std::atomic<double> total;
+
+    SectionTotals() : nanosec(0), count(0), total(0.) { }
+    };
+
+struct ProfileRegistry
+    {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::array<SectionTotals,MaxSection> totals;
+    };
+
+ProfileRegistry&
+registry()
+    {
+    static ProfileRegistry R;
+    return R;
+    }
+
+} //namespace detail
+
+bool
+profiling(bool val)
+    {
+    return detail::profiling_on_.exchange(val);
+    }
+
+ProfileSection::
+ProfileSection(const char* name)
+    {
+    auto& R = detail::registry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    for(id_ = 0; id_ < R.names.size(); ++id_)
+        {
+        if(R.names[id_] == name) return;
+        }
+    if(R.names.size() >= detail::MaxSection) Error("Too many distinct profiling section names");
+    R.names.emplace_back(name);
+    }
+
+void ProfileSection::
+addTime(long long nanosec) const
+    {
+    auto& T = detail::registry().totals[id_];
+    T.nanosec.fetch_add(nanosec,std::memory_order_relaxed);
+    T.count.fetch_add(1,std::memory_order_relaxed);
+    }
+
+void ProfileSection::
+add(double amount) const
+    {
+    auto& T = detail::registry().totals[id_];
+    auto cur = T.total.load(std::memory_order_relaxed);
+    while(!T.total.compare_exchange_weak(cur,cur+amount,std::memory_order_relaxed)) { }
+    T.count.fetch_add(1,std::memory_order_relaxed);
+    }
+
+ProfileData
+profileData()
+    {
+    auto& R = detail::registry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    auto P = ProfileData();
+    P.entries.resize(R.names.size());
+    for(auto n = 0ul; n < R.names.size(); ++n)
+        {
+        auto& e = P.entries[n];
+        auto& T = R.totals[n];
+        e.name = R.names[n];
+        e.time = 1E-9*T.nanosec.load();
+        e.count = T.count.load();
+        e.total = T.total.load();
+        }
+    return P;
+    }
+
+void
+resetProfile()
+    {
+    auto& R = detail::registry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    for(auto& T : R.totals)
+        {
+        T.nanosec = 0;
+        T.count = 0;
+        T.total = 0.;
+        }
+    }
+
+ProfileEntry const* ProfileData::
+find(std::string const& name) const
+    {
+    for(auto& e : entries) if(e.name == name) return &e;
+    return nullptr;
+    }
+
+double ProfileData::
+time(std::string const& name) const
+    {
+    auto* e = find(name);
+    return e ? e->time : 0.;
+    }
+
+long ProfileData::
+count(std::string const& name) const
+    {
+    auto* e = find(name);
+    return e ? e->count : 0;
+    }
+
+double ProfileData::
+total(std::string const& name) const
+    {
+    auto* e = find(name);
+    return e ? e->total : 0.;
+    }
+
+ProfileData
+operator-(ProfileData const& A, ProfileData const& B)
+    {
+    auto res = A;
+    for(auto& e : res.entries)
+        {
+        auto* b = B.find(e.name);
+        if(!b) continue;
+        e.time -= b->time;
+        e.count -= b->count;
+        e.total -= b->total;
+        }
+    return res;
+    }
+
+void
+writeJSON(std::ostream& s, ProfileData const& P)
+    {
+    s << "{";
+    auto first = true;
+    for(auto& e : P.entries)
+        {
+        if(e.count == 0) continue;
+        if(!first) s << ", ";
+        first = false;
+        s << format("\"%s\": {\"time\": %.6f, \"count\": %d, \"total\": %.6e}",
+                    e.name,e.time,e.count,e.total);
+        }
+    s << "}";
+    }
+
+std::ostream&
+operator<<(std::ostream& s, ProfileData const& P)
+    {
+    for(auto& e : P.entries)
+        {
+        if(e.count == 0) continue;
+        s << format("%-20s time = %.4f, count = %d",e.name,e.time,e.count);
+        if(e.total != 0) s << format(", total = %.4E",e.total);
+        s << "\n";
+        }
+    return s;
+    }
+
+} //namespace itensor
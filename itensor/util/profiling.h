@@ -0,0 +1,219 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_PROFILING_H
+#define __ITENSOR_PROFILING_H
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//
+// Named, runtime-switchable profiling
+//
+// Code sections are timed under a name:
+//
+//   PROFILE_SCOPE(svd)       //times to the end of the enclosing scope
+//
+//   PROFILE_START(blocks)    //times up to the matching
+//   ...                      //PROFILE_STOP in the same scope
+//   PROFILE_STOP(blocks)
+//
+// and quantities such as floating point
+// operations are added to named counters:
+//
+//   PROFILE_COUNT(flops,2*m*n*k);
+//
+// Collection is off by default and is turned
+// on with profiling(true). While it is off, each
+// timer or counter costs one relaxed atomic load,
+// so these macros are left compiled in.
+//
+// Times of nested sections are inclusive; a section
+// entered concurrently on several threads accumulates
+// the sum of the threads' times.
+//
+// Read the totals with profileData(), e.g.
+//
+//   profiling(true);
+//   auto start = profileData();
+//   ... //do work
+//   auto P = profileData()-start;
+//   printfln("svd time = %.3f",P.time("svd"));
+//   writeJSON(std::cout,P);
+//
+
+#define PROFILE_SCOPE(NAME) \
+    static const itensor::ProfileSection profile_section_##NAME##_(#NAME); \
+    itensor::ProfileTimer profile_timer_##NAME##_(profile_section_##NAME##_);
+
+#define PROFILE_START(NAME) PROFILE_SCOPE(NAME)
+
+#define PROFILE_STOP(NAME) profile_timer_##NAME##_.stop();
+
+#define PROFILE_COUNT(NAME,AMOUNT) \
+    do { \
+    if(itensor::profiling()) \
+        { \
+        static const itensor::ProfileSection profile_counter_##NAME##_(#NAME); \
+        profile_counter_##NAME##_.add(AMOUNT); \
+        } \
+    } while(0)
+
+namespace itensor {
+
+namespace detail {
+extern std::atomic<bool> profiling_on_;
+}
+
+bool inline
+profiling() { return detail::profiling_on_.load(std::memory_order_relaxed); }
+
+//Turn collection of profiling data on or off;
+//returns the previous setting
+bool
+profiling(bool val);
+
+//
+// Sets profiling(val) for the lifetime of the
+// scope, restoring the previous setting on exit
+// (including when an exception is thrown)
+//
+class ProfilingScope
+    {
+    bool prev_;
+    public:
+
+    explicit
+    ProfilingScope(bool val) : prev_(profiling(val)) { }
+
+    ProfilingScope(ProfilingScope const&) = delete;
+
+    ProfilingScope&
+    operator=(ProfilingScope const&) = delete;
+
+    ~ProfilingScope() { profiling(prev_); }
+    };
+
+//
+// Handle to a named timer or counter,
+// usually held in a function-local static.
+// Sections with the same name share totals.
+//
+class ProfileSection
+    {
+    size_t id_ = 0;
+    public:
+
+    explicit
+    ProfileSection(const char* name);
+
+    size_t
+    id() const { return id_; }
+
+    //Add elapsed time in nanoseconds
+    //and increment the call count
+    void
+    addTime(long long nanosec) const;
+
+    //Add amount to the counter total
+    //and increment the call count
+    void
+    add(double amount) const;
+    };
+
+class ProfileTimer
+    {
+    public:
+    using clock_type = std::chrono::steady_clock;
+    private:
+    ProfileSection const& sec_;
+    clock_type::time_point start_;
+    bool running_ = false;
+    public:
+
+    explicit
+    ProfileTimer(ProfileSection const& sec)
+      : sec_(sec)
+        {
+        if(profiling())
+            {
+            running_ = true;
+            start_ = clock_type::now();
+            }
+        }
+
+    ProfileTimer(ProfileTimer const&) = delete;
+
+    ProfileTimer&
+    operator=(ProfileTimer const&) = delete;
+
+    ~ProfileTimer() { stop(); }
+
+    void
+    stop()
+        {
+        if(!running_) return;
+        running_ = false;
+        auto d = clock_type::now()-start_;
+        sec_.addTime(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+    };
+
+struct ProfileEntry
+    {
+    std::string name;
+    double time = 0;  //seconds
+    long count = 0;   //number of timings or additions
+    double total = 0; //sum of counter amounts
+    };
+
+struct ProfileData
+    {
+    std::vector<ProfileEntry> entries;
+
+    //Time in seconds spent in section name
+    double
+    time(std::string const& name) const;
+
+    //Number of times section name was
+    //entered or counter name was added to
+    long
+    count(std::string const& name) const;
+
+    //Total added to counter name
+    double
+    total(std::string const& name) const;
+
+    ProfileEntry const*
+    find(std::string const& name) const;
+    };
+
+//Current totals of all sections and counters
+ProfileData
+profileData();
+
+//Zero all totals
+void
+resetProfile();
+
+//Difference of totals, useful for reporting
+//the work done between two calls to profileData()
+ProfileData
+operator-(ProfileData const& A, ProfileData const& B);
+
+//Writes P as a JSON object of the form
+//{"name": {"time": ..., "count": ..., "total": ...}, ...}
+//omitting sections which were never used
+void
+writeJSON(std::ostream& s, ProfileData const& P);
+
+std::ostream&
+operator<<(std::ostream& s, ProfileData const& P);
+
+} //namespace itensor
+
+#endif
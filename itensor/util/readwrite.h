@@ -12,6 +12,7 @@
 #include "itensor/types.h"
 #include "itensor/util/error.h"
 #include "itensor/util/infarray.h"
+#include "itensor/util/profiling.h"
 
 #if defined(_WIN32)
 #include <process.h>
@@ -153,12 +154,12 @@ write(std::ostream& s, const Cplx& z)
     s.write((char*)&i,sizeof(i));
     }
 
-template<typename T>
+template<typename T, typename A>
 void
-read(std::istream& s, std::vector<T> & v);
-template<typename T>
+read(std::istream& s, std::vector<T,A> & v);
+template<typename T, typename A>
 void
-write(std::ostream& s, std::vector<T> const& v);
+write(std::ostream& s, std::vector<T,A> const& v);
 
 template<typename T, size_t N>
 void
@@ -167,9 +168,9 @@ template<typename T, size_t N>
 void
 write(std::ostream& s, std::array<T,N> const& a);
 
-template<typename T>
+template<typename T, typename A>
 auto
-read(std::istream& s, std::vector<T> & v)
+read(std::istream& s, std::vector<T,A> & v)
     -> stdx::if_compiles_return<void,decltype(itensor::read(s,v[0]))>
     {
     auto size = v.size();
@@ -186,9 +187,9 @@ read(std::istream& s, std::vector<T> & v)
     }
 
 
-template<typename T>
+template<typename T, typename A>
 auto
-write(std::ostream& s, std::vector<T> const& v)
+write(std::ostream& s, std::vector<T,A> const& v)
     -> stdx::if_compiles_return<void,decltype(itensor::write(s,v[0]))>
     {
     auto size = v.size();
@@ -297,10 +298,12 @@ template<class T>
 void
 readFromFile(const std::string& fname, T& t) 
     { 
+    PROFILE_SCOPE(disk_io)
     std::ifstream s(fname.c_str(),std::ios::binary);
     if(!s.good()) 
         throw ITError("Couldn't open file \"" + fname + "\" for reading");
     read(s,t); 
+    PROFILE_COUNT(disk_bytes,s.tellg());
     s.close(); 
     }
 
@@ -309,11 +312,13 @@ template<class T, typename... InitArgs>
 T
 readFromFile(const std::string& fname, InitArgs&&... iargs)
     { 
+    PROFILE_SCOPE(disk_io)
     std::ifstream s(fname.c_str(),std::ios::binary); 
     if(!s.good()) 
         throw ITError("Couldn't open file \"" + fname + "\" for reading");
     T t(std::forward<InitArgs>(iargs)...);
     read(s,t); 
+    PROFILE_COUNT(disk_bytes,s.tellg());
     s.close(); 
     return t;
     }
@@ -323,10 +328,12 @@ template<class T>
 void
 writeToFile(const std::string& fname, const T& t) 
     { 
+    PROFILE_SCOPE(disk_io)
     std::ofstream s(fname.c_str(),std::ios::binary); 
     if(!s.good()) 
         throw ITError("Couldn't open file \"" + fname + "\" for writing");
     write(s,t); 
+    PROFILE_COUNT(disk_bytes,s.tellp());
     s.close(); 
     }
 
@@ -0,0 +1,225 @@
+//
+// Distributed under the ITensor Library License, Version 1.2
+//    (See accompanying LICENSE file.)
+//
+#ifndef __ITENSOR_THREADING_H
+#define __ITENSOR_THREADING_H
+
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include "itensor/util/args.h"
+#include "itensor/util/memstats.h"
+
+namespace itensor {
+
+//
+// Number of threads used by default for
+// shared-memory parallel loops. Threading
+// is opt-in: algorithms which support it
+// run serially unless passed the named
+// argument "NThread" with a value of 2 or more
+// (for example std::thread::hardware_concurrency()).
+//
+int inline
+defaultNThread() { return 1; }
+
+int inline
+getNThread(Args const& args)
+    {
+    auto n = args.getInt("NThread",defaultNThread());
+    return (n > 0) ? int(n) : 1;
+    }
+
+//
+// parallelFor(N,nthread,f) calls f(n) for
+// each n = 0,1,...,N-1, distributing the calls
+// round-robin over at most nthread threads.
+// The calling thread does its share of the work.
+// If nthread <= 1 or N <= 1 the loop runs serially
+// in order, with no threads started.
+//
+// Storage created by f on any thread is counted
+// under the MemScope category of the calling thread.
+//
+// An exception thrown by f on any thread is
+// rethrown on the calling thread after all
+// threads have finished.
+//
+template<typename Func>
+void
+parallelFor(size_t N,
+            int nthread,
+            Func&& f)
+    {
+    auto nt = std::min<size_t>(std::max(nthread,1),N);
+    if(nt <= 1)
+        {
+        for(size_t n = 0; n < N; ++n) f(n);
+        return;
+        }
+
+    auto errors = std::vector<std::exception_ptr>(nt);
+    auto category = memCategory();
+    auto work = [&f,&errors,N,nt,category](size_t t)
+        {
+        MemScope scope(category);
+        try
+            {
+            for(auto n = t; n < N; n += nt) f(n);
+            }
+        catch(...)
+            {
+            errors[t] = std::current_exception();
+            }
+        };
+
+    auto threads = std::vector<std::thread>();
+    threads.reserve(nt-1);
+    for(size_t t = 1; t < nt; ++t) threads.emplace_back(work,t);
+    work(0);
+    for(auto& th : threads) th.join();
+
+    for(auto& e : errors) if(e) std::rethrow_exception(e);
+    }
+
+//
+// treeReduce(parts,nthread,accumulate) combines
+// the elements of parts pairwise, level by level,
+// calling accumulate(parts[i],parts[j]) to add
+// parts[j] into parts[i]. Pairs within a level
+// are independent and are processed concurrently.
+// On return parts.front() holds the total.
+//
+template<typename T, typename Accumulate>
+T&
+treeReduce(std::vector<T>& parts,
+           int nthread,
+           Accumulate&& accumulate)
+    {
+    auto N = parts.size();
+    for(size_t stride = 1; stride < N; stride *= 2)
+        {
+        auto npair = (N-stride+2*stride-1)/(2*stride);
+        parallelFor(npair,nthread,[&parts,&accumulate,stride](size_t p)
+            {
+            auto i = 2*stride*p;
+            accumulate(parts[i],parts[i+stride]);
+            });
+        }
+    return parts.front();
+    }
+
+//
+// A BackgroundWorker runs jobs (callables taking
+// no arguments) on a single background thread,
+// in the order they were pushed, so that work
+// such as measurements can overlap with the
+// calling thread. The thread is started by the
+// first call to push.
+//
+// wait() blocks until every job pushed so far
+// has finished, then rethrows the first exception
+// thrown by any of them. The destructor runs the
+// remaining jobs before joining the thread.
+//
+class BackgroundWorker
+    {
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::exception_ptr error_;
+    std::thread thread_;
+    bool busy_ = false;
+    bool stop_ = false;
+    public:
+
+    BackgroundWorker() { }
+
+    BackgroundWorker(BackgroundWorker const&) = delete;
+
+    BackgroundWorker&
+    operator=(BackgroundWorker const&) = delete;
+
+    ~BackgroundWorker()
+        {
+        if(!thread_.joinable()) return;
+            {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            }
+        cv_.notify_all();
+        thread_.join();
+        }
+
+    void
+    push(std::function<void()> job)
+        {
+            {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+            if(!thread_.joinable()) thread_ = std::thread([this]{ run(); });
+            }
+        cv_.notify_all();
+        }
+
+    void
+    wait()
+        {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock,[this]{ return jobs_.empty() && !busy_; });
+        if(error_)
+            {
+            auto e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+            }
+        }
+
+    //Number of jobs pushed but not yet finished
+    size_t
+    pending()
+        {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_.size()+(busy_ ? 1 : 0);
+        }
+
+    private:
+
+    void
+    run()
+        {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while(true)
+            {
+            cv_.wait(lock,[this]{ return stop_ || !jobs_.empty(); });
+            if(jobs_.empty()) return;
+            auto job = std::move(jobs_.front());
+            jobs_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            try
+                {
+                job();
+                }
+            catch(...)
+                {
+                std::lock_guard<std::mutex> elock(mutex_);
+                if(!error_) error_ = std::current_exception();
+                }
+            job = nullptr;
+            lock.lock();
+            busy_ = false;
+            cv_.notify_all();
+            }
+        }
+    };
+
+} //namespace itensor
+
+#endif
@@ -9,6 +9,14 @@
 #include <cmath>
 #include "itensor/util/stdx.h"
 #include "itensor/util/print.h"
+#include "itensor/util/profiling.h"
+
+//
+// Numbered timers, compiled in only when
+// COLLECT_TIMES is defined. For named timers
+// which can be switched on at runtime, see
+// PROFILE_SCOPE etc. in util/profiling.h
+//
 
 //#define COLLECT_TIMES
 
@@ -0,0 +1,63 @@
+#include "itensor/all.h"
+#include "itensor/mps/parallel_dmrg.h"
+
+using namespace itensor;
+
+//
+// Real-space parallel DMRG for the
+// spin 1 Heisenberg chain. Run with e.g.
+//
+//   mpirun -np 4 ./parallel_dmrg
+//
+int
+main(int argc, char* argv[])
+    {
+    Environment env(argc,argv);
+
+    int N = 100;
+
+    //
+    // Indices must be the same on every node,
+    // so create the site set, Hamiltonian and
+    // initial state on the first node only
+    // and broadcast them to the others
+    //
+    auto sites = SpinOne();
+    auto H = IQMPO();
+    auto psi = IQMPS();
+    if(env.firstNode())
+        {
+        sites = SpinOne(N);
+
+        auto ampo = AutoMPO(sites);
+        for(int j = 1; j < N; ++j)
+            {
+            ampo += 0.5,"S+",j,"S-",j+1;
+            ampo += 0.5,"S-",j,"S+",j+1;
+            ampo +=     "Sz",j,"Sz",j+1;
+            }
+        H = IQMPO(ampo);
+
+        auto state = InitState(sites);
+        for(int i = 1; i <= N; ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+        psi = IQMPS(state);
+        }
+    env.broadcast(sites,H,psi);
+
+    auto sweeps = Sweeps(6);
+    sweeps.maxm() = 10,20,50,100,200;
+    sweeps.cutoff() = 1E-10;
+    sweeps.niter() = 2;
+    sweeps.noise() = 1E-7,1E-8,0.0;
+    if(env.firstNode()) println(sweeps);
+
+    auto energy = parallelDMRG(env,psi,H,sweeps,{"Quiet",false});
+
+    if(env.firstNode())
+        {
+        printfln("\nGround State Energy = %.10f",energy);
+        printfln("Using overlap = %.10f", overlap(psi,H,psi) );
+        }
+
+    return 0;
+    }
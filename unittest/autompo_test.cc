@@ -411,6 +411,78 @@ SECTION("toExpH IQTensor")
         }
     }
 
+SECTION("toExpH ZW2")
+    {
+    int N = 5;
+    Real tau = 0.1;
+
+    auto dense = [N](MPO const& W)
+        {
+        auto T = W.A(1);
+        for(auto j : range1(2,N)) T *= W.A(j);
+        return T;
+        };
+    //Errors of ZW1, ZW2, and ZW2 with two complex time steps
+    auto errors = [&dense](AutoMPO const& ampo, Real tau)
+        {
+        auto U = expHermitian(dense(toMPO<ITensor>(ampo,{"Exact",true})),-tau);
+        auto e1 = norm(dense(toExpH<ITensor>(ampo,tau))-U);
+        auto e2 = norm(dense(toExpH<ITensor>(ampo,tau,{"Approx","ZW2"}))-U);
+        auto W = toExpHSteps<ITensor>(ampo,tau,{"Approx","ZW2","Order",2});
+        CHECK(W.size() == 2);
+        auto U2 = mapprime(dense(W.at(0))*prime(dense(W.at(1))),2,1);
+        auto e3 = norm(U2-U);
+        return std::vector<Real>{e1,e2,e3};
+        };
+
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo +=     "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    for(int j = 1; j+2 <= N; ++j) ampo += 0.4,"Sz",j,"Sz",j+2;
+    for(int j = 1; j <= N; ++j) ampo += 0.3,"Sz",j;
+
+    auto e = errors(ampo,tau);
+    CHECK(e[1] < 0.9*e[0]);
+    CHECK(e[2] < 0.5*e[1]);
+    //Second order: error per step falls as tau^3
+    auto eh = errors(ampo,tau/2);
+    CHECK(eh[2] < e[2]/6.);
+
+    auto iqW = toExpH<IQTensor>(ampo,tau,{"Approx","ZW2"});
+    CHECK(checkQNs(iqW));
+    CHECK(norm(dense(iqW.toMPO())-dense(toExpH<ITensor>(ampo,tau,{"Approx","ZW2"}))) < 1E-10);
+
+    //Fermions
+    auto fsites = Spinless(N);
+    auto fampo = AutoMPO(fsites);
+    for(int j = 1; j < N; ++j)
+        {
+        fampo += -1.0,"Cdag",j,"C",j+1;
+        fampo += -1.0,"Cdag",j+1,"C",j;
+        fampo += 0.5,"N",j,"N",j+1;
+        }
+    for(int j = 1; j+2 <= N; ++j) 
+        {
+        fampo += -0.3,"Cdag",j,"C",j+2;
+        fampo += -0.3,"Cdag",j+2,"C",j;
+        }
+    auto ef = errors(fampo,tau);
+    CHECK(ef[1] < 0.9*ef[0]);
+    CHECK(ef[2] < 0.5*ef[1]);
+
+    //Exact for on-site terms
+    auto oampo = AutoMPO(sites);
+    for(int j = 1; j <= N; ++j) oampo += 0.3,"Sz",j;
+    oampo += 0.7,"Sx",2;
+    auto U = expHermitian(dense(toMPO<ITensor>(oampo,{"Exact",true})),-tau);
+    CHECK(norm(dense(toExpH<ITensor>(oampo,tau,{"Approx","ZW2"}))-U) < 1E-12);
+    }
+
 SECTION("Hubbard, Complex Hopping")
     {
     auto N = 10;
@@ -613,4 +685,113 @@ SECTION("Spinless")
     }
 
 
+SECTION("Term Store")
+    {
+    auto N = 6;
+    auto sites = SpinHalf(N);
+
+    CHECK(OpName("Sz") == OpName(std::string("Sz")));
+    CHECK(OpName("Sz") != OpName("S+"));
+    CHECK(OpName("S+") < OpName("Sz"));
+    CHECK(OpName().empty());
+    CHECK(OpName("Sz").str() == "Sz");
+
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        }
+    CHECK(ampo.size() == N-1);
+
+    //Repeated terms are combined
+    ampo += 2.,"Sz",1,"Sz",2;
+    CHECK(ampo.size() == N-1);
+    CHECK_CLOSE(ampo.terms().front().coef.real(),3.);
+
+    //Terms are kept in the order first added
+    CHECK(ampo.terms().back().first().i == N-1);
+
+    //Bulk insertion matches adding one at a time
+    auto bulk = AutoMPO(sites);
+    auto terms = std::vector<HTerm>();
+    for(auto j : range1(N-1))
+        {
+        auto t = HTerm();
+        t.add("Sz",j);
+        t.add("Sz",j+1);
+        terms.push_back(t);
+        }
+    auto t = HTerm();
+    t.add("Sz",1);
+    t.add("Sz",2);
+    t *= 2.;
+    terms.push_back(t);
+    bulk.add(terms);
+    CHECK(bulk.size() == ampo.size());
+
+    auto H1 = toMPO<IQTensor>(ampo,{"Exact",false});
+    auto H2 = toMPO<IQTensor>(bulk,{"Exact",false});
+    auto state = InitState(sites);
+    for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+    auto psi = IQMPS(state);
+    CHECK_CLOSE(overlap(psi,H1,psi),overlap(psi,H2,psi));
+    CHECK_CLOSE(overlap(psi,H1,psi),-0.25*(N-1)-0.5);
+    }
+
+SECTION("Parallel Compression")
+    {
+    auto N = 8;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(auto i : range1(N))
+    for(auto j : range1(i+1,N))
+        {
+        auto J = std::exp(-0.5*(j-i));
+        ampo += J,"Sz",i,"Sz",j;
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        }
+    for(auto j : range1(N)) ampo += 0.1*j,"Sz",j;
+
+    auto H1 = toMPO<IQTensor>(ampo,{"Exact",false,"NThread",1});
+    auto H4 = toMPO<IQTensor>(ampo,{"Exact",false,"NThread",4});
+
+    for(auto b : range1(N-1))
+        {
+        CHECK(linkInd(H1,b).m() == linkInd(H4,b).m());
+        }
+
+    //Neel state and the state with spins 2 and 5 exchanged
+    auto st1 = InitState(sites);
+    for(auto j : range1(N)) st1.set(j,j%2==1 ? "Up" : "Dn");
+    auto st2 = st1;
+    st2.set(2,"Up");
+    st2.set(5,"Dn");
+    auto psi1 = IQMPS(st1);
+    auto psi2 = IQMPS(st2);
+
+    auto diagE = [N](std::vector<Real> const& sz)
+        {
+        Real E = 0;
+        for(auto i : range1(N))
+            {
+            E += 0.1*i*sz[i];
+            for(auto j : range1(i+1,N)) E += std::exp(-0.5*(j-i))*sz[i]*sz[j];
+            }
+        return E;
+        };
+    auto sz1 = std::vector<Real>(N+1),
+         sz2 = std::vector<Real>(N+1);
+    for(auto j : range1(N)) sz1[j] = sz2[j] = (j%2==1) ? 0.5 : -0.5;
+    sz2[2] = 0.5;
+    sz2[5] = -0.5;
+
+    for(auto* pH : {&H1,&H4})
+        {
+        CHECK_CLOSE(overlap(psi1,*pH,psi1),diagE(sz1));
+        CHECK_CLOSE(overlap(psi2,*pH,psi2),diagE(sz2));
+        CHECK_CLOSE(overlap(psi2,*pH,psi1),0.5*std::exp(-1.5));
+        }
+    }
+
 }
@@ -469,6 +469,28 @@ SECTION("IQTensor diagHermitian")
         CHECK(l.m()==1);
         }
 
+    SECTION("Degeneracy spread over several blocks")
+        {
+        //Regression test: once the degenerate states of the
+        //blocks went above Maxm, every later block was
+        //truncated by too much and got a negative size
+        auto i = IQIndex("i",Index("i0",2),QN(0),
+                             Index("i1",1),QN(1),
+                             Index("i2",1),QN(2),
+                             Index("i3",1),QN(3));
+        auto A = IQTensor(i,dag(prime(i)));
+        A.set(1,1,2.0);
+        A.set(3,3,1.0);
+        A.set(4,4,1.0);
+        A.set(5,5,1.0);
+        IQTensor U(i),D;
+        diagHermitian(A,U,D,{"Maxm=",2,"Cutoff=",0.0});
+        auto l = commonIndex(U,D);
+        CHECK(l.m()==2);
+        for(auto I : l) CHECK(I.m() > 0);
+        CHECK_CLOSE(norm(D),std::sqrt(5.));
+        }
+
     }
 
 SECTION("Exp Hermitian")
@@ -531,4 +553,65 @@ SECTION("Exp Hermitian")
         }
     }
 
+SECTION("QR")
+    {
+    SECTION("ITensor")
+        {
+        auto a = Index("a",4),
+             b = Index("b",3),
+             c = Index("c",5);
+        auto T = randomTensor(a,b,c);
+        ITensor Q(a,b),R;
+        qr(T,Q,R);
+        CHECK(norm(T-Q*R) < 1E-12);
+        auto checkIsometry = [](ITensor const& Q, Index const& q)
+            {
+            auto P = Q*dag(prime(Q,q));
+            for(auto i : range1(q.m()))
+            for(auto j : range1(q.m()))
+                {
+                CHECK_CLOSE(P.cplx(q(i),prime(q)(j)),(i == j) ? 1. : 0.);
+                }
+            };
+        auto q = commonIndex(Q,R);
+        CHECK(q.m() == 5);
+        checkIsometry(Q,q);
+
+        //Wide case, complex
+        auto Tc = randomTensorC(a,c);
+        ITensor Qc(a),Rc;
+        qr(Tc,Qc,Rc);
+        CHECK(norm(Tc-Qc*Rc) < 1E-12);
+        auto qc = commonIndex(Qc,Rc);
+        CHECK(qc.m() == 4);
+        checkIsometry(Qc,qc);
+        }
+
+    SECTION("IQTensor")
+        {
+        auto s = IQIndex("s",Index("s+",1,Site),QN(+1),Index("s-",1,Site),QN(-1));
+        auto l = IQIndex("l",Index("l0",2),QN(0),Index("l2",3),QN(2),Index("l-2",1),QN(-2));
+        auto r = IQIndex("r",Index("r1",3),QN(1),Index("r-1",2),QN(-1),Index("r3",1),QN(3));
+        auto T = randomTensor(QN(),l,s,dag(r));
+        IQTensor Q(l,s),R;
+        qr(T,Q,R);
+        CHECK(norm(T-Q*R) < 1E-12);
+        auto q = commonIndex(Q,R);
+        auto P = Q*dag(prime(Q,q));
+        for(auto i : range1(q.m()))
+        for(auto j : range1(q.m()))
+            {
+            CHECK_CLOSE(P.real(q(i),prime(q)(j)),(i == j) ? 1. : 0.);
+            }
+        CHECK(div(Q) == QN());
+
+        //Non-zero divergence goes on R
+        auto T2 = randomTensor(QN(2),l,s,dag(r));
+        IQTensor Q2(l,s),R2;
+        qr(T2,Q2,R2);
+        CHECK(norm(T2-Q2*R2) < 1E-12);
+        CHECK(div(R2) == QN(2));
+        }
+    }
+
 }
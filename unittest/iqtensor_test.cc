@@ -1,5 +1,6 @@
 #include "test.h"
 #include "itensor/iqtensor.h"
+#include "itensor/contractnetwork.h"
 #include "itensor/util/set_scoped.h"
 #include "itensor/util/range.h"
 #include "itensor/util/print_macro.h"
@@ -257,6 +258,44 @@ SECTION("Addition and Subtraction")
 
     }
 
+SECTION("Linear Combination")
+    {
+    auto T1 = randomTensor(QN(0),L1,S1,L2,S2),
+         T2 = randomTensor(QN(0),L1,S1,L2,S2),
+         T3 = randomTensor(QN(0),S1,S2,L1,L2);
+    auto R = IQTensor();
+    linearCombination({2.,-1.},{T1,T2},R);
+    CHECK(norm(R-(2*T1-T2)) < 1E-12);
+    CHECK(div(R) == QN(0));
+
+    linearCombination({2.,-1.,0.5},{T1,T2,T3},R);
+    CHECK(norm(R-(2*T1-T2+0.5*T3)) < 1E-12);
+
+    auto coefs = std::vector<Cplx>{Cplx(0,1),Cplx(1,1)};
+    linearCombination(coefs,{T1,T2},R);
+    CHECK(norm(R-(coefs[0]*T1+coefs[1]*T2)) < 1E-12);
+    }
+
+SECTION("Contract Network")
+    {
+    auto T1 = randomTensor(QN(0),L1,S1,L2),
+         T2 = randomTensor(QN(0),dag(L2),S2,prime(L1)),
+         T3 = randomTensor(QN(0),dag(L1),dag(S1),dag(prime(L1)));
+    auto R = contractNetwork(T1,T2,T3);
+    CHECK(norm(R-T1*T2*T3) < 1E-10);
+
+    //Block sparsity makes the estimated
+    //cost lower than for dense tensors
+    auto t1 = toITensor(T1),
+         t2 = toITensor(T2),
+         t3 = toITensor(T3);
+    auto qplan = contractionPlan(std::vector<IQTensor const*>{&T1,&T2,&T3});
+    auto dplan = contractionPlan(std::vector<ITensor const*>{&t1,&t2,&t3});
+    CHECK(qplan.cost > 0);
+    CHECK(qplan.cost < dplan.cost);
+    CHECK(norm(toITensor(R)-contractNetwork(t1,t2,t3)) < 1E-10);
+    }
+
 SECTION("Apply")
     {
     IQTensor B1(B);
@@ -732,6 +771,37 @@ SECTION("Combiner")
         Tc *= dag(prime(Tc,ci));
         }
 
+    SECTION("Combiner Without Copy")
+        {
+        auto l1 = IQIndex("l1",Index("l1",2),QN(0)),
+             l2 = IQIndex("l2",Index("l2",3),QN(+1));
+        auto s = IQIndex("s",Index("Up",1),QN(+1),
+                             Index("Dn",1),QN(-1));
+        auto T = randomTensor(QN(),l1,l2,s);
+
+        //Each block of l1 and l2 maps to one block
+        //of the combined index: storage is shared
+        auto C = combiner(l1,l2);
+        auto R = C*T;
+        CHECK(R.store().get() == T.store().get());
+        auto ci = commonIndex(C,R);
+        for(auto j1 : range1(l1))
+        for(auto j2 : range1(l2))
+            {
+            auto j = j1+(j2-1)*l1.m();
+            CHECK_CLOSE(T.real(l1(j1),l2(j2),s(2)),R.real(ci(j),s(2)));
+            }
+        auto uT = dag(C)*R;
+        CHECK(uT.store().get() == T.store().get());
+        CHECK(norm(uT-T) < 1E-12);
+
+        //Combined indices not leading: data is permuted
+        auto Cs = combiner(l2,s);
+        auto Rs = T*Cs;
+        CHECK(Rs.store().get() != T.store().get());
+        CHECK(norm(Rs*dag(Cs)-T) < 1E-12);
+        }
+
 
     } //Combiner
 
@@ -1335,6 +1405,58 @@ SECTION("Reindex")
     CHECK_THROWS(nT = reindex(T,S1,S3,S2,J4));
     }
 
+SECTION("Sparse Links")
+    {
+    auto l1 = IQIndex("l1",Index("l1+",2),QN(+2),Index("l10",3),QN(0),Index("l1-",2),QN(-2));
+    auto l2 = IQIndex("l2",Index("l2+",1),QN(+2),Index("l20",2),QN(0),Index("l2-",1),QN(-2));
+
+    //MPO-like tensor with few non-zero entries
+    //in each allowed block
+    auto W = IQTensor(dag(l1),S1,dag(prime(S1)),l2);
+    W.set(l1(3),S1(1),prime(S1)(1),l2(2),1.);
+    W.set(l1(4),S1(2),prime(S1)(2),l2(3),1.);
+    W.set(l1(1),S1(2),prime(S1)(1),l2(2),0.5);
+    W.set(l1(5),S1(2),prime(S1)(1),l2(4),-0.7);
+    W.set(l1(6),S1(1),prime(S1)(2),l2(3),0.3);
+    auto sW = sparseLinks(W,l1,l2);
+    CHECK(doTask(StorageType{},sW.store()) == StorageType::QMPOSparseReal);
+    CHECK(norm(sW) == Approx(norm(W)));
+    CHECK(div(sW) == div(W));
+
+    //Link l1 contracted, l2 kept
+    auto L = randomTensor(QN(),L1,l1,dag(prime(L1))),
+         P = randomTensor(QN(),dag(L1),dag(S1),prime(L1,2));
+    auto LP = L*P;
+    CHECK(norm(LP*sW - LP*W) < 1E-12*norm(LP*W));
+    CHECK(norm(sW*LP - W*LP) < 1E-12*norm(W*LP));
+
+    //Both links contracted
+    auto Q = randomTensor(QN(),l1,L1,dag(l2));
+    CHECK(norm(Q*sW - Q*W) < 1E-12*norm(Q*W));
+
+    //Complex
+    auto CQ = randomTensorC(QN(),dag(l2),L1);
+    CHECK(norm(sW*CQ - W*CQ) < 1E-12*norm(W*CQ));
+    auto sWc = sparseLinks(W*Cplx_i,l1,l2);
+    CHECK(norm(sWc*L - (W*Cplx_i)*L) < 1E-12*norm(W*L));
+    CHECK(norm(dag(sWc) - dag(W*Cplx_i)) < 1E-12*norm(W));
+
+    //Contracting with other storage uses a QDense copy
+    auto cmb = combiner(S1,l2);
+    CHECK(norm(sW*cmb - W*cmb) < 1E-12*norm(W));
+    CHECK(doTask(StorageType{},sW.store()) == StorageType::QMPOSparseReal);
+
+    //Other operations convert to QDense
+    CHECK(norm(sparseLinks(W,l1,l2) - W) < 1E-12*norm(W));
+
+    auto fname = "_iq_sparse_links_test";
+    writeToFile(fname,sparseLinks(W,l2));
+    auto nW = readFromFile<IQTensor>(fname);
+    CHECK(doTask(StorageType{},nW.store()) == StorageType::QMPOSparseReal);
+    CHECK(norm(nW*Q - W*Q) < 1E-12*norm(W*Q));
+    std::remove(fname);
+    }
+
 //SECTION("Non-contracting product")
 //    {
 //    SECTION("Case 1")
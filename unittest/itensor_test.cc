@@ -1,11 +1,16 @@
 #include "test.h"
 #include "itensor/itensor.h"
+#include "itensor/contractnetwork.h"
 #include "itensor/util/cplx_literal.h"
 #include "itensor/util/range.h"
 #include "itensor/util/set_scoped.h"
+#include "itensor/util/threading.h"
 #include "itensor/iqindex.h"
+#include "itensor/mapstorage.h"
 #include "itensor/util/print_macro.h"
 #include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace itensor;
@@ -816,6 +821,90 @@ SECTION("Reordered Case 2")
         }
     }
 
+SECTION("Linear Combination")
+    {
+    auto T1 = randomTensor(b6,s1,b5,s2),
+         T2 = randomTensor(b6,s1,b5,s2),
+         T3 = randomTensor(b6,s1,b5,s2);
+    auto R = ITensor();
+
+    SECTION("Real coefficients")
+        {
+        linearCombination({0.5,-2.,3.},{T1,T2,T3},R);
+        CHECK(norm(R-(0.5*T1-2*T2+3*T3)) < 1E-12);
+        CHECK(isReal(R));
+        }
+
+    SECTION("Complex coefficients")
+        {
+        auto coefs = std::vector<Cplx>{Cplx(1,2),Cplx(0.5,0),Cplx(0,-1)};
+        linearCombination(coefs,{T1,T2,T3},R);
+        CHECK(isComplex(R));
+        CHECK(norm(R-(coefs[0]*T1+coefs[1]*T2+coefs[2]*T3)) < 1E-12);
+        }
+
+    SECTION("Only leading tensors used")
+        {
+        auto tensors = std::vector<ITensor>{T1,T2,T3};
+        linearCombination(std::vector<Real>{2.,1.},tensors,R);
+        CHECK(norm(R-(2*T1+T2)) < 1E-12);
+        }
+
+    SECTION("Output aliases input")
+        {
+        R = T1;
+        linearCombination({1.,2.},{R,T2},R);
+        CHECK(norm(R-(T1+2*T2)) < 1E-12);
+        }
+
+    SECTION("Reordered indices")
+        {
+        auto T4 = randomTensor(s1,s2,b6,b5);
+        linearCombination({1.,-1.},{T1,T4},R);
+        CHECK(norm(R-(T1-T4)) < 1E-12);
+        }
+    }
+
+SECTION("Contract Network")
+    {
+    auto a = Index("a",20),
+         b = Index("b",20),
+         c = Index("c",20);
+    auto A = randomTensor(a,b),
+         B = randomTensor(b,c),
+         C = randomTensor(c);
+
+    auto R = contractNetwork(A,B,C);
+    CHECK(norm(R-A*B*C) < 1E-10);
+
+    //Contracting B with C first avoids
+    //forming the 20x20 matrix A*B
+    auto plan = contractionPlan(std::vector<ITensor const*>{&A,&B,&C});
+    REQUIRE(plan.steps.size() == 2u);
+    CHECK(plan.steps.front() == std::make_pair(1,2));
+    CHECK(plan.cost == 20*20+20*20);
+
+    //Null tensors are skipped
+    auto N = ITensor();
+    R = contractNetwork(std::vector<ITensor const*>{&N,&A,&B,nullptr,&C});
+    CHECK(norm(R-A*B*C) < 1E-10);
+
+    //Disconnected tensors end in an outer product
+    auto D = randomTensor(l1);
+    R = contractNetwork(D,A,B);
+    CHECK(norm(R-D*A*B) < 1E-10);
+
+    //Index b shared by three tensors: the
+    //order written must be kept
+    auto E = randomTensor(b,a),
+         F = randomTensor(b);
+    plan = contractionPlan(std::vector<ITensor const*>{&A,&E,&F});
+    REQUIRE(plan.steps.size() == 2u);
+    CHECK(plan.steps.front() == std::make_pair(0,1));
+    R = contractNetwork(A,E,F);
+    CHECK(norm(R-A*E*F) < 1E-10);
+    }
+
 SECTION("Add diag")
     {
     auto data1 = randomData(std::min(l6.m(),b4.m())),
@@ -1636,6 +1725,8 @@ SECTION("Combiner")
 
         auto T1 = randomTensor(s1,s2,s3);
         auto R1 = C*T1;
+        //Contiguous combined indices: no copy
+        CHECK(R1.store().get() == T1.store().get());
         auto ci = commonIndex(C,R1);
         CHECK(ci);
         CHECK(ci.m() == s1.m()*s2.m());
@@ -2739,6 +2830,320 @@ SECTION("uniqueIndex")
     }
 
 
+SECTION("Lazy Products")
+    {
+    auto a = Index("a",2),
+         b = Index("b",20),
+         c = Index("c",20),
+         d = Index("d",3),
+         e = Index("e",4);
+    auto A = randomTensor(a,b),
+         B = randomTensorC(b,c,e),
+         C = randomTensor(c,d),
+         D = randomTensor(d,a);
+    auto isLazy = [](ITensor & T) { return bool(dynamic_cast<ITWrap<ITLazy>*>(T.store().get())); };
+
+    auto R = lazy(A)*B*C*D;
+    CHECK(isLazy(R));
+    auto E = A*B*C*D;
+    CHECK(R.r() == E.r());
+    for(auto n : range(E.r())) CHECK(R.inds()[n] == E.inds()[n]);
+    CHECK(isLazy(R));
+    CHECK_CLOSE(R.cplx(e(3)),E.cplx(e(3)));
+    CHECK(!isLazy(R));
+    CHECK(norm(R-E) < 1E-12*norm(E));
+
+    //Copies of an unevaluated product
+    auto R1 = A*lazy(B)*C;
+    auto R2 = R1;
+    CHECK(norm(R1-A*B*C) < 1E-12*norm(R1));
+    CHECK(isLazy(R2));
+    CHECK(norm(R2-A*B*C) < 1E-12*norm(R1));
+
+    //Lazy times lazy
+    auto R3 = lazy(A)*B*(lazy(C)*D);
+    CHECK(norm(R3-E) < 1E-12*norm(E));
+
+    //Relabeled indices evaluate the factors first
+    auto P = prime(lazy(A)*B,c);
+    auto F = randomTensor(prime(c),d);
+    CHECK(norm(P*F-prime(A*B,c)*F) < 1E-12*norm(P*F));
+
+    //An index shared by three factors
+    auto v1 = randomTensor(b),
+         v2 = randomTensor(b);
+    auto S = lazy(A)*v1*v2;
+    CHECK(norm(S-A*v1*v2) < 1E-12*norm(S));
+
+    //Non-dense factors
+    auto cmb = combiner(a,e);
+    auto K = lazy(A)*B*cmb;
+    CHECK(norm(K-A*B*cmb) < 1E-12*norm(K));
+    CHECK(!isLazy(K));
+    auto dl = delta(d,prime(d));
+    auto Ldl = lazy(dl);
+    CHECK(!isLazy(Ldl));
+    }
+
+SECTION("Single Precision")
+    {
+    auto a = Index("a",3),
+         b = Index("b",4),
+         c = Index("c",5);
+    auto A = randomTensor(a,b,c),
+         B = randomTensorC(a,b);
+
+    auto sA = toSingle(A);
+    CHECK(isSingle(sA));
+    CHECK(!isSingle(A));
+    CHECK(isReal(sA));
+    CHECK(std::fabs(norm(sA)-norm(A)) < 1E-6*norm(A));
+    CHECK(norm(toDouble(sA)-A) < 1E-6*norm(A));
+    CHECK(!isSingle(toDouble(sA)));
+
+    //Other operations convert to double first
+    auto sB = toSingle(B);
+    CHECK(isComplex(sB));
+    auto R = sA*sB;
+    CHECK(!isSingle(R));
+    CHECK(norm(R-A*B) < 1E-6*norm(R));
+
+    //Other storage is left unchanged
+    auto dl = delta(a,prime(a));
+    CHECK(!isSingle(toSingle(dl)));
+
+    auto fname = "_single_test";
+    auto sC = toSingle(B);
+    writeToFile(fname,sC);
+    auto nC = readFromFile<ITensor>(fname);
+    CHECK(isSingle(nC));
+    CHECK(norm(nC-B) < 1E-6*norm(B));
+    std::system(format("rm -f %s",fname).c_str());
+    }
+
+SECTION("Sparse Links")
+    {
+    auto s = Index("s",2,Site),
+         l1 = Index("l1",4),
+         l2 = Index("l2",3),
+         a = Index("a",5),
+         b = Index("b",6);
+
+    //MPO-like tensor with few non-zero (l1,l2) entries
+    auto W = ITensor(s,prime(s),l1,l2);
+    auto Op = randomTensor(s,prime(s));
+    W += Op*setElt(l1(1),l2(1));
+    W += Op*setElt(l1(4),l2(3));
+    W += randomTensor(s,prime(s))*setElt(l1(2),l2(3));
+    auto sW = sparseLinks(W,l1,l2);
+    CHECK(norm(sW) == Approx(norm(W)));
+
+    //Link l1 contracted, l2 kept
+    auto L = randomTensor(a,l1,prime(a)),
+         P = randomTensor(a,s,b);
+    CHECK(norm((L*P)*sW - (L*P)*W) < 1E-12*norm((L*P)*W));
+    CHECK(norm(sW*(L*P) - W*(L*P)) < 1E-12*norm(W*(L*P)));
+
+    //Both links contracted
+    auto Q = randomTensor(l1,a,l2);
+    CHECK(norm(Q*sW - Q*W) < 1E-12*norm(Q*W));
+
+    //Complex
+    auto C = randomTensorC(b,l2,a);
+    CHECK(norm(sW*C - W*C) < 1E-12*norm(W*C));
+    auto sWc = sparseLinks(W*Cplx_i,l1,l2);
+    CHECK(norm(sWc*L - (W*Cplx_i)*L) < 1E-12*norm(W*L));
+    CHECK(norm(dag(sWc) - dag(W*Cplx_i)) < 1E-12*norm(W));
+
+    //Other operations convert to dense
+    CHECK(norm(sparseLinks(W,l1,l2) - W) < 1E-12*norm(W));
+
+    auto fname = "_sparse_links_test";
+    writeToFile(fname,sparseLinks(W,l2));
+    auto nW = readFromFile<ITensor>(fname);
+    CHECK(norm(nW*Q - W*Q) < 1E-12*norm(W*Q));
+    std::system(format("rm -f %s",fname).c_str());
+    }
+
+SECTION("Memory Tracking")
+    {
+    auto a = Index("a",3),
+         b = Index("b",4),
+         c = Index("c",5);
+    auto U = randomTensor(a,b); //created before tracking: not counted
+
+    auto was_on = memTracking(true);
+    auto start = memStats();
+        {
+        MemScope scope(MemCategory::Environment);
+        CHECK(memCategory() == MemCategory::Environment);
+        auto T = randomTensor(a,b,c);
+        auto M = memStats();
+        auto bytes = M.category(MemCategory::Environment).live
+                   - start.category(MemCategory::Environment).live;
+        CHECK(bytes >= long(sizeof(Real)*a.m()*b.m()*c.m()));
+        CHECK(M.type("DenseReal"));
+        CHECK(M.total.peak >= M.total.live);
+
+        MemScope scope2(MemCategory::Temporary);
+        auto R = T*U;
+        M = memStats();
+        bytes = M.category(MemCategory::Temporary).live
+              - start.category(MemCategory::Temporary).live;
+        CHECK(bytes >= long(sizeof(Real)*c.m()));
+        }
+    CHECK(memCategory() == MemCategory::Other);
+
+        {
+        //Worker threads count storage under
+        //the category of the calling thread
+        MemScope scope(MemCategory::Environment);
+        auto T = randomTensor(a,b,c);
+        auto before = memStats().category(MemCategory::Environment).live;
+        auto parts = std::vector<ITensor>(4);
+        parallelFor(parts.size(),4,[&parts,&T,&U](size_t n)
+            {
+            parts[n] = T*U;
+            });
+        auto bytes = memStats().category(MemCategory::Environment).live - before;
+        CHECK(bytes >= long(parts.size()*sizeof(Real)*c.m()));
+        }
+
+        {
+        MemTrackingScope off(false);
+        CHECK(!memTracking());
+        }
+    CHECK(memTracking());
+
+    U = ITensor();
+    auto M = memStats();
+    CHECK(M.total.live == start.total.live);
+    CHECK(M.total.peak > start.total.live);
+    resetMemPeak();
+    CHECK(memStats().total.peak == start.total.live);
+    memTracking(was_on);
+    }
+
+SECTION("Mapped Storage")
+    {
+    auto a = Index("a",10),
+         b = Index("b",20),
+         c = Index("c",30);
+    auto A = randomTensor(a,b),
+         B = randomTensor(b,c),
+         C = randomTensor(a,c);
+    auto R = A*B;
+    R += C;
+
+    auto dir = mkTempDir("mapped");
+    auto files = [&dir]()
+        {
+        auto n = 0;
+        auto d = opendir(dir.c_str());
+        while(auto e = readdir(d)) if(e->d_name[0] != '.') ++n;
+        closedir(d);
+        return n;
+        };
+
+    CHECK(!storageMapped());
+    mapStorage(dir,1);
+    CHECK(storageMapped());
+        {
+        auto mA = A, mB = B, mC = C;
+        mA.set(a(1),b(1),A.real(a(1),b(1))); //copy data into mapped storage
+        mB.set(b(1),c(1),B.real(b(1),c(1)));
+        mC.set(a(1),c(1),C.real(a(1),c(1)));
+        CHECK(numStorageMaps() == 3);
+        CHECK(files() == 3);
+        CHECK(mappedBytes() >= long(sizeof(Real)*(a.m()*b.m()+b.m()*c.m()+a.m()*c.m())));
+        auto mR = mA*mB;
+        mR += mC;
+        CHECK(numStorageMaps() == 4);
+        CHECK(norm(mR-R) < 1E-12*norm(R));
+
+        //Saved data is read back into new mapped storage
+        writeMapped(dir+"/R",mR);
+        CHECK(files() == 4+2);
+        auto rR = ITensor();
+        readMapped(dir+"/R",rR);
+        CHECK(numStorageMaps() == 5);
+        CHECK(norm(rR-R) < 1E-12*norm(R));
+        rR.set(a(1),c(1),100.);
+        CHECK(norm(rR-mR) > 1.);
+
+        //Matrix data is moved into the ITensor, not copied
+        auto M = Matrix(a.m(),c.m());
+        auto pM = M.data();
+        auto tM = matrixTensor(std::move(M),a,c);
+        auto G = GetData<Real>{};
+        doTask(G,tM.store());
+        CHECK(G.data == pM);
+        CHECK(numStorageMaps() == 6);
+        }
+    CHECK(numStorageMaps() == 0);
+    CHECK(mappedBytes() == 0);
+    //Only the saved files are left
+    CHECK(files() == 2);
+    unmapStorage();
+    CHECK(!storageMapped());
+    auto T = randomTensor(a,b,c);
+    CHECK(numStorageMaps() == 0);
+
+    //Without mapping, data is read into heap storage
+        {
+        auto M = Matrix(a.m(),c.m());
+        auto pM = M.data();
+        auto tM = matrixTensor(std::move(M),a,c);
+        auto G = GetData<Real>{};
+        doTask(G,tM.store());
+        CHECK(G.data == pM);
+
+        auto R2 = ITensor();
+        readMapped(dir+"/R",R2);
+        CHECK(norm(R2-R) < 1E-12*norm(R));
+        writeMapped(dir+"/T",T);
+        auto T2 = ITensor();
+        readMapped(dir+"/T",T2);
+        CHECK(numStorageMaps() == 0);
+        CHECK(norm(T2-T) < 1E-12*norm(T));
+        T2 *= 2.;
+        T2 += T;
+        CHECK(norm(T2-3*T) < 1E-12*norm(T));
+
+        auto I = IQIndex("I",Index("I+",2),QN(+1),Index("I0",3),QN(0),Index("I-",2),QN(-1));
+        auto J = IQIndex("J",Index("J+",3),QN(+1),Index("J-",4),QN(-1));
+        auto Q = randomTensor(QN(0),I,dag(J),prime(I));
+        writeMapped(dir+"/Q",Q);
+        auto Q2 = IQTensor();
+        readMapped(dir+"/Q",Q2);
+        CHECK(norm(Q2-Q) < 1E-12*norm(Q));
+
+        //A data file of the wrong size is refused
+        writeMapped(dir+"/X",T);
+        std::rename((dir+"/R.dat").c_str(),(dir+"/X.dat").c_str());
+        CHECK_THROWS_AS(readMapped(dir+"/X",T2),ITError);
+        std::remove((dir+"/X").c_str());
+        std::remove((dir+"/X.dat").c_str());
+
+    //Other storage is written in full
+        auto D = delta(a,b);
+        writeMapped(dir+"/D",D);
+        auto D2 = ITensor();
+        readMapped(dir+"/D",D2);
+        auto X = randomTensor(a,b);
+        CHECK_CLOSE((D2*X).real(),(D*X).real());
+        }
+    CHECK(numStorageMaps() == 0);
+    for(auto f : {"R","T","Q"})
+        {
+        std::remove((dir+"/"+f).c_str());
+        std::remove((dir+"/"+f+".dat").c_str());
+        }
+    std::remove((dir+"/D").c_str());
+    CHECK(files() == 0);
+    rmdir(dir.c_str());
+    }
+
 } //TEST_CASE("ITensor")
 
 
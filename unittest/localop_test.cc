@@ -1,6 +1,9 @@
 #include "test.h"
 #include "itensor/mps/localop.h"
 #include "itensor/mps/localmpo.h"
+#include "itensor/mps/localmposet.h"
+#include "itensor/mps/localmpo_mps.h"
+#include "itensor/mps/autompo.h"
 #include "itensor/mps/sites/spinhalf.h"
 #include "itensor/util/print_macro.h"
 
@@ -109,6 +112,136 @@ SECTION("LocalMPO As MPS")
     auto lmps = LocalMPO<IQTensor>(psiN);
     lmps.position(3,psiF);
     }
+
+SECTION("Cached Diag")
+    {
+    auto N = 8;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = MPO(ampo);
+
+    auto state = InitState(sites);
+    for(int j = 1; j <= N; ++j)
+        {
+        state.set(j,j%2==1 ? "Up" : "Dn");
+        }
+    auto psi = MPS(state);
+    //Grow the bond dimension
+    for(auto j : range1(N-1))
+        {
+        auto AA = randomTensor((psi.A(j)*psi.A(j+1)).inds());
+        psi.svdBond(j,AA,Fromleft);
+        }
+
+    auto lmpo = LocalMPO<ITensor>(H);
+    //Visit each bond twice so that cached
+    //pieces are reused as well as rebuilt
+    for(auto b : {1,3,5,7,5,3,4,4})
+        {
+        lmpo.position(b,psi);
+        auto lop = LocalOp<ITensor>(H.A(b),H.A(b+1),lmpo.L(),lmpo.R());
+        CHECK(norm(lmpo.diag()-lop.diag()) < 1E-12);
+        }
+    }
 }
 
 
+
+TEST_CASE("LocalMPOSet")
+{
+auto N = 8;
+auto sites = SpinHalf(N);
+
+auto szsz = AutoMPO(sites);
+auto pmmp = AutoMPO(sites);
+auto hz = AutoMPO(sites);
+for(int j = 1; j < N; ++j)
+    {
+    szsz += "Sz",j,"Sz",j+1;
+    pmmp += 0.5,"S+",j,"S-",j+1;
+    pmmp += 0.5,"S-",j,"S+",j+1;
+    }
+for(int j = 1; j <= N; ++j)
+    {
+    hz += 0.3,"Sz",j;
+    }
+auto Hset = std::vector<IQMPO>{IQMPO(szsz),IQMPO(pmmp),IQMPO(hz)};
+
+auto state = InitState(sites);
+for(int j = 1; j <= N; ++j)
+    {
+    state.set(j,j%2==1 ? "Up" : "Dn");
+    }
+auto psi = IQMPS(state);
+
+auto b = 3;
+auto phi = randomTensor(QN(),(psi.A(b)*psi.A(b+1)).inds());
+
+SECTION("Threaded product matches serial sum")
+    {
+    auto serial = LocalMPOSet<IQTensor>(Hset,{"NThread",1});
+    auto threaded = LocalMPOSet<IQTensor>(Hset,{"NThread",3});
+    serial.position(b,psi);
+    threaded.position(b,psi);
+
+    auto ref = IQTensor();
+    for(auto& H : Hset)
+        {
+        auto lmpo = LocalMPO<IQTensor>(H);
+        lmpo.position(b,psi);
+        auto term = IQTensor();
+        lmpo.product(phi,term);
+        if(ref) ref += term;
+        else    ref = term;
+        }
+
+    auto p1 = IQTensor();
+    serial.product(phi,p1);
+    auto p3 = IQTensor();
+    threaded.product(phi,p3);
+    CHECK(norm(p1-ref) < 1E-12);
+    CHECK(norm(p3-ref) < 1E-12);
+
+    CHECK_CLOSE(threaded.expect(phi),serial.expect(phi));
+    }
+
+SECTION("Threaded shift")
+    {
+    auto serial = LocalMPOSet<IQTensor>(Hset,{"NThread",1});
+    auto threaded = LocalMPOSet<IQTensor>(Hset,{"NThread",2});
+    serial.position(b,psi);
+    threaded.position(b,psi);
+    serial.shift(b,Fromleft,psi.A(b));
+    threaded.shift(b,Fromleft,psi.A(b));
+    auto L1 = serial.L();
+    auto L2 = threaded.L();
+    for(auto n : range(Hset))
+        {
+        CHECK(norm(L1.at(n)-L2.at(n)) < 1E-12);
+        }
+    }
+
+SECTION("LocalMPO_MPS")
+    {
+    auto H = IQMPO(szsz);
+    auto ferro = InitState(sites,"Up");
+    auto psis = std::vector<IQMPS>{psi,IQMPS(ferro)};
+
+    auto serial = LocalMPO_MPS<IQTensor>(H,psis,{"NThread",1,"Weight",2.});
+    auto threaded = LocalMPO_MPS<IQTensor>(H,psis,{"NThread",2,"Weight",2.});
+    serial.position(b,psi);
+    threaded.position(b,psi);
+
+    auto p1 = IQTensor();
+    serial.product(phi,p1);
+    auto p2 = IQTensor();
+    threaded.product(phi,p2);
+    CHECK(norm(p1-p2) < 1E-12);
+    }
+}
@@ -1015,6 +1015,84 @@ SECTION("Test Matrix multiplication")
     }
 
 
+SECTION("Complex Matrix multiplication")
+    {
+    //Reference C = alpha*A*B + beta*C0
+    auto check = [](CMatrixRefc A, CMatrixRefc B, CMatrixRefc C0, CMatrixRefc C,
+                    Real alpha, Real beta)
+        {
+        Real maxdiff = 0;
+        for(auto r : range(nrows(C)))
+        for(auto c : range(ncols(C)))
+            {
+            Cplx val = 0;
+            for(auto k : range(ncols(A))) val += A(r,k)*B(k,c);
+            maxdiff = std::max(maxdiff,std::abs(C(r,c)-(alpha*val+beta*C0(r,c))));
+            }
+        CHECK(maxdiff < 1E-12*ncols(A));
+        };
+    auto toCplx = [](MatrixRefc M)
+        {
+        auto res = CMatrix(nrows(M),ncols(M));
+        for(auto r : range(nrows(M)))
+        for(auto c : range(ncols(M))) res(r,c) = M(r,c);
+        return res;
+        };
+
+    //Small sizes use four real products, large
+    //ones (with all dimensions >= 32) the 3M method
+    for(auto dims : {std::vector<long>{3,4,5},std::vector<long>{40,36,33}})
+    for(auto ta : {false,true})
+    for(auto tb : {false,true})
+        {
+        auto m = dims[0],
+             k = dims[1],
+             n = dims[2];
+        auto A = ta ? randomMatC(k,m) : randomMatC(m,k);
+        auto B = tb ? randomMatC(n,k) : randomMatC(k,n);
+        auto rA = ta ? randomMat(k,m) : randomMat(m,k);
+        auto rB = tb ? randomMat(n,k) : randomMat(k,n);
+        auto Ar = ta ? transpose(makeRef(A)) : makeRef(A);
+        auto Br = tb ? transpose(makeRef(B)) : makeRef(B);
+        auto rAr = ta ? transpose(makeRef(rA)) : makeRef(rA);
+        auto rBr = tb ? transpose(makeRef(rB)) : makeRef(rB);
+        auto C0 = randomMatC(m,n);
+        for(auto beta : {0.,0.5})
+            {
+            auto C = C0;
+            gemm(Ar,Br,makeRef(C),2.,beta);
+            check(Ar,Br,C0,C,2.,beta);
+
+            auto cA = toCplx(rAr);
+            C = C0;
+            gemm(rAr,Br,makeRef(C),2.,beta);
+            check(cA,Br,C0,C,2.,beta);
+
+            auto cB = toCplx(rBr);
+            C = C0;
+            gemm(Ar,rBr,makeRef(C),2.,beta);
+            check(Ar,cB,C0,C,2.,beta);
+
+            //Transposed result
+            auto Ct = CMatrix(n,m);
+            auto Ctr = transpose(makeRef(Ct));
+            for(auto r : range(m))
+            for(auto c : range(n)) Ctr(r,c) = C0(r,c);
+            gemm(Ar,Br,Ctr,2.,beta);
+            check(Ar,Br,C0,Ctr,2.,beta);
+            }
+        }
+
+    //Large enough that the scratch space is
+    //allocated for this call only
+    auto A = randomMatC(340,350);
+    auto B = randomMatC(350,330);
+    auto C0 = randomMatC(340,330);
+    auto C = C0;
+    gemm(makeRef(A),makeRef(B),makeRef(C),2.,0.5);
+    check(makeRef(A),makeRef(B),C0,C,2.,0.5);
+    }
+
 SECTION("Addition / Subtraction")
     {
     auto Nr = 4,
@@ -1569,6 +1647,35 @@ SECTION("Singular Value Decomp")
         }
     }
 
+SECTION("QR")
+    {
+    for(auto dims : {std::make_pair(8,5),std::make_pair(5,8)})
+        {
+        auto M = CMatrix(dims.first,dims.second);
+        for(auto r : range(nrows(M)))
+        for(auto c : range(ncols(M)))
+            {
+            M(r,c) = Global::random() + 1_i*Global::random();
+            }
+
+        CMatrix Q,R;
+        QR(M,Q,R);
+
+        auto k = std::min(nrows(M),ncols(M));
+        CHECK(ncols(Q) == k);
+        CHECK(nrows(R) == k);
+        CHECK(norm(M-Q*R) < 1E-12);
+        auto Id = CMatrix(k,k);
+        for(auto i : range(k)) Id(i,i) = 1.;
+        CHECK(norm(conj(transpose(Q))*Q-Id) < 1E-12);
+        for(auto j : range(ncols(R)))
+        for(auto i : range(nrows(R)))
+            {
+            if(i > j) CHECK(std::abs(R(i,j)) == 0.);
+            }
+        }
+    }
+
 //SECTION("Complex SVD")
 //    {
 //    SECTION("One Pass Case")
@@ -166,6 +166,69 @@ SECTION("applyMPO (DensityMatrix)")
 
     CHECK_EQUAL(checkMPOProd(Hpsi,H,psi,1E-10),true);
 
+    //Recomputed or disk-stored environments
+    for(auto eargs : {Args("Checkpoint",3),Args("WriteEnv",true)})
+        {
+        eargs.add("Method",method);
+        eargs.add("Cutoff",1E-13);
+        eargs.add("Maxm",5000);
+        auto Hpsi2 = applyMPO(H,psi,eargs);
+        CHECK_EQUAL(checkMPOProd(Hpsi2,H,psi,1E-10),true);
+        CHECK_CLOSE(overlap(Hpsi2,Hpsi),overlap(Hpsi,Hpsi));
+        }
+
+    }
+
+SECTION("applyMPO (Parallel)")
+    {
+    auto N = 10;
+    auto sites = SpinHalf(N);
+
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    auto H = MPO(ampo);
+    auto K = MPO(ampo);
+    for(auto j : range1(N))
+        {
+        randomize(H.Aref(j));
+        randomize(K.Aref(j));
+        H.Aref(j) *= 0.2;
+        K.Aref(j) *= 0.2;
+        }
+
+    auto psi = MPS(sites);
+    psi = applyMPO(K,psi,{"Cutoff=",0.,"Maxm=",100});
+    psi /= norm(psi);
+
+    auto Hpsi = applyMPO(H,psi,{"Method=","Parallel","Cutoff=",1E-13,"Maxm=",5000,"NThread=",2});
+    CHECK_EQUAL(checkMPOProd(Hpsi,H,psi,1E-10),true);
+    CHECK(isOrtho(Hpsi));
+    CHECK(orthoCenter(Hpsi) == 1);
+
+    //Truncated result agrees with DensityMatrix method
+    auto targs = Args{"Cutoff=",1E-6,"Maxm=",4};
+    targs.add("Method=","Parallel");
+    auto Hpsi_p = applyMPO(H,psi,targs);
+    targs.add("Method=","DensityMatrix");
+    auto Hpsi_d = applyMPO(H,psi,targs);
+    CHECK(maxM(Hpsi_p) <= 4);
+    CHECK_CLOSE(overlap(Hpsi_p,Hpsi_p),overlap(Hpsi_d,Hpsi_d));
+
+    //With quantum numbers
+    auto iqH = IQMPO(ampo);
+    auto state = InitState(sites);
+    for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+    auto iqpsi = IQMPS(state);
+    iqpsi = applyMPO(iqH,iqpsi,{"Method=","Parallel"});
+    iqpsi = applyMPO(iqH,iqpsi,{"Method=","Parallel"});
+    auto iqH2psi = applyMPO(iqH,iqpsi,{"Method=","Parallel"});
+    CHECK_CLOSE(overlap(iqH2psi,iqH2psi),overlap(iqpsi,iqH,iqH,iqpsi));
+    CHECK(checkQNs(iqH2psi));
     }
 
 SECTION("applyMPO (Fit)")
@@ -294,6 +357,104 @@ SECTION("Overlap <psi|HK|phi>")
     CHECK_CLOSE(overlap(phi,H,K,psi),overlap(Hdphi,Kpsi));
     }
 
+SECTION("Overlap - both ends")
+    {
+    detail::seed_quickran(1);
+
+    auto N = 12;
+    auto sites = SpinHalf(N);
+
+    auto randomState = [&sites,N](int m)
+        {
+        auto psi = MPS(sites);
+        auto links = std::vector<Index>(N+1);
+        for(auto j : range(N+1)) links.at(j) = Index(format("l_%d",j),m);
+        for(auto j : range1(N)) psi.Aref(j) = randomTensor(links.at(j-1),sites(j),links.at(j));
+        psi.Aref(1) *= randomTensor(links.at(0));
+        psi.Aref(N) *= randomTensor(links.at(N));
+        return psi;
+        };
+    auto psi = randomState(4);
+    auto phi = randomState(3);
+
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    auto H = MPO(ampo);
+    auto K = H;
+    for(auto j : range1(N)) randomize(K.Aref(j));
+
+    auto hasNThread = Args::global().defined("NThread");
+    auto nthread = hasNThread ? Args::global().getInt("NThread") : 0;
+
+    Args::global().add("NThread",1);
+    auto o1 = overlapC(psi,phi);
+    auto h1 = overlapC(psi,H,phi);
+    auto k1 = overlapC(psi,H,K,phi);
+    Args::global().add("NThread",2);
+    auto o2 = overlapC(psi,phi);
+    auto h2 = overlapC(psi,H,phi);
+    auto k2 = overlapC(psi,H,K,phi);
+
+    //MPS written to disk: contracted serially
+    auto psiw = psi;
+    psiw.doWrite(true);
+    auto o3 = overlapC(psiw,phi);
+    auto h3 = overlapC(psiw,H,phi);
+    auto k3 = overlapC(psiw,H,K,phi);
+    psiw.doWrite(false);
+
+    if(hasNThread) Args::global().add("NThread",nthread);
+    else           Args::global().remove("NThread");
+
+    CHECK(std::abs(o1) > 1E-8);
+    CHECK(std::abs(o1-o2) < 1E-10*std::abs(o1));
+    CHECK(std::abs(h1-h2) < 1E-10*std::abs(h1));
+    CHECK(std::abs(k1-k2) < 1E-10*std::abs(k1));
+    CHECK(std::abs(o1-o3) < 1E-10*std::abs(o1));
+    CHECK(std::abs(h1-h3) < 1E-10*std::abs(h1));
+    CHECK(std::abs(k1-k3) < 1E-10*std::abs(k1));
+    }
+
+SECTION("Parallel applyMPO - doWrite")
+    {
+    detail::seed_quickran(1);
+
+    auto N = 10;
+    auto sites = SpinHalf(N);
+    auto psi = MPS(sites);
+    auto links = std::vector<Index>(N+1);
+    for(auto j : range(N+1)) links.at(j) = Index(format("l_%d",j),4);
+    for(auto j : range1(N)) psi.Aref(j) = randomTensor(links.at(j-1),sites(j),links.at(j));
+    psi.Aref(1) *= randomTensor(links.at(0));
+    psi.Aref(N) *= randomTensor(links.at(N));
+
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    auto K = MPO(ampo);
+    for(auto j : range1(N)) randomize(K.Aref(j));
+
+    //Site tensors of psiw are read from disk
+    //before the threaded products
+    auto psiw = psi;
+    psiw.doWrite(true);
+    auto Kpsi = applyMPO(K,psiw,{"Method=","Parallel","Cutoff=",0.,"NThread=",2});
+    CHECK(psiw.doWrite());
+    CHECK(!Kpsi.doWrite());
+    psiw.doWrite(false);
+
+    CHECK(checkMPOProd(Kpsi,K,psi,1E-10));
+    }
+
 SECTION("toMPO function")
     {
     auto N = 50;
@@ -407,6 +568,96 @@ SECTION("nmultMPO")
         auto oKH = overlap(psi,K,H,phi);
         CHECK_DIFF(oR,oKH,1E-5);
         }
+
+    MPO RF;
+    nmultMPO(H,K,RF,{"Method=","Fit","Cutoff=",1E-10,"Nsweep=",3});
+    for(int n = 1; n <= Ntest; ++n)
+        {
+        auto psi = randomMPS(nsites,4);
+        auto phi = randomMPS(sites,4);
+        CHECK_DIFF(overlap(psi,RF,phi),overlap(psi,K,H,phi),1E-5);
+        }
+
+    MPO RC;
+    nmultMPO(H,K,RC,{"Cutoff=",1E-10,"Compress=",true});
+    for(int n = 1; n <= Ntest; ++n)
+        {
+        auto psi = randomMPS(nsites,4);
+        auto phi = randomMPS(sites,4);
+        CHECK_DIFF(overlap(psi,RC,phi),overlap(psi,K,H,phi),1E-5);
+        }
+    }
+
+SECTION("fitMultMPO")
+    {
+    auto N = 8;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    auto H = IQMPO(ampo);
+    auto state = InitState(sites);
+    for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+    auto psi = IQMPS(state);
+    psi = applyMPO(H,psi);
+    psi /= norm(psi);
+
+    IQMPO H2;
+    fitMultMPO(H,H,H2,{"Cutoff=",1E-12});
+    CHECK_CLOSE(overlap(psi,H2,psi),overlap(psi,H,H,psi));
+    CHECK(checkQNs(H2));
+
+    //Starting from a poor guess, more sweeps needed
+    IQMPO H2t = H;
+    fitMultMPO(H,H,H2t,{"Maxm=",3,"Nsweep=",4});
+    CHECK(maxM(H2t) <= 3);
+    }
+
+SECTION("compress")
+    {
+    auto N = 6;
+    auto sites = SpinHalf(N);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+        {
+        ampo += "Sz",j,"Sz",j+1;
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        }
+    auto H = MPO(ampo);
+
+    //Pad each bond with redundant states: E is an
+    //isometry so inserting E*E^T leaves W = H
+    auto W = H;
+    for(auto b : range1(N-1))
+        {
+        auto l = linkInd(W,b);
+        auto ln = Index(nameint("ln",b),l.m()+3,Link);
+        ITensor Q(ln),R;
+        qr(randomTensor(ln,l),Q,R);
+        auto E = Q*delta(commonIndex(Q,R),l);
+        W.Aref(b) *= E;
+        W.Aref(b+1) *= E;
+        }
+    CHECK(maxM(W) == maxM(H)+3);
+
+    auto psi = MPS(sites);
+    for(auto j : range1(N)) randomize(psi.Aref(j));
+    auto E = overlap(psi,H,psi);
+    CHECK_CLOSE(overlap(psi,W,psi),E);
+
+    compress(W);
+    CHECK(maxM(W) == maxM(H));
+    CHECK(isOrtho(W));
+    CHECK(orthoCenter(W) == 1);
+    CHECK_CLOSE(overlap(psi,W,psi),E);
+
+    compress(W,{"Maxm=",3});
+    CHECK(maxM(W) <= 3);
     }
 
 }
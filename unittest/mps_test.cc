@@ -1,8 +1,11 @@
 #include "test.h"
 #include "itensor/mps/mps.h"
+#include "itensor/mps/correlations.h"
+#include "itensor/mps/dmrg.h"
 #include "itensor/mps/sites/spinhalf.h"
 #include "itensor/mps/sites/spinless.h"
 #include "itensor/util/print_macro.h"
+#include <unistd.h>
 
 using namespace itensor;
 using std::vector;
@@ -144,4 +147,310 @@ SECTION("Overlap - 1 site")
     CHECK_CLOSE(overlap(psi,psi),(psi.A(1)*psi.A(1)).real());
     }
 
+SECTION("Correlation Matrix")
+    {
+    auto M = 6;
+    auto sites = Spinless(M);
+
+    //Superposition of product states with 3 particles
+    auto makeState = [&sites](std::vector<int> const& occ)
+        {
+        auto st = InitState(sites,"Emp");
+        for(auto j : occ) st.set(j,"Occ");
+        return IQMPS(st);
+        };
+    auto psi = makeState({1,2,4});
+    psi = sum(psi,0.7*makeState({2,3,5}));
+    psi = sum(psi,-0.4*makeState({1,5,6}));
+    psi = sum(psi,0.3*makeState({3,4,6}));
+    psi = sum(psi,0.5*makeState({2,4,5}));
+
+    //Reference values from an MPO of the single term A_i B_j
+    auto expect = [&sites,&psi](std::string A, int i, std::string B, int j)
+        {
+        auto ampo = AutoMPO(sites);
+        if(i == j) ampo += A,i;
+        else       ampo += A,i,B,j;
+        auto H = toMPO<IQTensor>(ampo,{"Exact",false});
+        return overlap(psi,H,psi)/overlap(psi,psi);
+        };
+
+    auto Cn = correlationMatrix(psi,"N","N");
+    auto Ch = correlationMatrix(psi,"Cdag","C");
+    auto Ch3 = correlationMatrix(psi,"Cdag","C",{"NThread",3});
+    for(auto i : range1(M))
+    for(auto j : range1(M))
+        {
+        if(i != j)
+            {
+            CHECK_CLOSE(Cn(i-1,j-1),expect("N",i,"N",j));
+            CHECK_CLOSE(Ch(i-1,j-1),expect("Cdag",i,"C",j));
+            }
+        CHECK_CLOSE(Ch3(i-1,j-1),Ch(i-1,j-1));
+        }
+    for(auto i : range1(M))
+        {
+        CHECK_CLOSE(Cn(i-1,i-1),expect("N",i,"",i));
+        CHECK_CLOSE(Ch(i-1,i-1),expect("N",i,"",i));
+        }
+    CHECK(norm(Ch) > 0.1);
+
+    //Jordan-Wigner string written out explicitly
+    auto Cs = correlationMatrix(psi,"Adag*F","A",{"String","F"});
+    for(auto i : range1(M))
+    for(auto j : range1(i+1,M))
+        {
+        CHECK_CLOSE(Cs(i-1,j-1),Ch(i-1,j-1));
+        }
+
+    //Same results for an MPS without QNs
+    auto Cn0 = correlationMatrix(toMPS(psi),"N","N");
+    CHECK(norm(Cn0-Cn) < 1E-10);
+    }
+
+SECTION("DMRGObserver Measurements")
+    {
+    auto M = 8;
+    auto sites = SpinHalf(M);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(M-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    for(auto j : range1(M)) ampo += (j%2==1 ? 0.3 : -0.3),"Sz",j;
+    auto H = IQMPO(ampo);
+
+    auto sweeps = Sweeps(3);
+    sweeps.maxm() = 10,20,40;
+    sweeps.cutoff() = 1E-12;
+
+    auto init = InitState(sites);
+    for(auto j : range1(M)) init.set(j,j%2==1 ? "Up" : "Dn");
+
+    auto psi = IQMPS(init);
+    auto obs = DMRGObserver<IQTensor>(psi,{"Ops","Sz,S+"});
+    dmrg(psi,H,sweeps,obs,{"Quiet",true});
+
+    auto apsi = IQMPS(init);
+    auto aobs = DMRGObserver<IQTensor>(apsi,{"Ops","Sz S+","Async",true});
+    dmrg(apsi,H,sweeps,aobs,{"Quiet",true});
+    aobs.waitMeasurements();
+
+    //No truncation in the last sweep, so the measurements
+    //made at each bond agree with the final state
+    auto C = correlationMatrix(psi,"Sz","Id");
+    for(auto j : range1(M))
+        {
+        CHECK_CLOSE(obs.expect("Sz",j).real(),C(j-1,j-1));
+        CHECK_CLOSE(aobs.expect("Sz",j).real(),C(j-1,j-1));
+        CHECK(std::abs(aobs.expect("S+",j)) < 1E-14);
+        }
+    CHECK(std::fabs(C(0,0)) > 0.05);
+    for(auto b : range1(M-1))
+        {
+        CHECK_CLOSE(aobs.entropy(b),obs.entropy(b));
+        }
+    CHECK(obs.entropy(M/2) > 0.1);
+
+    //Queue holds every bond update, in order
+    auto m = DMRGMeasurement();
+    auto count = 0;
+    while(aobs.nextMeasurement(m))
+        {
+        if(count == 0)
+            {
+            CHECK(m.sweep == 1);
+            CHECK(m.halfsweep == 1);
+            CHECK(m.b == 1);
+            }
+        CHECK(m.local.size() == 4ul);
+        ++count;
+        }
+    CHECK(count == 3*2*(M-1));
+    CHECK(m.sweep == 3);
+    CHECK(m.halfsweep == 2);
+    CHECK(m.b == 1);
+    CHECK_CLOSE(m.local.front().value.real(),C(0,0));
+
+    //Without "Async" or "Ops" nothing is queued
+    //unless asked for
+    auto npsi = IQMPS(init);
+    auto nobs = DMRGObserver<IQTensor>(npsi);
+    dmrg(npsi,H,sweeps,nobs,{"Quiet",true});
+    CHECK(!nobs.nextMeasurement(m));
+    CHECK_CLOSE(nobs.entropy(M/2),obs.entropy(M/2));
+
+    auto qpsi = IQMPS(init);
+    auto qobs = DMRGObserver<IQTensor>(qpsi,{"QueueMeasurements",true});
+    dmrg(qpsi,H,sweeps,qobs,{"Quiet",true});
+    count = 0;
+    while(qobs.nextMeasurement(m)) ++count;
+    CHECK(count == 3*2*(M-1));
+    }
+
+SECTION("Single Precision Environments")
+    {
+    auto M = 10;
+    auto sites = SpinHalf(M);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(M-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = IQMPO(ampo);
+
+    auto sweeps = Sweeps(4);
+    sweeps.maxm() = 10,20,40;
+    sweeps.cutoff() = 1E-12;
+    sweeps.precision() = 32,32,64;
+    CHECK(sweeps.precision(2) == 32);
+    CHECK(sweeps.precision(4) == 64);
+
+    auto init = InitState(sites);
+    for(auto j : range1(M)) init.set(j,j%2==1 ? "Up" : "Dn");
+
+    auto psi = IQMPS(init);
+    auto E = dmrg(psi,H,sweeps,{"Quiet",true});
+    CHECK_CLOSE(overlap(psi,H,psi),E);
+
+    //Environments away from the current bond
+    //are single precision, L() and R() double
+    auto PH = LocalMPO<IQTensor>(H);
+    PH.precision(32);
+    PH.position(1,psi);
+    PH.position(M/2,psi);
+    CHECK(PH.leftLim() == M/2-1);
+    for(auto j : range1(PH.leftLim()-1))
+        {
+        CHECK(doTask(StorageType{},PH.env(j).store()) == StorageType::SingleQDenseReal);
+        }
+    CHECK(doTask(StorageType{},PH.L().store()) == StorageType::QDenseReal);
+    CHECK(doTask(StorageType{},PH.R().store()) == StorageType::QDenseReal);
+    PH.precision(64);
+    CHECK(doTask(StorageType{},PH.env(1).store()) == StorageType::QDenseReal);
+    PH.precision(32);
+    auto dPH = LocalMPO<IQTensor>(H);
+    dPH.position(M/2,psi);
+    auto phi = psi.A(M/2)*psi.A(M/2+1);
+    auto Hphi = phi,
+         dHphi = phi;
+    PH.product(phi,Hphi);
+    dPH.product(phi,dHphi);
+    CHECK(norm(Hphi-dHphi) < 1E-5*norm(dHphi));
+    }
+
+SECTION("Sparse Links MPO")
+    {
+    auto M = 10;
+    auto sites = SpinHalf(M);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(M-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = MPO(ampo);
+    auto sH = sparseLinks(H);
+
+    auto sweeps = Sweeps(4);
+    sweeps.maxm() = 10,20,40;
+    sweeps.cutoff() = 1E-12;
+
+    auto init = InitState(sites);
+    for(auto j : range1(M)) init.set(j,j%2==1 ? "Up" : "Dn");
+
+    auto psi = MPS(init);
+    auto E = dmrg(psi,sH,sweeps,{"Quiet",true});
+    CHECK_CLOSE(overlap(psi,H,psi),E);
+    CHECK_CLOSE(overlap(psi,sH,psi),E);
+
+    //IQMPO tensors keep only the non-zero
+    //entries of each quantum number block
+    auto iqH = IQMPO(ampo);
+    auto siqH = sparseLinks(iqH);
+    for(auto j : range1(M))
+        {
+        CHECK(doTask(StorageType{},siqH.A(j).store()) == StorageType::QMPOSparseReal);
+        }
+    auto iqpsi = IQMPS(init);
+    auto iqE = dmrg(iqpsi,siqH,sweeps,{"Quiet",true});
+    CHECK_CLOSE(overlap(iqpsi,iqH,iqpsi),iqE);
+    CHECK_CLOSE(overlap(iqpsi,siqH,iqpsi),iqE);
+
+    auto PH = LocalMPO<IQTensor>(siqH);
+    PH.position(M/2,iqpsi);
+    auto dPH = LocalMPO<IQTensor>(iqH);
+    dPH.position(M/2,iqpsi);
+    auto phi = iqpsi.A(M/2)*iqpsi.A(M/2+1);
+    auto Hphi = phi,
+         dHphi = phi;
+    PH.product(phi,Hphi);
+    dPH.product(phi,dHphi);
+    CHECK(norm(Hphi-dHphi) < 1E-12*norm(dHphi));
+    }
+
+SECTION("DMRG Memory Tracking")
+    {
+    auto M = 8;
+    auto sites = SpinHalf(M);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(M-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = IQMPO(ampo);
+    auto sweeps = Sweeps(2);
+    sweeps.maxm() = 10,20;
+    sweeps.cutoff() = 1E-12;
+    auto init = InitState(sites);
+    for(auto j : range1(M)) init.set(j,j%2==1 ? "Up" : "Dn");
+    auto psi = IQMPS(init);
+
+    auto start = memStats();
+    dmrg(psi,H,sweeps,{"Quiet",true,"MemStats",true});
+    CHECK(!memTracking());
+    auto S = memStats();
+    for(auto c : {MemCategory::Environment,MemCategory::Wavefunction,MemCategory::Temporary})
+        {
+        CHECK(S.category(c).peak > start.category(c).peak);
+        }
+    }
+
+SECTION("DMRG Mapped Storage")
+    {
+    auto M = 8;
+    auto sites = SpinHalf(M);
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(M-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = IQMPO(ampo);
+    auto sweeps = Sweeps(3);
+    sweeps.maxm() = 10,20;
+    sweeps.cutoff() = 1E-12;
+    auto init = InitState(sites);
+    for(auto j : range1(M)) init.set(j,j%2==1 ? "Up" : "Dn");
+    auto dir = mkTempDir("mapped");
+        {
+        auto mpsi = IQMPS(init);
+        auto mE = dmrg(mpsi,H,sweeps,{"Quiet",true,"MapStorage",dir,"MapMinBytes",64});
+        CHECK(!storageMapped());
+        CHECK(numStorageMaps() > 0); //tensors of mpsi are mapped
+        CHECK_CLOSE(overlap(mpsi,H,mpsi),mE);
+        }
+    //Freeing mpsi removes its mappings and their files
+    CHECK(numStorageMaps() == 0);
+    CHECK(rmdir(dir.c_str()) == 0);
+    }
+
 }
@@ -0,0 +1,260 @@
+#define CATCH_CONFIG_RUNNER
+#include "test.h"
+#include "itensor/all.h"
+#include "itensor/mps/parallel_dmrg.h"
+
+using namespace itensor;
+
+//
+// Tests of the MPI code in parallel.h and
+// parallel_dmrg.h. They need MPI, so they are
+// not part of test-g: "make parallel" builds
+// them with mpicxx and runs them on 1 and 2 nodes.
+//
+
+namespace {
+Environment* penv = nullptr;
+}
+
+int
+main(int argc, char* argv[])
+    {
+    Environment env(argc,argv);
+    penv = &env;
+    return Catch::Session().run(argc,argv);
+    }
+
+TEST_CASE("ParallelDMRGTest")
+{
+auto& env = *penv;
+
+auto N = 10;
+
+//Built on the first node and broadcast,
+//as parallelDMRG requires
+auto sites = SpinHalf();
+auto H = IQMPO();
+auto psi0 = IQMPS();
+if(env.firstNode())
+    {
+    sites = SpinHalf(N);
+
+    auto ampo = AutoMPO(sites);
+    for(int j = 1; j < N; ++j)
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    H = IQMPO(ampo);
+
+    auto state = InitState(sites);
+    for(int i = 1; i <= N; ++i) state.set(i,i%2==1 ? "Up" : "Dn");
+    psi0 = IQMPS(state);
+    }
+env.broadcast(sites,H,psi0);
+
+auto sweeps = Sweeps(10);
+sweeps.maxm() = 10,20,40;
+sweeps.cutoff() = 1E-12;
+sweeps.niter() = 4;
+
+SECTION("Energy Matches dmrg")
+    {
+    //Bond dimension 32 is exact for 10 sites,
+    //so both runs reach the exact ground state
+    auto psi = psi0;
+    auto E = parallelDMRG(env,psi,H,sweeps,{"Quiet",true});
+
+    auto spsi = psi0;
+    auto Edmrg = dmrg(spsi,H,sweeps,{"Quiet",true});
+
+    CHECK(std::fabs(E-Edmrg) < 1E-8);
+
+    if(env.firstNode())
+        {
+        //First node holds the full normalized MPS
+        CHECK(psi.N() == N);
+        CHECK_DIFF(overlap(psi,psi),1.,1E-16);
+        CHECK(std::fabs(overlap(psi,H,psi)-E) < 1E-8);
+        CHECK(std::fabs(std::fabs(overlap(psi,spsi))-1.) < 1E-6);
+        }
+    }
+
+SECTION("Energy Same on Every Node")
+    {
+    auto psi = psi0;
+    auto E = parallelDMRG(env,psi,H,sweeps,{"Quiet",true});
+    auto E0 = E;
+    env.broadcast(E0);
+    CHECK(E == E0);
+    }
+
+}
+
+namespace {
+
+template<typename I>
+void
+checkSame(ITensorT<I> const& R, ITensorT<I> const& T)
+    {
+    REQUIRE(R);
+    CHECK(doTask(StorageType{},R.store()) == doTask(StorageType{},T.store()));
+    CHECK(norm(R-T) < 1E-12*norm(T));
+    }
+
+//Writes the header of T, reads it back and
+//copies the raw data, without any messages
+template<typename I>
+ITensorT<I>
+headerRoundTrip(ITensorT<I> const& T)
+    {
+    std::stringstream s;
+    auto M = detail::writeHeader(s,T);
+    auto R = ITensorT<I>{};
+    auto MR = detail::readHeader(s,R);
+    REQUIRE(MR.size == M.size);
+    std::copy(M.data,M.data+M.size,MR.data);
+    return R;
+    }
+
+template<typename I>
+ITensorT<I>
+sendToSelf(Environment const& env, 
+           ITensorT<I> const& T,
+           Args const& args = Args::global())
+    {
+    MailBox mailbox(env,env.rank(),args);
+    auto req = mailbox.isend(T);
+    auto R = ITensorT<I>{};
+    mailbox.receive(R);
+    req.wait();
+    return R;
+    }
+
+}
+
+TEST_CASE("MailBoxTest")
+{
+auto& env = *penv;
+
+//Tensors with every storage type sent as raw
+//data (Dense and QDense, real and complex),
+//plus Diag storage, which is serialized.
+//They are made on the first node and copied to
+//the others by serializing them, so that the
+//raw data paths can be checked against them.
+auto ts = std::vector<ITensor>(4);
+auto qts = std::vector<IQTensor>(2);
+std::stringstream s;
+if(env.firstNode())
+    {
+    auto i = Index("i",3),
+         j = Index("j",4);
+    ts[0] = randomTensor(i,j,prime(i));
+    ts[1] = randomTensorC(i,j);
+    ts[2] = diagTensor(std::vector<Real>{1.,2.,3.},i,prime(i));
+    ts[3] = ITensor(3.);
+
+    auto I = IQIndex("I",Index("I+",2),QN(+1),Index("I0",3),QN(0),Index("I-",2),QN(-1));
+    auto J = IQIndex("J",Index("J+",1),QN(+1),Index("J-",4),QN(-1));
+    qts[0] = randomTensor(QN(),I,dag(J),prime(I));
+    qts[1] = randomTensorC(QN(),I,dag(prime(I)));
+
+    for(auto& T : ts) write(s,T);
+    for(auto& T : qts) write(s,T);
+    }
+env.broadcast(s);
+for(auto& T : ts) read(s,T);
+for(auto& T : qts) read(s,T);
+
+SECTION("Header Round Trip")
+    {
+    for(auto& T : ts) checkSame(headerRoundTrip(T),T);
+    for(auto& T : qts) checkSame(headerRoundTrip(T),T);
+    }
+
+SECTION("isend To Self")
+    {
+    for(auto& T : ts) checkSame(sendToSelf(env,T),T);
+    for(auto& T : qts) checkSame(sendToSelf(env,T),T);
+    }
+
+SECTION("isend To Self - Small Buffer")
+    {
+    //Headers are split into many messages
+    for(auto& T : ts) checkSame(sendToSelf(env,T,{"Bufsize",8}),T);
+    for(auto& T : qts) checkSame(sendToSelf(env,T,{"Bufsize",8}),T);
+    }
+
+SECTION("Modify After isend")
+    {
+    //The request keeps the sent data alive
+    //and unchanged while it is in flight
+    auto T = ts[0];
+    auto Q = qts[0];
+    MailBox mailbox(env,env.rank());
+    auto reqT = mailbox.isend(T);
+    auto reqQ = mailbox.isend(Q);
+    T.set(1,1,1,100.);
+    T = ITensor();
+    Q *= 2.;
+    randomize(Q);
+    auto RT = ITensor{};
+    auto RQ = IQTensor{};
+    mailbox.receive(RT);
+    mailbox.receive(RQ);
+    reqT.wait();
+    reqQ.wait();
+    CHECK(!reqT);
+    checkSame(RT,ts[0]);
+    checkSame(RQ,qts[0]);
+    }
+
+SECTION("Broadcast")
+    {
+    for(auto& T0 : ts) 
+        {
+        auto T = env.firstNode() ? T0 : ITensor();
+        broadcast(env,T);
+        checkSame(T,T0);
+        }
+    for(auto& T0 : qts) 
+        {
+        auto T = env.firstNode() ? T0 : IQTensor();
+        broadcast(env,T);
+        checkSame(T,T0);
+        }
+    }
+
+SECTION("Send Between Nodes")
+    {
+    if(env.nnodes() > 1 && env.rank() < 2)
+        {
+        MailBox mailbox(env,1-env.rank());
+        if(env.firstNode())
+            {
+            auto reqs = std::vector<SendRequest>();
+            for(auto& T : ts) reqs.push_back(mailbox.isend(T));
+            for(auto& T : qts) reqs.push_back(mailbox.isend(T));
+            for(auto& r : reqs) r.wait();
+            }
+        else
+            {
+            for(auto& T : ts) 
+                {
+                auto R = ITensor{};
+                mailbox.receive(R);
+                checkSame(R,T);
+                }
+            for(auto& T : qts) 
+                {
+                auto R = IQTensor{};
+                mailbox.receive(R);
+                checkSame(R,T);
+                }
+            }
+        }
+    }
+
+}
@@ -42,6 +42,43 @@ SECTION("SpinHalf")
     sites.op("ISy",2); 
     }
 
+SECTION("Op Cache")
+    {
+    auto sites = SpinHalf(N);
+    auto A = sites.op("Sz*Sz",2);
+    auto B = sites.op("Sz*Sz",2);
+    CHECK(A.store() == B.store());
+    CHECK(norm(A-multSiteOps(sites.op("Sz",2),sites.op("Sz",2))) < 1E-12);
+
+    //Copies of a SiteSet share the cache
+    auto sites2 = sites;
+    CHECK(sites2.op(OpName("Sz*Sz"),2).store() == A.store());
+
+    //Modifying a returned operator leaves the cached one unchanged
+    A.set(sites(2,"Up"),prime(sites(2,"Up")),5.);
+    CHECK(norm(sites.op("Sz*Sz",2)-B) < 1E-12);
+    CHECK(norm(A-B) > 1.);
+
+    CHECK(sites.op("Sz",3).store() != sites.op("Sz",2).store());
+    //Non-default args bypass the cache
+    CHECK(sites.op("Sz",2,{"Dummy",true}).store() != sites.op("Sz",2).store());
+
+    //Ops made with the global Args are remade
+    //when the global Args change
+    auto hasState = Args::global().defined("State");
+    auto state = hasState ? Args::global().getInt("State") : 0;
+    Args::global().add("State",1);
+    auto P1 = sites.op("Proj",2);
+    CHECK(sites.op("Proj",2).store() == P1.store());
+    Args::global().add("State",2);
+    auto P2 = sites.op("Proj",2);
+    CHECK_CLOSE(P1.real(sites(2)(1),prime(sites(2)(1))),1.);
+    CHECK_CLOSE(P2.real(sites(2)(1),prime(sites(2)(1))),0.);
+    CHECK_CLOSE(P2.real(sites(2)(2),prime(sites(2)(2))),1.);
+    if(hasState) Args::global().add("State",state);
+    else         Args::global().remove("State");
+    }
+
 SECTION("SpinOne")
     {
     auto sites = SpinOne(N);
@@ -0,0 +1,318 @@
+#include "test.h"
+#include "itensor/su2.h"
+#include "itensor/util/threading.h"
+#include "itensor/su2tensor.h"
+#include "itensor/mps/sites/su2spinhalf.h"
+#include <cmath>
+
+using namespace itensor;
+using namespace std;
+
+//Full Index with a state per member of each multiplet
+Index
+fullIndex(IQIndex const& I)
+    {
+    return Index("f"+I.rawname(),su2FullDim(I));
+    }
+
+//S1.S2 on two full spin 1/2 Indices (Up = 1, Dn = 2)
+ITensor
+fullSdotS(Index const& i, Index const& j)
+    {
+    auto ops = [](Index const& s)
+        {
+        auto Sz = ITensor(s,prime(s)),
+             Sp = ITensor(s,prime(s)),
+             Sm = ITensor(s,prime(s));
+        Sz.set(s(1),prime(s)(1),+0.5);
+        Sz.set(s(2),prime(s)(2),-0.5);
+        Sp.set(s(2),prime(s)(1),1.);
+        Sm.set(s(1),prime(s)(2),1.);
+        return std::vector<ITensor>{Sz,Sp,Sm};
+        };
+    auto a = ops(i),
+         b = ops(j);
+    return a[0]*b[0]+0.5*a[1]*b[2]+0.5*a[2]*b[1];
+    }
+
+TEST_CASE("SU2Test")
+{
+
+SECTION("Triangle")
+    {
+    CHECK(su2Triangle(1,1,0));
+    CHECK(su2Triangle(1,1,2));
+    CHECK(!su2Triangle(1,1,1));
+    CHECK(!su2Triangle(1,1,4));
+    CHECK(su2Triangle(2,3,1));
+    }
+
+SECTION("Clebsch-Gordan")
+    {
+    //Two spin 1/2
+    CHECK_CLOSE(clebschGordan(1,1,1,1,2,2),1.);
+    CHECK_CLOSE(clebschGordan(1,1,1,-1,2,0),1./sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,-1,1,1,2,0),1./sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,1,1,-1,0,0),1./sqrt(2.));
+    CHECK_CLOSE(clebschGordan(1,-1,1,1,0,0),-1./sqrt(2.));
+    //Two spin 1 to singlet
+    CHECK_CLOSE(clebschGordan(2,2,2,-2,0,0),1./sqrt(3.));
+    CHECK_CLOSE(clebschGordan(2,0,2,0,0,0),-1./sqrt(3.));
+    //Forbidden
+    CHECK(clebschGordan(1,1,1,1,2,0) == 0);
+    CHECK(clebschGordan(1,1,1,1,4,2) == 0);
+
+    //Orthonormality
+    int j1 = 3, j2 = 4;
+    for(int j = std::abs(j1-j2); j <= j1+j2; j += 2)
+    for(int jp = std::abs(j1-j2); jp <= j1+j2; jp += 2)
+    for(int m = -j; m <= j; m += 2)
+        {
+        Real sum = 0;
+        for(int m1 = -j1; m1 <= j1; m1 += 2)
+            {
+            sum += clebschGordan(j1,m1,j2,m-m1,j,m)*clebschGordan(j1,m1,j2,m-m1,jp,m);
+            }
+        CHECK(std::fabs(sum-(j==jp ? 1. : 0.)) < 1E-12);
+        }
+    }
+
+SECTION("3j")
+    {
+    CHECK_CLOSE(wigner3j(1,1,0,1,-1,0),1./sqrt(2.));
+    CHECK_CLOSE(wigner3j(2,2,2,2,-2,0),1./sqrt(6.));
+    CHECK(wigner3j(2,2,2,2,2,0) == 0);
+    }
+
+SECTION("6j")
+    {
+    //{a b c; b a 0} = (-1)^(a+b+c)/sqrt((2a+1)(2b+1))
+    CHECK_CLOSE(wigner6j(1,1,2,1,1,0),0.5);
+    CHECK_CLOSE(wigner6j(1,1,0,1,1,0),-0.5);
+    CHECK_CLOSE(wigner6j(2,3,1,3,2,0),-1./sqrt(12.));
+    CHECK(wigner6j(1,1,1,1,1,0) == 0);
+
+    //Orthogonality
+    int a = 2, b = 3, c = 3, d = 2;
+    for(int jp = 0; jp <= 4; jp += 2)
+    for(int jpp = 0; jpp <= 4; jpp += 2)
+        {
+        Real sum = 0;
+        for(int j = 1; j <= 5; j += 2)
+            {
+            sum += (j+1)*(jp+1)*wigner6j(a,b,j,c,d,jp)*wigner6j(a,b,j,c,d,jpp);
+            }
+        CHECK(std::fabs(sum-(jp==jpp ? 1. : 0.)) < 1E-12);
+        }
+    }
+
+SECTION("9j")
+    {
+    //{a b e; c d e; f f 0} = (-1)^(b+c+e+f) {a b e; d c f}/sqrt((2e+1)(2f+1))
+    int a = 1, b = 1, c = 1, d = 1, e = 2, f = 2;
+    CHECK_CLOSE(wigner9j(a,b,e,c,d,e,f,f,0),
+                -wigner6j(a,b,e,d,c,f)/3.);
+    a = 2; b = 1; c = 3; d = 2; e = 3; f = 1;
+    auto ph = ((b+c+e+f)/2)%2 == 0 ? 1. : -1.;
+    CHECK_CLOSE(wigner9j(a,b,e,c,d,e,f,f,0),
+                ph*wigner6j(a,b,e,d,c,f)/sqrt((e+1.)*(f+1.)));
+    }
+
+SECTION("Wigner-Eckart")
+    {
+    //Sz of spin 1/2 is component q=0 of the
+    //rank 1 tensor operator S
+    auto red = 0.5*sqrt(2.)/clebschGordan(1,1,2,0,1,1);
+    CHECK_CLOSE(wignerEckart(red,1,1,2,0,1,1),0.5);
+    CHECK_CLOSE(wignerEckart(red,1,-1,2,0,1,-1),-0.5);
+    //Identity (k=0) has reduced element sqrt(2j+1)
+    CHECK_CLOSE(wignerEckart(sqrt(3.),2,0,0,0,2,0),1.);
+    }
+
+SECTION("Threads")
+    {
+    //Each thread fills its own caches; values
+    //must match the ones computed serially
+    auto jmax = 12;
+    auto res = std::vector<Real>(jmax+1,0.);
+    parallelFor(jmax+1,4,[&res](size_t j)
+        {
+        for(int x = 0; x <= 2*int(j); x += 2)
+            {
+            res[j] += clebschGordan(j,j,j,-j,x,0)*wigner6j(j,j,x,j,j,x);
+            }
+        });
+    for(int j = 0; j <= jmax; ++j)
+        {
+        Real ref = 0;
+        for(int x = 0; x <= 2*j; x += 2)
+            {
+            ref += clebschGordan(j,j,j,-j,x,0)*wigner6j(j,j,x,j,j,x);
+            }
+        CHECK(res[j] == ref);
+        }
+    }
+
+
+SECTION("SU2Tensor Contraction")
+    {
+    auto l = su2Index("l",{{0,2},{2,1}});
+    auto s1 = su2Index("s1",{{1,1}},Site);
+    auto c = su2Index("c",{{1,2},{3,1}});
+    auto s2 = su2Index("s2",{{1,1}},Site);
+    auto r = su2Index("r",{{0,1},{2,2}});
+    auto fl = fullIndex(l),
+         f1 = fullIndex(s1),
+         fc = fullIndex(c),
+         f2 = fullIndex(s2),
+         fr = fullIndex(r);
+    CHECK(fc.m() == 2*2+1*4);
+
+    auto A = randomSU2Tensor({l,s1,c});
+    auto B = randomSU2Tensor({c,s2,r});
+    auto fA = toITensor(A,{fl,f1,fc});
+    auto fB = toITensor(B,{fc,f2,fr});
+    CHECK_CLOSE(norm(A),norm(fA));
+
+    auto C = A*B;
+    CHECK(C.r() == 4);
+    auto fC = toITensor(C,{fl,f1,f2,fr});
+    CHECK(norm(fC-fA*fB) < 1E-12*norm(fC));
+    CHECK_CLOSE(norm(C),norm(fC));
+    CHECK(C.reducedSize() < fl.m()*f1.m()*f2.m()*fr.m());
+
+    //Invariant matrix on the last index
+    auto rp = su2Index("rp",{{0,2},{2,1}});
+    auto M = randomSU2Tensor({r,rp});
+    auto frp = fullIndex(rp);
+    auto fCM = toITensor(C*M,{fl,f1,f2,frp});
+    CHECK(norm(fCM-fC*toITensor(M,{fr,frp})) < 1E-12*norm(fCM));
+    }
+
+SECTION("SU2Tensor SVD")
+    {
+    auto l = su2Index("l",{{0,2},{2,2},{4,1}});
+    auto s1 = su2Index("s1",{{1,1}},Site);
+    auto s2 = su2Index("s2",{{1,1}},Site);
+    auto r = su2Index("r",{{0,1},{2,3},{4,1}});
+    auto fl = fullIndex(l),
+         f1 = fullIndex(s1),
+         f2 = fullIndex(s2),
+         fr = fullIndex(r);
+    auto T = randomSU2Tensor({l,s1,s2,r});
+    auto fT = toITensor(T,{fl,f1,f2,fr});
+
+    SU2Tensor A,B;
+    auto spec = svd(T,A,B,{"Cutoff",1E-16});
+    CHECK(spec.truncerr() < 1E-14);
+    auto fa = fullIndex(A.index(3));
+    auto fAB = toITensor(A*B,{fl,f1,f2,fr});
+    CHECK(norm(fAB-fT) < 1E-12*norm(fT));
+
+    //A is left orthogonal
+    auto fA = toITensor(A,{fl,f1,fa});
+    auto rho = fA*prime(fA,fa);
+    auto id = ITensor(fa,prime(fa));
+    for(auto n : range1(fa.m())) id.set(fa(n),prime(fa)(n),1.);
+    CHECK(norm(rho-id) < 1E-12);
+
+    //Truncation error is the discarded weight
+    //of the full tensor
+    spec = svd(T,A,B,{"Maxm",3});
+    auto m = 0l;
+    for(auto b : range1(A.index(3).nblock())) m += A.index(3).index(b).m();
+    CHECK(m == 3);
+    fAB = toITensor(A*B,{fl,f1,f2,fr});
+    CHECK(spec.truncerr() > 1E-4);
+    CHECK_CLOSE(spec.truncerr(),sqr(norm(fAB-fT)/norm(fT)));
+    }
+
+SECTION("SU2Tensor S.S")
+    {
+    auto l = su2Index("l",{{0,1},{2,2}});
+    auto s1 = su2Index("s1",{{1,1}},Site);
+    auto s2 = su2Index("s2",{{1,1}},Site);
+    auto r = su2Index("r",{{0,2},{2,1},{4,1}});
+    auto fl = fullIndex(l),
+         f1 = fullIndex(s1),
+         f2 = fullIndex(s2),
+         fr = fullIndex(r);
+    auto T = randomSU2Tensor({l,s1,s2,r});
+    auto fT = toITensor(T,{fl,f1,f2,fr});
+    auto fR = toITensor(applySdotS(T),{fl,f1,f2,fr});
+    auto fSS = fullSdotS(f1,f2);
+    CHECK(norm(fR-noprime(fSS*fT)) < 1E-12*norm(fT));
+
+    //Singlet and triplet of two spins
+    auto l0 = su2Index("l0",{{0,1}});
+    for(auto j : {0,2})
+        {
+        auto rj = su2Index("rj",{{j,1}});
+        auto D = randomSU2Tensor({l0,s1,s2,rj});
+        auto R = applySdotS(D);
+        D *= (j == 0 ? -0.75 : 0.25);
+        for(auto& b : D.blocks())
+            {
+            CHECK(norm(R.block(b.first)-b.second) < 1E-12);
+            }
+        }
+    }
+
+SECTION("SU2SpinHalf")
+    {
+    auto sites = SU2SpinHalf(4);
+    auto s = sites(2);
+    CHECK(su2FullDim(s) == 2);
+    CHECK(sites.op("Id",2).real(s(1),prime(s)(1)) == 1.);
+    //Sz elements from the reduced element of S
+    auto red = std::sqrt(2.)*sites.op("S",2).real(s(1),prime(s)(1));
+    CHECK_CLOSE(wignerEckart(red,1,1,2,0,1,1),0.5);
+    CHECK_CLOSE(wignerEckart(red,1,-1,2,0,1,-1),-0.5);
+    red = std::sqrt(2.)*sites.op("S2",2).real(s(1),prime(s)(1));
+    CHECK_CLOSE(wignerEckart(red,1,1,0,0,1,1),0.75);
+    }
+
+SECTION("SU2 Imaginary Time")
+    {
+    //Heisenberg chain of 4 spins, from a product
+    //of singlets, with second order Trotter steps
+    auto N = 4;
+    auto sites = SU2SpinHalf(N);
+    auto links = std::vector<IQIndex>(N+1);
+    for(auto b : range(N+1)) links[b] = su2Index(nameint("l",b),{{b%2,1}});
+    auto A = std::vector<SU2Tensor>(N+1);
+    for(auto j : range1(N)) A[j] = randomSU2Tensor({links[j-1],sites(j),links[j]});
+
+    auto tau = 0.05;
+    auto expH = [tau](Real x) { return std::exp(-tau/2*x); };
+    auto step = [&](int b)
+        {
+        auto T = applySdotS(A[b]*A[b+1],expH);
+        T *= 1./norm(T);
+        svd(T,A[b],A[b+1],{"Cutoff",1E-14,"IndexName",nameint("l",b)});
+        };
+    for(auto n : range(300))
+        {
+        for(auto b : range1(N-1)) step(b);
+        for(auto b = N-1; b >= 1; --b) step(b);
+        }
+
+    auto psi = A[1];
+    for(auto j : range1(2,N)) psi = psi*A[j];
+    auto f = std::vector<Index>(N+2);
+    f[0] = fullIndex(links[0]);
+    for(auto j : range1(N)) f[j] = fullIndex(sites(j));
+    f[N+1] = fullIndex(links[N]);
+    auto fpsi = toITensor(psi,f);
+    Real E = 0;
+    for(auto b : range1(N-1))
+        {
+        auto Hpsi = noprime(fullSdotS(f[b],f[b+1])*fpsi);
+        E += (fpsi*Hpsi).real()/sqr(norm(fpsi));
+        }
+    CHECK(std::fabs(E-(-0.75-std::sqrt(3.)/2)) < 1E-3);
+    //Bond dimension counts multiplets
+    CHECK(A[2].index(3).nblock() == 2);
+    }
+
+}
@@ -3,6 +3,8 @@
 #include "itensor/global.h"
 #include "itensor/util/infarray.h"
 #include "itensor/util/stats.h"
+#include "itensor/util/profiling.h"
+#include <sstream>
 
 using namespace itensor;
 using namespace std;
@@ -261,3 +263,51 @@ SECTION("BinErr")
     }
 }
 
+
+TEST_CASE("Profiling")
+{
+auto work = [](int n)
+    {
+    PROFILE_SCOPE(test_scope)
+    PROFILE_COUNT(test_counter,2.5*n);
+    };
+
+SECTION("Off by default")
+    {
+    auto start = profileData();
+    work(1);
+    auto P = profileData()-start;
+    CHECK(P.count("test_scope") == 0);
+    CHECK(P.total("test_counter") == 0);
+    }
+
+SECTION("Timers and counters")
+    {
+    auto was_on = profiling(true);
+    auto start = profileData();
+    for(int n = 1; n <= 4; ++n) work(n);
+        {
+        PROFILE_START(test_startstop)
+        PROFILE_STOP(test_startstop)
+        PROFILE_STOP(test_startstop)
+        }
+    auto P = profileData()-start;
+    profiling(was_on);
+
+    CHECK(P.count("test_scope") == 4);
+    CHECK(P.time("test_scope") >= 0);
+    CHECK(P.count("test_counter") == 4);
+    CHECK_CLOSE(P.total("test_counter"),25.);
+    //Stopping twice only records once
+    CHECK(P.count("test_startstop") == 1);
+    CHECK(P.count("no_such_section") == 0);
+
+    auto s = std::ostringstream();
+    writeJSON(s,P);
+    auto json = s.str();
+    CHECK(json.front() == '{');
+    CHECK(json.back() == '}');
+    CHECK(json.find("\"test_scope\": {\"time\": ") != std::string::npos);
+    CHECK(json.find("\"count\": 4") != std::string::npos);
+    }
+}